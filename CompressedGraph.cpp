@@ -0,0 +1,107 @@
+#include "CompressedGraph.h"
+
+namespace {
+
+static void write_varint(std::vector<std::uint8_t> &out, std::uint64_t x)
+{
+    while (x >= 0x80) {
+        out.push_back((std::uint8_t) (x | 0x80));
+        x >>= 7;
+    }
+    out.push_back((std::uint8_t) x);
+}
+
+static std::uint64_t zigzag(long long x)
+{
+    return ((std::uint64_t) x << 1) ^ (std::uint64_t) (x >> 63);
+}
+} // namespace
+
+template<typename Graph>
+CompressedGraph::CompressedGraph(const Graph &g)
+{
+    adj.offsets_.reserve((std::size_t) g.n + 1);
+    std::vector<Edge> row;
+    for (int u = 0; u < g.n; ++u) {
+        row.clear();
+        for (auto &e : g.adj[u])
+            row.push_back({(int) e.to, (Weight) e.w});
+        append_row(row);
+    }
+}
+
+void CompressedGraph::append_row(std::vector<Edge> row)
+{
+    int u = n;
+    std::sort(row.begin(), row.end(), [](const Edge &a, const Edge &b) { return a.to < b.to; });
+
+    std::vector<std::uint8_t> gaps;
+    int prev = u;
+    for (std::size_t i = 0; i < row.size(); ++i) {
+        if (row[i].to < 0)
+            throw std::out_of_range("vertex");
+        if (row[i].w < 0)
+            throw std::invalid_argument("weight must be nonnegative");
+        if (i == 0)
+            write_varint(gaps, zigzag((long long) row[i].to - u));
+        else
+            write_varint(gaps, (std::uint64_t) (row[i].to - prev));
+        prev = row[i].to;
+    }
+
+    auto &bytes = adj.bytes_;
+    write_varint(bytes, row.size());
+    write_varint(bytes, gaps.size());
+    bytes.insert(bytes.end(), gaps.begin(), gaps.end());
+    for (std::size_t i = 0; i < row.size();) {
+        std::size_t j = i + 1;
+        while (j < row.size() && row[j].w == row[i].w)
+            ++j;
+        write_varint(bytes, j - i);
+        write_varint(bytes, (std::uint64_t) row[i].w);
+        i = j;
+    }
+    adj.offsets_.push_back(bytes.size());
+    ++n;
+}
+
+std::vector<Weight> CompressedGraph::degrees() const
+{
+    std::vector<Weight> deg(n, 0);
+    for (int u = 0; u < n; ++u)
+        for (auto &e : adj[u])
+            deg[u] += e.w;
+    return deg;
+}
+
+WeightedGraph CompressedGraph::decompress() const
+{
+    WeightedGraph g(n);
+    for (int u = 0; u < n; ++u) {
+        g.adj[u].reserve(adj[u].size());
+        for (auto &e : adj[u])
+            g.adj[u].push_back({e.to, e.w});
+    }
+    return g;
+}
+
+std::size_t CompressedGraph::memory_bytes() const
+{
+    return adj.bytes_.capacity() + adj.offsets_.capacity() * sizeof(std::uint64_t);
+}
+
+template<typename Graph>
+std::size_t adjacency_memory_bytes(const Graph &g)
+{
+    std::size_t bytes = g.adj.capacity() * sizeof(g.adj[0]);
+    for (auto &row : g.adj)
+        bytes += row.capacity() * sizeof(typename Graph::Edge);
+    return bytes;
+}
+
+template CompressedGraph::CompressedGraph(const WeightedGraph &);
+template CompressedGraph::CompressedGraph(const CompactWeightedGraph &);
+template CompressedGraph::CompressedGraph(const UnweightedGraph &);
+template std::size_t adjacency_memory_bytes(const WeightedGraph &);
+template std::size_t adjacency_memory_bytes(const CompactWeightedGraph &);
+template std::size_t adjacency_memory_bytes(const UnweightedGraph &);
@@ -0,0 +1,177 @@
+#pragma once
+#include "GraphUtils.h"
+#include <cstdint>
+
+// Read-only undirected graph with compressed adjacency rows. Row u is stored as
+//   varint degree, varint gap-section length,
+//   neighbor gaps: zigzag(first - u), then (next - previous) for the sorted neighbors,
+//   weights: (varint run length, varint weight) pairs in neighbor order,
+// all in one byte stream indexed by per-row offsets. Rows are decoded on the fly by
+// adj[u]'s iterator, so templated algorithms that only read g.n, g.adj[u] (range-for over
+// e.to / e.w), g.degrees() and Graph::coarse_graph run on it directly; coarsening produces
+// plain WeightedGraph levels. Rows are sorted by neighbor id on construction.
+class CompressedGraph
+{
+public:
+    using vertex_type = int;
+    using weight_type = Weight;
+    using coarse_graph = WeightedGraph;
+    static constexpr bool is_weighted = true;
+
+    struct Edge
+    {
+        int to;
+        Weight w;
+    };
+
+    class EdgeIterator
+    {
+    public:
+        EdgeIterator() = default;
+        EdgeIterator(const std::uint8_t *gaps, const std::uint8_t *weights, int u, int count)
+            : gaps_(gaps)
+            , weights_(weights)
+            , left_(count)
+        {
+            cur_.to = u;
+            if (left_ > 0)
+                decode(true);
+        }
+
+        const Edge &operator*() const
+        {
+            return cur_;
+        }
+        const Edge *operator->() const
+        {
+            return &cur_;
+        }
+        EdgeIterator &operator++()
+        {
+            if (--left_ > 0)
+                decode(false);
+            return *this;
+        }
+        // Iterators of one row compare by the number of edges left.
+        bool operator==(const EdgeIterator &o) const
+        {
+            return left_ == o.left_;
+        }
+        bool operator!=(const EdgeIterator &o) const
+        {
+            return left_ != o.left_;
+        }
+
+    private:
+        void decode(bool first)
+        {
+            std::uint64_t gap = read_varint(gaps_);
+            if (first)
+                cur_.to += (int) ((gap >> 1) ^ (~(gap & 1) + 1));
+            else
+                cur_.to += (int) gap;
+            if (run_ == 0) {
+                run_ = read_varint(weights_);
+                cur_.w = (Weight) read_varint(weights_);
+            }
+            --run_;
+        }
+
+        const std::uint8_t *gaps_ = nullptr;
+        const std::uint8_t *weights_ = nullptr;
+        int left_ = 0;
+        std::uint64_t run_ = 0;
+        Edge cur_{};
+    };
+
+    // View of one decoded row.
+    class Row
+    {
+    public:
+        Row(const std::uint8_t *p, int u)
+            : u_(u)
+        {
+            size_ = (int) read_varint(p);
+            std::size_t gap_bytes = (std::size_t) read_varint(p);
+            gaps_ = p;
+            weights_ = p + gap_bytes;
+        }
+        EdgeIterator begin() const
+        {
+            return EdgeIterator(gaps_, weights_, u_, size_);
+        }
+        EdgeIterator end() const
+        {
+            return EdgeIterator();
+        }
+        std::size_t size() const
+        {
+            return (std::size_t) size_;
+        }
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+    private:
+        const std::uint8_t *gaps_;
+        const std::uint8_t *weights_;
+        int u_;
+        int size_;
+    };
+
+    // The adjacency container: adj[u] yields a Row.
+    class Rows
+    {
+    public:
+        Row operator[](int u) const
+        {
+            return Row(bytes_.data() + offsets_[u], u);
+        }
+        std::size_t size() const
+        {
+            return offsets_.size() - 1;
+        }
+
+    private:
+        friend class CompressedGraph;
+        std::vector<std::uint8_t> bytes_;
+        std::vector<std::uint64_t> offsets_{0};
+    };
+
+    int n = 0;
+    Rows adj;
+
+    CompressedGraph() = default;
+    template<typename Graph>
+    explicit CompressedGraph(const Graph &g);
+
+    // Appends the row of vertex n (neighbor ids may be >= n; they must be < the final n).
+    // Lets callers build the graph row by row without a plain copy in memory.
+    void append_row(std::vector<Edge> row);
+
+    std::vector<Weight> degrees() const;
+    WeightedGraph decompress() const;
+    // Bytes held by the encoded rows and their offsets.
+    std::size_t memory_bytes() const;
+
+private:
+    // LEB128: 7 bits per byte, high bit set on all but the last byte.
+    static std::uint64_t read_varint(const std::uint8_t *&p)
+    {
+        std::uint64_t x = *p++;
+        if (x < 0x80)
+            return x;
+        x &= 0x7f;
+        for (int shift = 7;; shift += 7) {
+            std::uint64_t b = *p++;
+            x |= (b & 0x7f) << shift;
+            if (b < 0x80)
+                return x;
+        }
+    }
+};
+
+// Bytes held by a plain graph's adjacency vectors (capacity included).
+template<typename Graph>
+std::size_t adjacency_memory_bytes(const Graph &g);
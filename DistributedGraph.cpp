@@ -0,0 +1,104 @@
+#include "DistributedGraph.h"
+
+DistributedGraph DistributedGraph::build(Transport &t,
+                                         std::vector<int> vtxdist,
+                                         const std::vector<std::vector<Edge>> &rows)
+{
+    int p = t.size(), me = t.rank();
+    if ((int) vtxdist.size() != p + 1 || vtxdist[0] != 0)
+        throw std::invalid_argument("vtxdist must have one range per rank");
+    for (int q = 0; q < p; ++q)
+        if (vtxdist[q] > vtxdist[q + 1])
+            throw std::invalid_argument("vtxdist must be nondecreasing");
+    DistributedGraph g;
+    g.rank = me;
+    g.global_n = vtxdist[p];
+    g.vtxdist = std::move(vtxdist);
+    int first = g.vtxdist[me];
+    g.n_owned = g.vtxdist[me + 1] - first;
+    if ((int) rows.size() != g.n_owned)
+        throw std::invalid_argument("one row per owned vertex expected");
+
+    std::vector<std::vector<int>> wanted(p);
+    for (auto &row : rows)
+        for (auto &e : row) {
+            if (e.to < 0 || e.to >= g.global_n)
+                throw std::out_of_range("vertex");
+            if (e.to >= first && e.to < first + g.n_owned)
+                continue;
+            if (g.ghost_local_.emplace(e.to, g.n_owned + (int) g.ghost_global.size()).second) {
+                g.ghost_global.push_back(e.to);
+                g.ghost_owner.push_back(g.owner(e.to));
+                wanted[g.ghost_owner.back()].push_back(e.to);
+            }
+        }
+
+    g.local = WeightedGraph(g.n_owned + (int) g.ghost_global.size());
+    for (int u = 0; u < g.n_owned; ++u) {
+        g.local.adj[u].reserve(rows[u].size());
+        for (auto &e : rows[u])
+            g.local.adj[u].push_back({g.local_id(e.to), e.w});
+    }
+
+    // Every owner learns which of its vertices each rank holds as ghosts.
+    g.recv_lists.assign(p, {});
+    std::vector<std::vector<char>> out(p);
+    for (int q = 0; q < p; ++q) {
+        for (int v : wanted[q])
+            g.recv_lists[q].push_back(g.local_id(v));
+        out[q] = to_bytes(wanted[q]);
+    }
+    auto in = all_to_all(t, std::move(out));
+    g.send_lists.assign(p, {});
+    for (int q = 0; q < p; ++q)
+        for (int v : from_bytes<int>(in[q]))
+            g.send_lists[q].push_back(v - first);
+    return g;
+}
+
+int DistributedGraph::owner(int global) const
+{
+    if (global < 0 || global >= global_n)
+        throw std::out_of_range("vertex");
+    return (int) (std::upper_bound(vtxdist.begin(), vtxdist.end(), global) - vtxdist.begin()) - 1;
+}
+
+int DistributedGraph::global_id(int local_id) const
+{
+    return local_id < n_owned ? vtxdist[rank] + local_id : ghost_global[local_id - n_owned];
+}
+
+int DistributedGraph::local_id(int global) const
+{
+    int first = vtxdist[rank];
+    if (global >= first && global < first + n_owned)
+        return global - first;
+    auto it = ghost_local_.find(global);
+    return it == ghost_local_.end() ? -1 : it->second;
+}
+
+std::vector<int> even_vtxdist(int n, int ranks)
+{
+    if (ranks < 1)
+        throw std::invalid_argument("ranks must be positive");
+    std::vector<int> vtxdist(ranks + 1);
+    for (int r = 0; r <= ranks; ++r)
+        vtxdist[r] = (int) ((long long) n * r / ranks);
+    return vtxdist;
+}
+
+template<typename Graph>
+DistributedGraph distribute_graph(const Graph &g, Transport &t)
+{
+    std::vector<int> vtxdist = even_vtxdist(g.n, t.size());
+    int first = vtxdist[t.rank()], last = vtxdist[t.rank() + 1];
+    std::vector<std::vector<DistributedGraph::Edge>> rows(last - first);
+    for (int u = first; u < last; ++u)
+        for (auto &e : g.adj[u])
+            rows[u - first].push_back({(int) e.to, (Weight) e.w});
+    return DistributedGraph::build(t, std::move(vtxdist), rows);
+}
+
+template DistributedGraph distribute_graph(const WeightedGraph &, Transport &);
+template DistributedGraph distribute_graph(const CompactWeightedGraph &, Transport &);
+template DistributedGraph distribute_graph(const UnweightedGraph &, Transport &);
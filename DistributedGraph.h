@@ -0,0 +1,78 @@
+#pragma once
+#include "GraphUtils.h"
+#include "Transport.h"
+#include <unordered_map>
+
+// One rank's shard of a graph distributed by contiguous vertex ranges: rank r owns the global
+// vertices [vtxdist[r], vtxdist[r + 1]). In `local`, ids 0..n_owned-1 are the owned vertices
+// in global order and n_owned.. are ghosts, i.e. neighbors owned by other ranks (their rows are
+// empty). Per-vertex arrays indexed by local id therefore work with the row kernels, and
+// halo_exchange() refreshes their ghost entries from the owners.
+struct DistributedGraph
+{
+    using Edge = WeightedGraph::Edge;
+
+    int global_n = 0;
+    int rank = 0;
+    std::vector<int> vtxdist{0};
+    int n_owned = 0;
+    WeightedGraph local;
+    // Weights of the owned vertices (empty: all 1); coarse levels carry merged weights.
+    std::vector<Weight> vertex_weights;
+    // Global id and owner of ghost n_owned + i.
+    std::vector<int> ghost_global;
+    std::vector<int> ghost_owner;
+    // send_lists[q]: owned local ids that rank q holds as ghosts; recv_lists[q]: local ghost ids
+    // filled from rank q, in the same order.
+    std::vector<std::vector<int>> send_lists;
+    std::vector<std::vector<int>> recv_lists;
+
+    // Builds the shard of rank t.rank() from its owned rows, whose edges use global ids; each
+    // undirected edge must appear in the rows of both endpoints. Collective (exchanges ghost
+    // lists to set up the halo).
+    static DistributedGraph build(Transport &t,
+                                  std::vector<int> vtxdist,
+                                  const std::vector<std::vector<Edge>> &rows);
+
+    int owner(int global) const;
+    int global_id(int local_id) const;
+    // Local id of a global vertex that is owned or a ghost here, -1 otherwise.
+    int local_id(int global) const;
+    // Weight of an owned vertex.
+    Weight vertex_weight(int local_id) const
+    {
+        return vertex_weights.empty() ? 1 : vertex_weights[local_id];
+    }
+
+    // Overwrites the ghost entries of values (one entry per local vertex) with the owners'
+    // values. Collective.
+    template<typename T>
+    void halo_exchange(Transport &t, std::vector<T> &values) const
+    {
+        std::vector<std::vector<char>> out(t.size());
+        std::vector<T> buf;
+        for (int q = 0; q < t.size(); ++q) {
+            buf.clear();
+            for (int u : send_lists[q])
+                buf.push_back(values[u]);
+            out[q] = to_bytes(buf);
+        }
+        auto in = all_to_all(t, std::move(out));
+        for (int q = 0; q < t.size(); ++q) {
+            auto got = from_bytes<T>(in[q]);
+            for (std::size_t i = 0; i < got.size(); ++i)
+                values[recv_lists[q][i]] = got[i];
+        }
+    }
+
+private:
+    std::unordered_map<int, int> ghost_local_;
+};
+
+// Even split of [0, n) into `ranks` contiguous ranges.
+std::vector<int> even_vtxdist(int n, int ranks);
+
+// Shard of rank t.rank() cut out of a graph every rank can read, with an even vertex split.
+// Collective. Stands in for loading the shard from distributed storage.
+template<typename Graph>
+DistributedGraph distribute_graph(const Graph &g, Transport &t);
@@ -0,0 +1,686 @@
+#include "DistributedMultilevelSolver.h"
+#include "MultilevelKWayPartitionSolver.h"
+#include "PartitionMetrics.h"
+#include <deque>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+namespace {
+
+struct MatchRequest
+{
+    int target;
+    int source;
+    Weight w;
+};
+
+struct MatchGrant
+{
+    int source;
+    int target;
+};
+
+struct CoarseArc
+{
+    int from;
+    int to;
+    Weight w;
+};
+
+struct VertexWeight
+{
+    int id;
+    Weight w;
+};
+
+static int range_owner(const std::vector<int> &vtxdist, int id)
+{
+    return (int) (std::upper_bound(vtxdist.begin(), vtxdist.end(), id) - vtxdist.begin()) - 1;
+}
+
+// Whether any rank's control has fired; all ranks get the same answer. Collective.
+static bool agree_to_stop(Transport &t, const SolveControl *control)
+{
+    return all_reduce_sum(t, {should_stop(control) ? 1LL : 0LL})[0] > 0;
+}
+
+// Heavy-edge matching. Returns the coarse global id of every local vertex (owned and ghost)
+// and the coarse vertex distribution; a coarse vertex is owned by the rank of its smaller fine
+// vertex. Collective.
+static std::vector<int> match_distributed(const DistributedGraph &g,
+                                          Transport &t,
+                                          int rounds,
+                                          std::vector<int> &coarse_vtxdist)
+{
+    int p = t.size();
+    int first = g.vtxdist[t.rank()];
+    const auto &adj = g.local.adj;
+    // partner[u]: global id of u's match (its own id once it stays single), -1 while unmatched.
+    std::vector<int> partner(g.local.n, -1);
+    std::vector<char> requested(g.n_owned, 0);
+
+    // Owned pairs, in id order as in the sequential matching. A vertex whose heaviest free
+    // neighbor is a ghost waits for the request rounds.
+    for (int u = 0; u < g.n_owned; ++u) {
+        if (partner[u] != -1)
+            continue;
+        int best = -1;
+        Weight best_w = -1;
+        for (auto &e : adj[u])
+            if (e.to != u && partner[e.to] == -1 && e.w > best_w) {
+                best_w = e.w;
+                best = e.to;
+            }
+        if (best != -1 && best < g.n_owned) {
+            partner[u] = first + best;
+            partner[best] = first + u;
+        }
+    }
+
+    // Requests alternate direction (to higher, then lower global ids) so both sides of a
+    // boundary get to ask.
+    for (int round = 0; round < rounds; ++round) {
+        g.halo_exchange(t, partner);
+        std::fill(requested.begin(), requested.end(), 0);
+        std::vector<std::vector<MatchRequest>> requests(p);
+        for (int u = 0; u < g.n_owned; ++u) {
+            if (partner[u] != -1)
+                continue;
+            int gu = first + u;
+            int best = -1;
+            Weight best_w = -1;
+            for (auto &e : adj[u]) {
+                int v = e.to;
+                if (v == u || partner[v] != -1 || (v < g.n_owned && requested[v]))
+                    continue;
+                if (v >= g.n_owned) {
+                    int gv = g.ghost_global[v - g.n_owned];
+                    if (round % 2 == 0 ? gv < gu : gv > gu)
+                        continue;
+                }
+                if (e.w > best_w) {
+                    best_w = e.w;
+                    best = v;
+                }
+            }
+            if (best == -1)
+                continue;
+            if (best < g.n_owned) {
+                partner[u] = first + best;
+                partner[best] = gu;
+            } else {
+                requested[u] = 1;
+                requests[g.ghost_owner[best - g.n_owned]].push_back(
+                    {g.ghost_global[best - g.n_owned], gu, best_w});
+            }
+        }
+
+        std::vector<std::vector<char>> out(p);
+        for (int q = 0; q < p; ++q)
+            out[q] = to_bytes(requests[q]);
+        auto in = all_to_all(t, std::move(out));
+
+        // Grant each free, non-requesting target to its heaviest request (smaller id on ties).
+        std::vector<MatchRequest> chosen(g.n_owned, MatchRequest{-1, -1, -1});
+        for (int q = 0; q < p; ++q)
+            for (auto &r : from_bytes<MatchRequest>(in[q])) {
+                int v = r.target - first;
+                if (partner[v] != -1 || requested[v])
+                    continue;
+                auto &c = chosen[v];
+                if (r.w > c.w || (r.w == c.w && r.source < c.source))
+                    c = r;
+            }
+        std::vector<std::vector<MatchGrant>> grants(p);
+        for (int v = 0; v < g.n_owned; ++v)
+            if (chosen[v].source != -1) {
+                partner[v] = chosen[v].source;
+                grants[g.owner(chosen[v].source)].push_back({chosen[v].source, first + v});
+            }
+        out.assign(p, {});
+        for (int q = 0; q < p; ++q)
+            out[q] = to_bytes(grants[q]);
+        in = all_to_all(t, std::move(out));
+        for (int q = 0; q < p; ++q)
+            for (auto &gr : from_bytes<MatchGrant>(in[q]))
+                partner[gr.source - first] = gr.target;
+    }
+
+    // Number the coarse vertices: each pair once, at its smaller fine vertex.
+    std::vector<int> cmap(g.local.n, -1);
+    long long leaders = 0;
+    for (int u = 0; u < g.n_owned; ++u) {
+        if (partner[u] == -1)
+            partner[u] = first + u;
+        if (partner[u] >= first + u)
+            ++leaders;
+    }
+    std::vector<long long> counts(p, 0);
+    counts[t.rank()] = leaders;
+    counts = all_reduce_sum(t, counts);
+    coarse_vtxdist.assign(p + 1, 0);
+    for (int q = 0; q < p; ++q)
+        coarse_vtxdist[q + 1] = coarse_vtxdist[q] + (int) counts[q];
+    int next = coarse_vtxdist[t.rank()];
+    for (int u = 0; u < g.n_owned; ++u)
+        if (partner[u] >= first + u)
+            cmap[u] = next++;
+    g.halo_exchange(t, cmap);
+    for (int u = 0; u < g.n_owned; ++u)
+        if (cmap[u] == -1)
+            cmap[u] = cmap[g.local_id(partner[u])];
+    g.halo_exchange(t, cmap);
+    return cmap;
+}
+
+// Contracts g along cmap: every owned fine arc and vertex weight is sent to the owner of its
+// coarse vertex, which merges parallel arcs and sums the weights. Collective.
+static DistributedGraph contract_distributed(const DistributedGraph &g,
+                                             Transport &t,
+                                             const std::vector<int> &cmap,
+                                             std::vector<int> coarse_vtxdist)
+{
+    int p = t.size();
+    std::vector<std::vector<CoarseArc>> arcs(p);
+    std::vector<std::vector<VertexWeight>> weights(p);
+    for (int u = 0; u < g.n_owned; ++u) {
+        int cu = cmap[u];
+        int q = range_owner(coarse_vtxdist, cu);
+        weights[q].push_back({cu, g.vertex_weight(u)});
+        auto &out = arcs[q];
+        for (auto &e : g.local.adj[u]) {
+            int cv = cmap[e.to];
+            if (cu != cv)
+                out.push_back({cu, cv, e.w});
+        }
+    }
+    std::vector<std::vector<char>> out(p);
+    for (int q = 0; q < p; ++q)
+        out[q] = to_bytes(arcs[q]);
+    auto in = all_to_all(t, std::move(out));
+
+    std::vector<CoarseArc> mine;
+    for (int q = 0; q < p; ++q) {
+        auto got = from_bytes<CoarseArc>(in[q]);
+        mine.insert(mine.end(), got.begin(), got.end());
+    }
+    out.assign(p, {});
+    for (int q = 0; q < p; ++q)
+        out[q] = to_bytes(weights[q]);
+    in = all_to_all(t, std::move(out));
+    std::sort(mine.begin(), mine.end(), [](const CoarseArc &a, const CoarseArc &b) {
+        if (a.from != b.from)
+            return a.from < b.from;
+        return a.to < b.to;
+    });
+    int cfirst = coarse_vtxdist[t.rank()];
+    std::vector<std::vector<DistributedGraph::Edge>> rows(coarse_vtxdist[t.rank() + 1] - cfirst);
+    for (auto &a : mine) {
+        auto &row = rows[a.from - cfirst];
+        if (!row.empty() && row.back().to == a.to)
+            row.back().w += a.w;
+        else
+            row.push_back({a.to, a.w});
+    }
+    std::vector<Weight> coarse_weights(rows.size(), 0);
+    for (int q = 0; q < p; ++q)
+        for (auto &vw : from_bytes<VertexWeight>(in[q]))
+            coarse_weights[vw.id - cfirst] += vw.w;
+    DistributedGraph coarse = DistributedGraph::build(t, std::move(coarse_vtxdist), rows);
+    coarse.vertex_weights = std::move(coarse_weights);
+    return coarse;
+}
+
+// Gathers the coarsest graph on rank 0, partitions it there with the sequential multilevel
+// solver and returns each rank its owned labels. Collective.
+static std::vector<int> initial_partition_distributed(const DistributedGraph &g,
+                                                      Transport &t,
+                                                      int k,
+                                                      int bisection_passes,
+                                                      int refine_passes,
+                                                      int max_levels,
+                                                      const SolveControl *control)
+{
+    int p = t.size();
+    std::vector<CoarseArc> arcs;
+    for (int u = 0; u < g.n_owned; ++u)
+        for (auto &e : g.local.adj[u])
+            arcs.push_back({g.global_id(u), g.global_id(e.to), e.w});
+    std::vector<Weight> weights(g.n_owned);
+    for (int u = 0; u < g.n_owned; ++u)
+        weights[u] = g.vertex_weight(u);
+    std::vector<std::vector<char>> out(p);
+    out[0] = to_bytes(arcs);
+    auto in = all_to_all(t, std::move(out));
+    out.assign(p, {});
+    out[0] = to_bytes(weights);
+    auto in_weights = all_to_all(t, std::move(out));
+
+    out.assign(p, {});
+    if (t.rank() == 0) {
+        WeightedGraph coarsest(g.global_n);
+        std::vector<Weight> coarsest_weights;
+        for (int q = 0; q < p; ++q) {
+            for (auto &a : from_bytes<CoarseArc>(in[q]))
+                coarsest.adj[a.from].push_back({a.to, a.w});
+            auto w = from_bytes<Weight>(in_weights[q]);
+            coarsest_weights.insert(coarsest_weights.end(), w.begin(), w.end());
+        }
+        BasicMultilevelKWayPartitionSolver<WeightedGraph> solver(
+            k, bisection_passes, refine_passes, max_levels, {}, std::move(coarsest_weights));
+        solver.set_control(control);
+        solver.solve(coarsest);
+        std::vector<int> part = solver.result().part;
+        for (int q = 0; q < p; ++q)
+            out[q] = to_bytes(std::vector<int>(part.begin() + g.vtxdist[q],
+                                               part.begin() + g.vtxdist[q + 1]));
+    }
+    in = all_to_all(t, std::move(out));
+    return from_bytes<int>(in[0]);
+}
+
+// Labels of arbitrary global vertices of g, given the owned labels on every rank. Collective.
+static std::vector<int> fetch_labels(const DistributedGraph &g,
+                                     Transport &t,
+                                     const std::vector<int> &owned_part,
+                                     const std::vector<int> &ids)
+{
+    int p = t.size();
+    std::vector<std::vector<int>> asked(p);
+    for (int id : ids)
+        asked[g.owner(id)].push_back(id);
+    std::vector<std::vector<char>> out(p);
+    for (int q = 0; q < p; ++q)
+        out[q] = to_bytes(asked[q]);
+    auto in = all_to_all(t, std::move(out));
+    int first = g.vtxdist[t.rank()];
+    out.assign(p, {});
+    for (int q = 0; q < p; ++q) {
+        std::vector<int> answer;
+        for (int id : from_bytes<int>(in[q]))
+            answer.push_back(owned_part[id - first]);
+        out[q] = to_bytes(answer);
+    }
+    in = all_to_all(t, std::move(out));
+
+    std::vector<std::vector<int>> answers(p);
+    std::vector<std::size_t> next(p, 0);
+    for (int q = 0; q < p; ++q)
+        answers[q] = from_bytes<int>(in[q]);
+    std::vector<int> labels;
+    labels.reserve(ids.size());
+    for (int id : ids) {
+        int q = g.owner(id);
+        labels.push_back(answers[q][next[q]++]);
+    }
+    return labels;
+}
+
+// share of `slack` for rank r of p, so that the shares of all ranks add up to slack.
+static long long slack_share(long long slack, int r, int p)
+{
+    if (slack <= 0)
+        return 0;
+    return slack / p + (r < slack % p ? 1 : 0);
+}
+
+// Moves owned vertices out of blocks heavier than max_size, cheapest moves first, into blocks
+// that stay within max_size, until no block is over. In each round every rank picks its share
+// of each overweight block's excess; the free space of the other blocks then goes to the ranks
+// that want to move the most weight, largest free block first, so every round moves at least
+// one vertex. sizes holds the global block weights and is kept current. Collective.
+static void drain_overweight_blocks(const DistributedGraph &g,
+                                    Transport &t,
+                                    std::vector<int> &part,
+                                    int k,
+                                    Weight max_size,
+                                    std::vector<long long> &sizes)
+{
+    int p = t.size(), r = t.rank();
+    std::vector<Weight> weights(k, 0);
+    for (;;) {
+        std::vector<long long> local(k, 0), excess(k, 0);
+        for (int u = 0; u < g.n_owned; ++u)
+            local[part[u]] += g.vertex_weight(u);
+        bool over = false;
+        for (int q = 0; q < k; ++q)
+            if (sizes[q] > max_size) {
+                // In proportion to this rank's part of the block, rounded up.
+                excess[q] = ((sizes[q] - max_size) * local[q] + sizes[q] - 1) / sizes[q];
+                over = true;
+            }
+        if (!over)
+            return;
+
+        std::vector<std::pair<Weight, int>> candidates;
+        for (int u = 0; u < g.n_owned; ++u) {
+            if (excess[part[u]] <= 0)
+                continue;
+            block_connectivity(g.local, part, k, u, weights);
+            Weight best = std::numeric_limits<Weight>::min();
+            for (int q = 0; q < k; ++q)
+                if (q != part[u])
+                    best = std::max(best, weights[q]);
+            candidates.push_back({weights[part[u]] - best, u});
+        }
+        std::sort(candidates.begin(), candidates.end());
+        std::vector<int> chosen;
+        long long demand = 0;
+        for (auto &c : candidates) {
+            int u = c.second;
+            if (excess[part[u]] <= 0)
+                continue;
+            excess[part[u]] -= g.vertex_weight(u);
+            demand += g.vertex_weight(u);
+            chosen.push_back(u);
+        }
+
+        // Every rank computes the same split of the free space. Some block holds at most
+        // ceil(W/k) - 1, so the largest free block takes any single vertex and the first rank
+        // in the order can move its first choice.
+        std::vector<long long> left(p);
+        auto demands = all_gather(t, to_bytes(std::vector<long long>{demand}));
+        for (int s = 0; s < p; ++s)
+            left[s] = from_bytes<long long>(demands[s])[0];
+        std::vector<int> ranks(p), blocks(k);
+        std::iota(ranks.begin(), ranks.end(), 0);
+        std::iota(blocks.begin(), blocks.end(), 0);
+        std::stable_sort(
+            ranks.begin(), ranks.end(), [&](int a, int b) { return left[a] > left[b]; });
+        std::stable_sort(
+            blocks.begin(), blocks.end(), [&](int a, int b) { return sizes[a] < sizes[b]; });
+        std::vector<long long> room_in(k, 0);
+        for (int q : blocks) {
+            long long room = max_size - sizes[q];
+            for (int s : ranks) {
+                if (room <= 0)
+                    break;
+                long long give = std::min(room, left[s]);
+                if (s == r)
+                    room_in[q] += give;
+                left[s] -= give;
+                room -= give;
+            }
+        }
+
+        for (int u : chosen) {
+            Weight w = g.vertex_weight(u);
+            block_connectivity(g.local, part, k, u, weights);
+            int best = -1;
+            for (int q = 0; q < k; ++q) {
+                if (q == part[u] || room_in[q] < w)
+                    continue;
+                if (best == -1 || weights[q] > weights[best])
+                    best = q;
+            }
+            if (best != -1) {
+                local[part[u]] -= w;
+                local[best] += w;
+                room_in[best] -= w;
+                part[u] = best;
+            }
+        }
+        sizes = all_reduce_sum(t, local);
+    }
+}
+
+// Synchronous label propagation with the refine_kway_partition gain rule and balance bounds.
+// Each pass first drains the overweight blocks, then sweeps the owned vertices. Room below the
+// bounds is split evenly between the ranks, so the sweeps keep every block within them.
+// part has one entry per local vertex; the owned entries are refined. Collective.
+static void refine_distributed(const DistributedGraph &g,
+                               Transport &t,
+                               std::vector<int> &part,
+                               int k,
+                               int max_passes,
+                               const SolveControl *control)
+{
+    int p = t.size(), r = t.rank();
+    Weight heaviest = 0;
+    std::vector<long long> total{0};
+    for (int u = 0; u < g.n_owned; ++u) {
+        total[0] += g.vertex_weight(u);
+        heaviest = std::max(heaviest, g.vertex_weight(u));
+    }
+    total = all_reduce_sum(t, total);
+    for (auto &bytes : all_gather(t, to_bytes(std::vector<Weight>{heaviest})))
+        heaviest = std::max(heaviest, from_bytes<Weight>(bytes)[0]);
+    Weight min_size = total[0] / k - (heaviest - 1);
+    Weight max_size = (total[0] + k - 1) / k + (heaviest - 1);
+
+    std::vector<Weight> weights(k, 0);
+    for (int pass = 0; pass < max_passes; ++pass) {
+        // Block weights and the stop flag in one reduction.
+        std::vector<long long> local(k + 1, 0);
+        for (int u = 0; u < g.n_owned; ++u)
+            local[part[u]] += g.vertex_weight(u);
+        local[k] = should_stop(control) ? 1 : 0;
+        std::vector<long long> sizes = all_reduce_sum(t, local);
+        bool stop = sizes[k] > 0;
+        sizes.resize(k);
+        g.halo_exchange(t, part);
+        // Also when stopping, so that the result keeps the bounds.
+        drain_overweight_blocks(g, t, part, k, max_size, sizes);
+        if (stop)
+            break;
+
+        std::vector<long long> room_in(k), room_out(k);
+        for (int q = 0; q < k; ++q) {
+            room_in[q] = slack_share(max_size - sizes[q], r, p);
+            room_out[q] = slack_share(sizes[q] - min_size, r, p);
+        }
+        long long moved = 0;
+        for (int u = 0; u < g.n_owned; ++u) {
+            int pu = part[u];
+            Weight w = g.vertex_weight(u);
+            if (room_out[pu] < w)
+                continue;
+            block_connectivity(g.local, part, k, u, weights);
+            int best = pu;
+            Weight best_gain = 0;
+            for (int q = 0; q < k; ++q) {
+                if (q == pu || room_in[q] < w)
+                    continue;
+                Weight gain = weights[q] - weights[pu];
+                if (gain > best_gain) {
+                    best_gain = gain;
+                    best = q;
+                }
+            }
+            if (best != pu) {
+                room_out[pu] -= w;
+                room_in[best] -= w;
+                part[u] = best;
+                ++moved;
+            }
+        }
+        if (all_reduce_sum(t, {moved})[0] == 0)
+            break;
+    }
+}
+} // namespace
+
+DistributedMultilevelPartitioner::DistributedMultilevelPartitioner(
+    int k, int bisection_passes, int refine_passes, int max_levels, int matching_rounds)
+    : k_(k)
+    , bisection_passes_(bisection_passes)
+    , refine_passes_(refine_passes)
+    , max_levels_(max_levels)
+    , matching_rounds_(matching_rounds)
+{}
+
+std::vector<int> DistributedMultilevelPartitioner::partition(const DistributedGraph &g,
+                                                             Transport &t,
+                                                             const SolveControl *control) const
+{
+    if (g.global_n == 0)
+        return {};
+    int k = std::max(1, std::min(k_, g.global_n));
+    if (k == 1)
+        return std::vector<int>(g.n_owned, 0);
+
+    // coarse[i] is level i+1; maps[i] gives the level i+1 id of every owned level i vertex.
+    std::deque<DistributedGraph> coarse;
+    std::vector<std::vector<int>> maps;
+    const DistributedGraph *cur = &g;
+    int min_coarse = std::max(2 * k, 20);
+    for (int level = 0; level < max_levels_ && cur->global_n > min_coarse; ++level) {
+        if (agree_to_stop(t, control))
+            break;
+        std::vector<int> coarse_vtxdist;
+        std::vector<int> map = match_distributed(*cur, t, matching_rounds_, coarse_vtxdist);
+        // Every rank sees the same totals, so all leave the loop together.
+        if (coarse_vtxdist.back() > cur->global_n - cur->global_n / 20)
+            break;
+        coarse.push_back(contract_distributed(*cur, t, map, std::move(coarse_vtxdist)));
+        map.resize(cur->n_owned);
+        maps.push_back(std::move(map));
+        cur = &coarse.back();
+        if (t.rank() == 0)
+            report_progress(control, "coarsen level", level);
+    }
+
+    std::vector<int> part = initial_partition_distributed(
+        *cur, t, k, bisection_passes_, refine_passes_, max_levels_, control);
+
+    for (int level = (int) maps.size() - 1; level >= 0; --level) {
+        const DistributedGraph &fine = level == 0 ? g : coarse[level - 1];
+        part = fetch_labels(coarse[level], t, part, maps[level]);
+        part.resize(fine.local.n, 0);
+        refine_distributed(fine, t, part, k, refine_passes_, control);
+        part.resize(fine.n_owned);
+        if (t.rank() == 0)
+            report_progress(control, "refine level", level);
+    }
+    return part;
+}
+
+Weight distributed_cut_weight(const DistributedGraph &g,
+                              Transport &t,
+                              const std::vector<int> &owned_part)
+{
+    std::vector<int> part(owned_part);
+    part.resize(g.local.n, 0);
+    g.halo_exchange(t, part);
+    Weight cut = 0;
+    for (int u = 0; u < g.n_owned; ++u) {
+        int gu = g.global_id(u);
+        for (auto &e : g.local.adj[u])
+            if (part[u] != part[e.to] && gu < g.global_id(e.to))
+                cut += e.w;
+    }
+    return all_reduce_sum(t, {cut})[0];
+}
+
+template<typename Graph>
+BasicDistributedMultilevelSolver<Graph>::BasicDistributedMultilevelSolver(int k,
+                                                                          int ranks,
+                                                                          TransportBackend backend,
+                                                                          int bisection_passes,
+                                                                          int refine_passes,
+                                                                          int max_levels)
+    : ranks_(ranks)
+    , backend_(backend)
+    , partitioner_(k, bisection_passes, refine_passes, max_levels)
+{}
+
+template<typename Graph>
+std::string BasicDistributedMultilevelSolver<Graph>::name() const
+{
+    return "k-Way Balanced Partition (Distributed multilevel heuristic)";
+}
+
+template<typename Graph>
+std::string BasicDistributedMultilevelSolver<Graph>::statement() const
+{
+    return "Input: undirected weighted graph G=(V,E,w) whose vertices are split into "
+           "contiguous ranges owned by p ranks, and integer k >= 2.\n"
+           "Goal: assign each vertex a label part[v] in {0..k-1} with block sizes as equal as "
+           "possible, each rank only reading its own rows and exchanging messages.\n"
+           "Objective: minimize total inter-block cut weight:\n"
+           "  Cut_k = sum of w(u,v) over edges {u,v} with part[u] != part[v].";
+}
+
+template<typename Graph>
+std::string BasicDistributedMultilevelSolver<Graph>::complexity() const
+{
+    return "Optimization is NP-hard. Per level and rank: O(m/p + ghosts) work per matching "
+           "round and refinement pass, each a constant number of all-to-all exchanges; the "
+           "coarsest graph is partitioned sequentially on rank 0.";
+}
+
+template<typename Graph>
+void BasicDistributedMultilevelSolver<Graph>::solve(const Graph &g)
+{
+    res_ = {};
+    if (g.n == 0)
+        return;
+    int ranks = std::max(1, std::min(ranks_, g.n));
+    auto group = backend_ == TransportBackend::InProcess ? make_in_process_group(ranks)
+                                                         : make_unix_socket_group(ranks);
+    const SolveControl *control = this->control_;
+    std::mutex mutex;
+    std::exception_ptr error;
+    auto run = [&](int r) {
+        try {
+            Transport &t = *group[r];
+            DistributedGraph shard = distribute_graph(g, t);
+            std::vector<int> owned = partitioner_.partition(shard, t, control);
+            Weight cut = distributed_cut_weight(shard, t, owned);
+            std::vector<std::vector<char>> out(t.size());
+            out[0] = to_bytes(owned);
+            auto in = all_to_all(t, std::move(out));
+            if (r == 0) {
+                for (auto &bytes : in) {
+                    auto labels = from_bytes<int>(bytes);
+                    res_.part.insert(res_.part.end(), labels.begin(), labels.end());
+                }
+                res_.cut_weight = cut;
+            }
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+            // Recorded first, so the error rethrown is the cause rather than a peer's abort.
+            // The ranks waiting on this one fail and abort in turn.
+            group[r]->abort();
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int r = 1; r < ranks; ++r)
+        pool.emplace_back(run, r);
+    run(0);
+    for (auto &th : pool)
+        th.join();
+    if (error)
+        std::rethrow_exception(error);
+    res_.stopped_early = was_stopped(control);
+}
+
+template<typename Graph>
+PartitionResult BasicDistributedMultilevelSolver<Graph>::result() const
+{
+    return res_;
+}
+
+template<typename Graph>
+void BasicDistributedMultilevelSolver<Graph>::print(std::ostream &os) const
+{
+    os << "\n=== " << name() << " ===\n";
+    os << "Problem: " << statement() << "\n";
+    os << "Complexity: " << complexity() << "\n";
+    if (!res_.part.empty()) {
+        auto sizes = partition_block_sizes(res_.part);
+        os << "Result: k=" << sizes.size() << " cut=" << res_.cut_weight << " ";
+        print_block_sizes(os, sizes);
+        os << " ranks=" << std::max(1, std::min(ranks_, (int) res_.part.size())) << "\n";
+    }
+    os << "\n";
+}
+
+template class BasicDistributedMultilevelSolver<WeightedGraph>;
+template class BasicDistributedMultilevelSolver<CompactWeightedGraph>;
+template class BasicDistributedMultilevelSolver<UnweightedGraph>;
@@ -0,0 +1,81 @@
+#pragma once
+#include "DistributedGraph.h"
+#include "GraphPartitionSolver.h"
+
+// The multilevel k-way pipeline of MultilevelKWayPartitionSolver run collectively by the ranks
+// of a Transport group, each holding one DistributedGraph shard:
+//   - coarsening by heavy-edge matching: owned pairs first, then `matching_rounds` synchronous
+//     request/grant rounds for edges to ghosts (a vertex that requests does not grant, so
+//     matches never conflict); contraction sends each coarse arc to the coarse vertex's owner;
+//   - the coarsest graph is gathered on rank 0 and partitioned there by
+//     BasicMultilevelKWayPartitionSolver;
+//   - uncoarsening with synchronous label propagation: every pass refreshes ghost labels,
+//     drains blocks above the balance bound in rounds until none is left (free space goes first
+//     to the ranks with the most weight to move) and moves vertices by the
+//     refine_kway_partition gain rule, each rank using its share of the global block-size
+//     slack so that moves made in parallel keep the balance bounds.
+class DistributedMultilevelPartitioner
+{
+public:
+    explicit DistributedMultilevelPartitioner(int k,
+                                              int bisection_passes = 8,
+                                              int refine_passes = 4,
+                                              int max_levels = 10,
+                                              int matching_rounds = 4);
+
+    // Collective: every rank passes its shard. Returns the blocks of the owned vertices. With a
+    // control, the ranks agree to stop at the next level boundary once any of them sees it
+    // fire.
+    std::vector<int> partition(const DistributedGraph &g,
+                               Transport &t,
+                               const SolveControl *control = nullptr) const;
+
+private:
+    int k_;
+    int bisection_passes_;
+    int refine_passes_;
+    int max_levels_;
+    int matching_rounds_;
+};
+
+// Cut weight of a distributed labeling given the owned vertices' blocks. Collective.
+Weight distributed_cut_weight(const DistributedGraph &g,
+                              Transport &t,
+                              const std::vector<int> &owned_part);
+
+enum class TransportBackend { InProcess, UnixSocket };
+
+// Runs DistributedMultilevelPartitioner on `ranks` threads of this process, each owning an
+// even share of the vertices and talking only through the chosen transport, and gathers the
+// full labeling on rank 0. A single-box stand-in for a multi-process deployment, which would
+// call partition() directly with a connect_unix_socket_group() transport.
+template<typename Graph>
+class BasicDistributedMultilevelSolver final : public IBasicGraphPartitionSolver<Graph>
+{
+public:
+    explicit BasicDistributedMultilevelSolver(
+        int k,
+        int ranks = 4,
+        TransportBackend backend = TransportBackend::InProcess,
+        int bisection_passes = 8,
+        int refine_passes = 4,
+        int max_levels = 10);
+
+    std::string name() const override;
+    std::string statement() const override;
+    std::string complexity() const override;
+
+    void solve(const Graph &g) override;
+
+    PartitionResult result() const override;
+
+    void print(std::ostream &os) const override;
+
+private:
+    int ranks_;
+    TransportBackend backend_;
+    DistributedMultilevelPartitioner partitioner_;
+    PartitionResult res_;
+};
+
+using DistributedMultilevelSolver = BasicDistributedMultilevelSolver<WeightedGraph>;
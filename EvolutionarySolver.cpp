@@ -0,0 +1,212 @@
+#include "EvolutionarySolver.h"
+#include "CompressedGraph.h"
+#include "MultilevelKWayPartitionSolver.h"
+#include "ParallelUtils.h"
+#include "PartitionMetrics.h"
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+// splitmix64 finalizer: independent seeds for the runs and workers of one search.
+static std::uint64_t mix_seed(std::uint64_t seed, std::uint64_t index)
+{
+    std::uint64_t x = seed + 0x9e3779b97f4a7c15ULL * (index + 1);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// One group per pair (p1[v], p2[v]) that occurs, numbered in order of first occurrence.
+static std::vector<int> overlay_groups(const std::vector<int> &p1, const std::vector<int> &p2)
+{
+    std::unordered_map<long long, int> ids;
+    std::vector<int> groups(p1.size());
+    for (size_t v = 0; v < p1.size(); ++v) {
+        long long key = ((long long) p1[v] << 32) | (unsigned) p2[v];
+        groups[v] = ids.emplace(key, (int) ids.size()).first->second;
+    }
+    return groups;
+}
+
+} // namespace
+
+template<typename Graph>
+BasicEvolutionarySolver<Graph>::BasicEvolutionarySolver(int k, EvolutionOptions options)
+    : k_(k)
+    , options_(options)
+{
+    if (options_.population < 1)
+        throw std::invalid_argument("population must be at least 1");
+}
+
+template<typename Graph>
+std::string BasicEvolutionarySolver<Graph>::name() const
+{
+    return "k-Way Balanced Partition (Memetic multilevel search)";
+}
+
+template<typename Graph>
+std::string BasicEvolutionarySolver<Graph>::statement() const
+{
+    return "Input: undirected weighted graph G=(V,E,w), integer k >= 2 and a time budget.\n"
+           "Goal: assign each vertex a label part[v] in {0..k-1} with block sizes as equal as "
+           "possible.\n"
+           "Objective: minimize total inter-block cut weight, keeping the best partition found "
+           "within the budget.";
+}
+
+template<typename Graph>
+std::string BasicEvolutionarySolver<Graph>::complexity() const
+{
+    return "Optimization is NP-hard. Every initial individual and every offspring costs one "
+           "multilevel run; the number of offspring is bounded by the time budget.";
+}
+
+template<typename Graph>
+void BasicEvolutionarySolver<Graph>::solve(const Graph &g)
+{
+    res_ = {};
+    population_.clear();
+    curve_.clear();
+    offspring_ = 0;
+    if (g.n == 0)
+        return;
+
+    const SolveControl *control = this->control_;
+    auto start = SolveControl::Clock::now();
+    auto deadline = start + options_.time_budget;
+    // Cancels the running multilevel runs once the user's control fires; the budget reaches
+    // them through their own deadline.
+    CancellationToken token;
+    auto stopping = [&] {
+        if (should_stop(control))
+            token.cancel();
+        return token.cancelled() || SolveControl::Clock::now() >= deadline;
+    };
+    auto run = [&](const std::vector<int> &groups,
+                   const std::vector<int> &initial,
+                   std::uint64_t seed) {
+        SolveControl run_control;
+        run_control.set_deadline(deadline);
+        run_control.set_cancellation(token);
+        run_control.set_progress([&](const SolveProgress &) { stopping(); });
+        BasicMultilevelKWayPartitionSolver<Graph> ml(
+            k_, options_.bisection_passes, options_.refine_passes, options_.max_levels);
+        ml.set_parallel({ParallelMode::Deterministic, 1, seed});
+        ml.set_combine(groups, initial);
+        ml.set_control(&run_control);
+        ml.solve(g);
+        auto child = ml.result();
+        child.stopped_early = false;
+        return child;
+    };
+
+    std::mutex mutex;
+    int size = options_.population;
+    // Caller holds the mutex. Fills the population, then replaces the worst individual by a
+    // better child that is not already present.
+    auto insert = [&](PartitionResult child) {
+        Weight best = curve_.empty() ? std::numeric_limits<Weight>::max()
+                                     : curve_.back().cut_weight;
+        if ((int) population_.size() < size) {
+            population_.push_back(child);
+        } else {
+            auto worst = std::max_element(population_.begin(),
+                                          population_.end(),
+                                          [](const PartitionResult &a, const PartitionResult &b) {
+                                              return a.cut_weight < b.cut_weight;
+                                          });
+            if (child.cut_weight >= worst->cut_weight)
+                return;
+            for (const auto &p : population_)
+                if (p.cut_weight == child.cut_weight && p.part == child.part)
+                    return;
+            *worst = child;
+        }
+        if (child.cut_weight < best) {
+            double seconds =
+                std::chrono::duration<double>(SolveControl::Clock::now() - start).count();
+            curve_.push_back({seconds, child.cut_weight, offspring_});
+            report_progress(
+                control, "evolution improvement", (int) curve_.size() - 1, child.cut_weight);
+        }
+    };
+
+    parallel_for_chunks(size, options_.threads, 1, [&](long long b, long long e, int) {
+        for (long long i = b; i < e; ++i) {
+            auto child = run({}, {}, mix_seed(options_.seed, (std::uint64_t) i));
+            std::lock_guard<std::mutex> lock(mutex);
+            insert(std::move(child));
+        }
+    });
+
+    std::atomic<long long> next_seed{size};
+    int workers = resolve_threads(options_.threads);
+    parallel_for_chunks(workers, workers, 1, [&](long long b, long long, int) {
+        std::mt19937_64 rng(mix_seed(~options_.seed, (std::uint64_t) b));
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        while (!stopping()) {
+            std::vector<int> p1, p2;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                int n = (int) population_.size();
+                auto tournament = [&] {
+                    int x = (int) (rng() % n), y = (int) (rng() % n);
+                    return population_[x].cut_weight <= population_[y].cut_weight ? x : y;
+                };
+                int a = tournament(), c = a;
+                for (int tries = 0; n > 1 && c == a && tries < 8; ++tries)
+                    c = tournament();
+                if (population_[c].cut_weight < population_[a].cut_weight)
+                    std::swap(a, c);
+                p1 = population_[a].part;
+                if (c != a && coin(rng) >= options_.mutation_rate)
+                    p2 = population_[c].part;
+            }
+            // The better parent seeds the coarsest level; a mutation contracts only within
+            // its blocks under a fresh matching seed.
+            auto groups = p2.empty() ? p1 : overlay_groups(p1, p2);
+            auto child = run(groups, p1, mix_seed(options_.seed, (std::uint64_t) next_seed++));
+            std::lock_guard<std::mutex> lock(mutex);
+            offspring_++;
+            insert(std::move(child));
+        }
+    });
+
+    std::stable_sort(population_.begin(),
+                     population_.end(),
+                     [](const PartitionResult &a, const PartitionResult &b) {
+                         return a.cut_weight < b.cut_weight;
+                     });
+    res_ = population_.front();
+    res_.stopped_early = was_stopped(control);
+}
+
+template<typename Graph>
+PartitionResult BasicEvolutionarySolver<Graph>::result() const
+{
+    return res_;
+}
+
+template<typename Graph>
+void BasicEvolutionarySolver<Graph>::print(std::ostream &os) const
+{
+    os << "\n=== " << name() << " ===\n";
+    os << "Problem: " << statement() << "\n";
+    os << "Complexity: " << complexity() << "\n";
+    if (!res_.part.empty()) {
+        auto sizes = partition_block_sizes(res_.part);
+        os << "Result: k=" << sizes.size() << " cut=" << res_.cut_weight << " ";
+        print_block_sizes(os, sizes);
+        os << " offspring=" << offspring_ << "\n";
+    }
+    os << "\n";
+}
+
+template class BasicEvolutionarySolver<WeightedGraph>;
+template class BasicEvolutionarySolver<CompactWeightedGraph>;
+template class BasicEvolutionarySolver<UnweightedGraph>;
+template class BasicEvolutionarySolver<CompressedGraph>;
@@ -0,0 +1,86 @@
+#pragma once
+#include "GraphPartitionSolver.h"
+#include <chrono>
+#include <cstdint>
+
+struct EvolutionOptions
+{
+    // Partitions kept; the initial ones come from independently seeded multilevel runs.
+    int population = 16;
+    // Workers breeding offspring concurrently; <= 0 means all hardware threads.
+    int threads = 0;
+    // Wall time for the whole search, initial population included.
+    std::chrono::milliseconds time_budget{1000};
+    // Seeds the initial runs, parent selection and the combine runs.
+    std::uint64_t seed = 1;
+    // Share of offspring made by re-running the multilevel cycle on one parent alone (a
+    // V-cycle with a new matching seed) instead of combining two parents.
+    double mutation_rate = 0.1;
+    // Passed to every BasicMultilevelKWayPartitionSolver run.
+    int bisection_passes = 8;
+    int refine_passes = 4;
+    int max_levels = 10;
+};
+
+// One point of the quality-vs-time curve: the best cut after `seconds`, once `offspring`
+// children have been evaluated.
+struct EvolutionPoint
+{
+    double seconds = 0;
+    Weight cut_weight = 0;
+    long long offspring = 0;
+};
+
+// Memetic search over multilevel partitions:
+//   - the population starts as `population` runs of BasicMultilevelKWayPartitionSolver with
+//     distinct matching seeds (Deterministic mode on one thread each), spread over the workers;
+//   - each worker then repeatedly picks two parents by binary tournament and combines them: a
+//     multilevel run whose coarsening never contracts an edge cut in either parent and whose
+//     coarsest level starts from the better parent (set_combine), so good cut edges survive
+//     while the rest of the graph is re-optimized; with probability mutation_rate it instead
+//     re-runs one parent with a new seed;
+//   - a child replaces the worst individual if its cut is lower and it is not already in the
+//     population.
+// Stops at the time budget or when the solver's control fires, returning the best partition.
+// With more than one worker the interleaving, and so the result, depends on timing.
+template<typename Graph>
+class BasicEvolutionarySolver final : public IBasicGraphPartitionSolver<Graph>
+{
+public:
+    explicit BasicEvolutionarySolver(int k, EvolutionOptions options = {});
+
+    std::string name() const override;
+    std::string statement() const override;
+    std::string complexity() const override;
+
+    void solve(const Graph &g) override;
+
+    PartitionResult result() const override;
+
+    // Best cut over time, one point per improvement.
+    const std::vector<EvolutionPoint> &curve() const
+    {
+        return curve_;
+    }
+    // The final population, best first.
+    const std::vector<PartitionResult> &population() const
+    {
+        return population_;
+    }
+    long long offspring() const
+    {
+        return offspring_;
+    }
+
+    void print(std::ostream &os) const override;
+
+private:
+    int k_;
+    EvolutionOptions options_;
+    std::vector<PartitionResult> population_;
+    std::vector<EvolutionPoint> curve_;
+    long long offspring_ = 0;
+    PartitionResult res_;
+};
+
+using EvolutionarySolver = BasicEvolutionarySolver<WeightedGraph>;
@@ -0,0 +1,400 @@
+#include "ExternalMultilevelSolver.h"
+#include "GraphFile.h"
+#include "MultilevelKWayPartitionSolver.h"
+#include "PartitionMetrics.h"
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+
+namespace {
+
+struct CoarseArc
+{
+    int from;
+    int to;
+    Weight w;
+};
+
+// Removes the registered files when the solve ends, also on exceptions.
+class TempFiles
+{
+public:
+    explicit TempFiles(const std::string &dir)
+    {
+        static std::atomic<unsigned> counter{0};
+        std::filesystem::create_directories(dir);
+        auto ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+        prefix_ = (std::filesystem::path(dir)
+                   / ("gpext-" + std::to_string(ticks) + "-" + std::to_string(counter++)))
+                      .string();
+    }
+    ~TempFiles()
+    {
+        for (auto &path : paths_)
+            std::remove(path.c_str());
+    }
+    std::string add(const std::string &suffix)
+    {
+        paths_.push_back(prefix_ + "-" + suffix);
+        return paths_.back();
+    }
+
+private:
+    std::string prefix_;
+    std::vector<std::string> paths_;
+};
+
+static void write_ints(const std::string &path, const std::vector<int> &values)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write((const char *) values.data(), (std::streamsize) (values.size() * sizeof(int)));
+    if (!out)
+        throw std::runtime_error("cannot write " + path);
+}
+
+static void append_arcs(const std::string &path, std::vector<CoarseArc> &arcs)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    out.write((const char *) arcs.data(), (std::streamsize) (arcs.size() * sizeof(CoarseArc)));
+    if (!out)
+        throw std::runtime_error("cannot write " + path);
+    arcs.clear();
+}
+
+static std::vector<CoarseArc> read_arcs(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return {};
+    std::vector<CoarseArc> arcs((std::size_t) in.tellg() / sizeof(CoarseArc));
+    in.seekg(0);
+    in.read((char *) arcs.data(), (std::streamsize) (arcs.size() * sizeof(CoarseArc)));
+    if (!in)
+        throw std::runtime_error("cannot read " + path);
+    return arcs;
+}
+
+// Heavy-edge matching in one pass over the rows in id order: an unmatched vertex is merged with
+// its heaviest unmatched neighbor. Returns the number of coarse vertices.
+static int match_sequential(const GraphFile &g, std::vector<int> &fine_to_coarse)
+{
+    fine_to_coarse.assign(g.n, -1);
+    int coarse_n = 0;
+    for (int u = 0; u < g.n; ++u) {
+        if (fine_to_coarse[u] != -1)
+            continue;
+        int best = -1;
+        Weight best_w = -1;
+        for (auto &e : g.adj[u]) {
+            if (e.to == u || fine_to_coarse[e.to] != -1)
+                continue;
+            if (e.w > best_w) {
+                best_w = e.w;
+                best = e.to;
+            }
+        }
+        fine_to_coarse[u] = coarse_n;
+        if (best != -1)
+            fine_to_coarse[best] = coarse_n;
+        ++coarse_n;
+    }
+    return coarse_n;
+}
+
+// Writes the graph contracted along fine_to_coarse to out_path. The coarse arcs are distributed
+// into buckets of consecutive coarse ids, each small enough to sort in half the budget; the
+// distribution buffers share a quarter of it.
+static void contract_to_file(const std::string &fine_path,
+                             const std::vector<int> &fine_to_coarse,
+                             int coarse_n,
+                             const std::string &out_path,
+                             TempFiles &temp,
+                             std::size_t budget,
+                             ExternalMemoryStats &stats)
+{
+    std::vector<std::string> bucket_paths;
+    int range = 0;
+    {
+        GraphFile fine(fine_path, budget / 4);
+        std::size_t half = std::max(budget / 2, sizeof(CoarseArc));
+        std::size_t total = (std::size_t) fine.arc_count() * sizeof(CoarseArc);
+        int buckets = (int) std::min<std::size_t>((total + half - 1) / half, coarse_n);
+        buckets = std::max(1, buckets);
+        range = (coarse_n + buckets - 1) / buckets;
+        std::size_t buffer_arcs = std::max<std::size_t>(
+            1, budget / 4 / sizeof(CoarseArc) / (std::size_t) buckets);
+
+        std::vector<std::vector<CoarseArc>> buffers(buckets);
+        for (int b = 0; b < buckets; ++b) {
+            bucket_paths.push_back(temp.add("bucket" + std::to_string(b)));
+            std::remove(bucket_paths.back().c_str());
+            buffers[b].reserve(buffer_arcs);
+        }
+        for (int u = 0; u < fine.n; ++u) {
+            int cu = fine_to_coarse[u];
+            auto &buffer = buffers[cu / range];
+            for (auto &e : fine.adj[u]) {
+                int cv = fine_to_coarse[e.to];
+                if (cu == cv)
+                    continue;
+                buffer.push_back({cu, cv, e.w});
+                if (buffer.size() == buffer_arcs) {
+                    stats.bytes_written += (long long) (buffer.size() * sizeof(CoarseArc));
+                    append_arcs(bucket_paths[cu / range], buffer);
+                }
+            }
+        }
+        for (int b = 0; b < buckets; ++b) {
+            stats.bytes_written += (long long) (buffers[b].size() * sizeof(CoarseArc));
+            append_arcs(bucket_paths[b], buffers[b]);
+        }
+        stats.bytes_read += fine.bytes_read();
+        stats.peak_edge_bytes = std::max(stats.peak_edge_bytes,
+                                         fine.memory_bytes()
+                                             + (std::size_t) buckets * buffer_arcs
+                                                   * sizeof(CoarseArc));
+    }
+
+    GraphFileWriter out(out_path, coarse_n);
+    std::vector<GraphFileWriter::Edge> row;
+    for (int b = 0; b < (int) bucket_paths.size(); ++b) {
+        std::vector<CoarseArc> arcs = read_arcs(bucket_paths[b]);
+        std::remove(bucket_paths[b].c_str());
+        stats.bytes_read += (long long) (arcs.size() * sizeof(CoarseArc));
+        stats.peak_edge_bytes = std::max(stats.peak_edge_bytes, arcs.size() * sizeof(CoarseArc));
+        std::sort(arcs.begin(), arcs.end(), [](const CoarseArc &a, const CoarseArc &c) {
+            if (a.from != c.from)
+                return a.from < c.from;
+            return a.to < c.to;
+        });
+        std::size_t i = 0;
+        int end = std::min(coarse_n, (b + 1) * range);
+        for (int cu = b * range; cu < end; ++cu) {
+            row.clear();
+            for (; i < arcs.size() && arcs[i].from == cu; ++i) {
+                if (!row.empty() && row.back().to == arcs[i].to)
+                    row.back().w += arcs[i].w;
+                else
+                    row.push_back({arcs[i].to, arcs[i].w});
+            }
+            out.append_row(row.data(), row.size());
+        }
+    }
+    out.close();
+    stats.bytes_written += out.bytes_written();
+}
+
+// Splits vertices 0..n-1 into k ranges of consecutive ids and about equal weight (empty weights:
+// unit); the start of a level that is too large to load.
+static std::vector<int> contiguous_blocks(const std::vector<Weight> &weights, int n, int k)
+{
+    Weight total = weights.empty() ? n : 0;
+    for (Weight w : weights)
+        total += w;
+    std::vector<int> part(n);
+    Weight before = 0;
+    for (int u = 0; u < n; ++u) {
+        part[u] = (int) std::min<Weight>(k - 1, before * k / std::max<Weight>(1, total));
+        before += weights.empty() ? 1 : weights[u];
+    }
+    return part;
+}
+} // namespace
+
+template<typename Graph>
+BasicExternalMultilevelSolver<Graph>::BasicExternalMultilevelSolver(int k,
+                                                                    ExternalMemoryConfig config,
+                                                                    int bisection_passes,
+                                                                    int refine_passes,
+                                                                    int max_levels)
+    : k_(k)
+    , config_(std::move(config))
+    , bisection_passes_(bisection_passes)
+    , refine_passes_(refine_passes)
+    , max_levels_(max_levels)
+{}
+
+template<typename Graph>
+std::string BasicExternalMultilevelSolver<Graph>::name() const
+{
+    return "k-Way Balanced Partition (External-memory multilevel heuristic)";
+}
+
+template<typename Graph>
+std::string BasicExternalMultilevelSolver<Graph>::statement() const
+{
+    return "Input: undirected weighted graph G=(V,E,w) stored in a graph file, integer k >= 2 "
+           "and a memory budget M for edge data.\n"
+           "Goal: assign each vertex a label part[v] in {0..k-1} with block sizes as equal as "
+           "possible, holding at most about M bytes of edges in memory.\n"
+           "Objective: minimize total inter-block cut weight:\n"
+           "  Cut_k = sum of w(u,v) over edges {u,v} with part[u] != part[v].";
+}
+
+template<typename Graph>
+std::string BasicExternalMultilevelSolver<Graph>::complexity() const
+{
+    return "Optimization is NP-hard. Per disk level: O(m) sequential I/O for matching, "
+           "O(m) to distribute and O(m log(m/B)) to sort the contraction buckets, "
+           "O(passes*m) sequential I/O for refinement; then the in-memory multilevel solver "
+           "on the first level that fits.";
+}
+
+template<typename Graph>
+void BasicExternalMultilevelSolver<Graph>::solve(const Graph &g)
+{
+    TempFiles temp(config_.work_dir);
+    std::string path = temp.add("input.graph");
+    write_graph_file(g, path);
+    solve_file(path);
+    stats_.bytes_written += (long long) std::filesystem::file_size(path);
+}
+
+template<typename Graph>
+void BasicExternalMultilevelSolver<Graph>::solve_file(const std::string &path)
+{
+    res_ = {};
+    stats_ = {};
+    const SolveControl *control = this->control_;
+    std::size_t budget = std::max<std::size_t>(config_.memory_budget, 1024);
+    std::size_t block = budget / 4;
+    TempFiles temp(config_.work_dir);
+
+    // level_paths[i] holds level i (0 is the input); map_paths[i] projects level i onto i+1.
+    std::vector<std::string> level_paths{path};
+    std::vector<std::string> map_paths;
+    std::vector<int> level_n;
+    // level_weights[i]: vertex weights of level i (empty for the input: unit weights).
+    std::vector<std::vector<Weight>> level_weights{{}};
+    long long arcs = 0;
+    {
+        GraphFile input(path, block);
+        level_n.push_back(input.n);
+        arcs = input.arc_count();
+    }
+    if (level_n[0] == 0)
+        return;
+    int min_coarse = std::max(2 * k_, 20);
+    while ((std::size_t) arcs * sizeof(GraphFile::Edge) > budget / 2
+           && (int) map_paths.size() + 1 < max_levels_ && level_n.back() > min_coarse
+           && !should_stop(control)) {
+        int level = (int) map_paths.size();
+        std::vector<int> map;
+        int coarse_n = 0;
+        {
+            GraphFile fine(level_paths.back(), block);
+            coarse_n = match_sequential(fine, map);
+            stats_.bytes_read += fine.bytes_read();
+            stats_.peak_edge_bytes = std::max(stats_.peak_edge_bytes, fine.memory_bytes());
+        }
+        // Matching has stalled (e.g. a star): stop coarsening on disk.
+        if (coarse_n > level_n.back() - level_n.back() / 20)
+            break;
+        map_paths.push_back(temp.add("map" + std::to_string(level)));
+        write_ints(map_paths.back(), map);
+        stats_.bytes_written += (long long) (map.size() * sizeof(int));
+        level_paths.push_back(temp.add("level" + std::to_string(level + 1) + ".graph"));
+        contract_to_file(
+            level_paths[level], map, coarse_n, level_paths.back(), temp, budget, stats_);
+        level_n.push_back(coarse_n);
+        const auto &fine_weights = level_weights.back();
+        std::vector<Weight> coarse_weights(coarse_n, 0);
+        for (int u = 0; u < (int) map.size(); ++u)
+            coarse_weights[map[u]] += fine_weights.empty() ? 1 : fine_weights[u];
+        level_weights.push_back(std::move(coarse_weights));
+        arcs = GraphFile(level_paths.back(), block).arc_count();
+        report_progress(control, "coarsen level (disk)", level);
+    }
+    stats_.disk_levels = (int) map_paths.size();
+
+    std::vector<int> part;
+    int k = std::max(1, std::min(k_, level_n.back()));
+    if ((std::size_t) arcs * sizeof(GraphFile::Edge) > budget / 2) {
+        // Loading this level would break the budget: start from contiguous id ranges and
+        // refine by streaming.
+        part = contiguous_blocks(level_weights.back(), level_n.back(), k);
+        GraphFile file(level_paths.back(), block);
+        refine_kway_partition(file, part, k, refine_passes_, {}, control, level_weights.back());
+        stats_.bytes_read += file.bytes_read();
+        stats_.peak_edge_bytes = std::max(stats_.peak_edge_bytes, file.memory_bytes());
+    } else {
+        GraphFile file(level_paths.back(), block);
+        WeightedGraph coarse = file.load();
+        stats_.bytes_read += file.bytes_read();
+        stats_.peak_edge_bytes
+            = std::max(stats_.peak_edge_bytes, (std::size_t) arcs * sizeof(WeightedGraph::Edge));
+        stats_.coarsest_loaded = true;
+        BasicMultilevelKWayPartitionSolver<WeightedGraph> inner(
+            k_,
+            bisection_passes_,
+            refine_passes_,
+            std::max(1, max_levels_ - stats_.disk_levels),
+            {},
+            level_weights.back());
+        inner.set_control(control);
+        inner.solve(coarse);
+        part = inner.result().part;
+    }
+
+    // Once stopped, the remaining levels are only projected (refinement returns immediately).
+    for (int level = stats_.disk_levels - 1; level >= 0; --level) {
+        std::vector<int> fine_part(level_n[level]);
+        {
+            std::ifstream in(map_paths[level], std::ios::binary);
+            std::vector<int> chunk(1 << 16);
+            for (int u = 0; u < level_n[level];) {
+                int count = std::min((int) chunk.size(), level_n[level] - u);
+                in.read((char *) chunk.data(), (std::streamsize) count * sizeof(int));
+                if (!in)
+                    throw std::runtime_error("cannot read " + map_paths[level]);
+                for (int i = 0; i < count; ++i)
+                    fine_part[u + i] = part[chunk[i]];
+                u += count;
+            }
+            stats_.bytes_read += (long long) level_n[level] * sizeof(int);
+        }
+        part = std::move(fine_part);
+        GraphFile fine(level_paths[level], block);
+        refine_kway_partition(fine, part, k, refine_passes_, {}, control, level_weights[level]);
+        stats_.bytes_read += fine.bytes_read();
+        stats_.peak_edge_bytes = std::max(stats_.peak_edge_bytes, fine.memory_bytes());
+        report_progress(control, "refine level (disk)", level);
+    }
+
+    GraphFile input(path, block);
+    res_.part = std::move(part);
+    res_.cut_weight = cut_weight_undirected(input, res_.part);
+    stats_.bytes_read += input.bytes_read();
+    res_.stopped_early = was_stopped(control);
+}
+
+template<typename Graph>
+PartitionResult BasicExternalMultilevelSolver<Graph>::result() const
+{
+    return res_;
+}
+
+template<typename Graph>
+ExternalMemoryStats BasicExternalMultilevelSolver<Graph>::stats() const
+{
+    return stats_;
+}
+
+template<typename Graph>
+void BasicExternalMultilevelSolver<Graph>::print(std::ostream &os) const
+{
+    os << "\n=== " << name() << " ===\n";
+    os << "Problem: " << statement() << "\n";
+    os << "Complexity: " << complexity() << "\n";
+    if (!res_.part.empty()) {
+        auto sizes = partition_block_sizes(res_.part);
+        os << "Result: k=" << sizes.size() << " cut=" << res_.cut_weight << " ";
+        print_block_sizes(os, sizes);
+        os << " disk_levels=" << stats_.disk_levels << "\n";
+    }
+    os << "\n";
+}
+
+template class BasicExternalMultilevelSolver<WeightedGraph>;
+template class BasicExternalMultilevelSolver<CompactWeightedGraph>;
+template class BasicExternalMultilevelSolver<UnweightedGraph>;
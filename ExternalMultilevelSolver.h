@@ -0,0 +1,72 @@
+#pragma once
+#include "GraphPartitionSolver.h"
+
+struct ExternalMemoryConfig
+{
+    // Directory for the temporary level and map files (created if missing).
+    std::string work_dir = ".";
+    // Bytes of edge data held in memory at once: file blocks, contraction buckets and the
+    // in-memory coarse levels. Per-vertex arrays (about 28 bytes per fine vertex) come on top.
+    // If disk coarsening ends before a level fits in half the budget (matching stalls, as on a
+    // star, max_levels is reached, or the solve is stopped), that level is never loaded: it is
+    // split into contiguous id ranges of equal weight and refined by streaming sweeps, at the
+    // cost of a worse cut. ExternalMemoryStats::coarsest_loaded tells which case ran.
+    std::size_t memory_budget = std::size_t(256) << 20;
+};
+
+struct ExternalMemoryStats
+{
+    // Levels coarsened on disk before the graph fit the budget.
+    int disk_levels = 0;
+    long long bytes_read = 0;
+    long long bytes_written = 0;
+    // Largest amount of edge data held in memory at once.
+    std::size_t peak_edge_bytes = 0;
+    // Whether the coarsest level fit the budget and was partitioned in memory.
+    bool coarsest_loaded = false;
+};
+
+// Multilevel k-way partitioning for graphs larger than memory. Levels whose edges exceed half
+// the memory budget stay in graph files (see GraphFile.h): each is matched in one sequential
+// pass (heavy edge, vertices in id order), its fine-to-coarse map is written to disk, and it is
+// contracted by distributing the coarse arcs into bucket files by coarse id range, then sorting
+// and merging one bucket at a time. The first level that fits is loaded and partitioned by
+// BasicMultilevelKWayPartitionSolver (see ExternalMemoryConfig for a level that never fits);
+// the disk levels are then uncoarsened by streaming the map files back and refining with
+// sequential sweeps over the level files.
+template<typename Graph>
+class BasicExternalMultilevelSolver final : public IBasicGraphPartitionSolver<Graph>
+{
+public:
+    explicit BasicExternalMultilevelSolver(int k,
+                                           ExternalMemoryConfig config = {},
+                                           int bisection_passes = 8,
+                                           int refine_passes = 4,
+                                           int max_levels = 10);
+
+    std::string name() const override;
+    std::string statement() const override;
+    std::string complexity() const override;
+
+    // Writes g to a graph file in work_dir and runs solve_file() on it.
+    void solve(const Graph &g) override;
+    // Partitions the graph stored at path (written by write_graph_file or GraphFileWriter);
+    // the input is only read sequentially and never loaded as a whole.
+    void solve_file(const std::string &path);
+
+    PartitionResult result() const override;
+    ExternalMemoryStats stats() const;
+
+    void print(std::ostream &os) const override;
+
+private:
+    int k_;
+    ExternalMemoryConfig config_;
+    int bisection_passes_;
+    int refine_passes_;
+    int max_levels_;
+    PartitionResult res_;
+    ExternalMemoryStats stats_;
+};
+
+using ExternalMultilevelSolver = BasicExternalMultilevelSolver<WeightedGraph>;
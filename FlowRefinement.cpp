@@ -0,0 +1,257 @@
+#include "FlowRefinement.h"
+#include "CompressedGraph.h"
+#include "MaxFlow.h"
+#include <cmath>
+
+namespace {
+
+static int max_side_size(int n, double epsilon)
+{
+    return std::min(n, (int) std::ceil((1.0 + std::max(0.0, epsilon)) * n / 2.0));
+}
+
+// Vertices of a side with `count` vertices that may enter the corridor: the rest stays with the
+// terminal, so the side keeps at least max(min_side, 1) vertices whatever the cut.
+static long long corridor_budget(int count, int min_side)
+{
+    return std::max(0, std::min(count - min_side, count - 1));
+}
+
+// Adds up to `budget` vertices labeled `side` to the corridor, in BFS order from `seeds` and
+// the side's vertices adjacent to corridor vertices already added.
+template<typename Graph>
+static void grow_corridor(const Graph &g,
+                          const std::vector<int> &label,
+                          int side,
+                          const std::vector<int> &seeds,
+                          long long budget,
+                          std::vector<int> &local,
+                          std::vector<int> &corridor)
+{
+    size_t head = corridor.size();
+    for (int v : seeds) {
+        if (budget <= 0)
+            return;
+        if (local[v] == -1 && label[v] == side) {
+            local[v] = (int) corridor.size();
+            corridor.push_back(v);
+            --budget;
+        }
+    }
+    for (; head < corridor.size() && budget > 0; ++head)
+        for (auto &e : g.adj[corridor[head]]) {
+            int v = e.to;
+            if (local[v] != -1 || label[v] != side)
+                continue;
+            local[v] = (int) corridor.size();
+            corridor.push_back(v);
+            if (--budget == 0)
+                return;
+        }
+}
+
+static int larger_side(const std::vector<int> &label)
+{
+    int count[3] = {0, 0, 0};
+    for (int l : label)
+        count[l]++;
+    return std::max(count[0], count[1]);
+}
+} // namespace
+
+template<typename Graph>
+bool flow_refine_bisection(const Graph &g, std::vector<int> &part, double epsilon, int rounds)
+{
+    int n = g.n;
+    if (n < 2)
+        return false;
+    int min_side = n - max_side_size(n, epsilon);
+    Weight cut = cut_weight_undirected(g, part);
+    bool improved = false;
+
+    for (int round = 0; round < rounds; ++round) {
+        int count[2] = {0, 0};
+        std::vector<int> seeds[2];
+        for (int u = 0; u < n; ++u) {
+            count[part[u]]++;
+            for (auto &e : g.adj[u])
+                if (part[e.to] != part[u]) {
+                    seeds[part[u]].push_back(u);
+                    break;
+                }
+        }
+        if (seeds[0].empty())
+            break;
+
+        std::vector<int> local(n, -1), corridor;
+        for (int side = 0; side < 2; ++side)
+            grow_corridor(g, part, side, seeds[side], corridor_budget(count[side], min_side),
+                          local, corridor);
+        if (corridor.empty())
+            break;
+
+        int c = (int) corridor.size();
+        int s = c, t = c + 1;
+        MaxFlow net(c + 2);
+        for (int i = 0; i < c; ++i)
+            for (auto &e : g.adj[corridor[i]]) {
+                int lv = local[e.to];
+                if (lv >= 0) {
+                    if (i < lv)
+                        net.add_undirected_edge(i, lv, e.w);
+                } else if (part[e.to] == 0) {
+                    net.add_edge(s, i, e.w);
+                } else {
+                    net.add_edge(i, t, e.w);
+                }
+            }
+        net.max_flow(s, t);
+
+        // Both the minimal source side and the minimal sink side are minimum cuts; keep the
+        // better balanced one.
+        auto src = net.source_side(s);
+        auto snk = net.sink_side(t);
+        std::vector<int> a = part, b = part;
+        for (int i = 0; i < c; ++i) {
+            a[corridor[i]] = src[i] ? 0 : 1;
+            b[corridor[i]] = snk[i] ? 1 : 0;
+        }
+        std::vector<int> &next = larger_side(a) <= larger_side(b) ? a : b;
+        Weight next_cut = cut_weight_undirected(g, next);
+        if (next_cut >= cut)
+            break;
+        part = std::move(next);
+        cut = next_cut;
+        improved = true;
+    }
+    return improved;
+}
+
+template<typename Graph>
+bool flow_refine_separator(const Graph &g,
+                           std::vector<int> &part,
+                           std::vector<int> &separator,
+                           double epsilon,
+                           int rounds)
+{
+    int n = g.n;
+    if (n < 3 || separator.empty())
+        return false;
+    int min_side = n - max_side_size(n, epsilon);
+    bool improved = false;
+
+    for (int round = 0; round < rounds; ++round) {
+        std::vector<int> label(part);
+        for (int v : separator)
+            label[v] = 2;
+        int count[3] = {0, 0, 0};
+        for (int l : label)
+            count[l]++;
+        if (count[0] == 0 || count[1] == 0)
+            break;
+
+        std::vector<int> local(n, -1), corridor;
+        for (int v : separator) {
+            local[v] = (int) corridor.size();
+            corridor.push_back(v);
+        }
+        for (int side = 0; side < 2; ++side)
+            grow_corridor(g, label, side, separator, corridor_budget(count[side], min_side),
+                          local, corridor);
+
+        // Vertex-split network: corridor vertex i becomes in=2i -> out=2i+1 with capacity 1.
+        int c = (int) corridor.size();
+        int s = 2 * c, t = 2 * c + 1;
+        const Weight inf = MaxFlow::infinite_capacity;
+        MaxFlow net(2 * c + 2);
+        for (int i = 0; i < c; ++i) {
+            net.add_edge(2 * i, 2 * i + 1, 1);
+            for (auto &e : g.adj[corridor[i]]) {
+                int lv = local[e.to];
+                if (lv >= 0) {
+                    if (lv != i)
+                        net.add_edge(2 * i + 1, 2 * lv, inf);
+                } else if (label[e.to] == 0) {
+                    net.add_edge(s, 2 * i, inf);
+                } else {
+                    net.add_edge(2 * i + 1, t, inf);
+                }
+            }
+        }
+        Weight flow = net.max_flow(s, t);
+        if (flow >= (Weight) separator.size())
+            break;
+
+        auto src = net.source_side(s);
+        auto snk = net.sink_side(t);
+        std::vector<int> a = label, b = label;
+        for (int i = 0; i < c; ++i) {
+            a[corridor[i]] = src[2 * i + 1] ? 0 : (src[2 * i] ? 2 : 1);
+            b[corridor[i]] = snk[2 * i] ? 1 : (snk[2 * i + 1] ? 2 : 0);
+        }
+        std::vector<int> &next = larger_side(a) <= larger_side(b) ? a : b;
+
+        separator.clear();
+        for (int v = 0; v < n; ++v) {
+            if (next[v] == 2)
+                separator.push_back(v);
+            else
+                part[v] = next[v];
+        }
+        improved = true;
+    }
+    return improved;
+}
+
+template<typename Graph>
+void rebalance_bisection(const Graph &g, std::vector<int> &part, int max_side)
+{
+    int n = g.n;
+    int count[2] = {0, 0};
+    for (int p : part)
+        count[p]++;
+    int from = count[0] >= count[1] ? 0 : 1;
+    if (count[from] <= max_side)
+        return;
+
+    std::vector<Weight> gain(n, 0);
+    std::priority_queue<std::pair<Weight, int>> heap;
+    for (int u = 0; u < n; ++u) {
+        if (part[u] != from)
+            continue;
+        for (auto &e : g.adj[u])
+            gain[u] += part[e.to] == from ? -(Weight) e.w : (Weight) e.w;
+        heap.push({gain[u], -u});
+    }
+    while (count[from] > max_side && !heap.empty()) {
+        auto [gu, nu] = heap.top();
+        heap.pop();
+        int u = -nu;
+        if (part[u] != from || gu != gain[u])
+            continue;
+        part[u] = 1 - from;
+        count[from]--;
+        for (auto &e : g.adj[u]) {
+            int v = e.to;
+            if (part[v] != from || v == u)
+                continue;
+            gain[v] += 2 * (Weight) e.w;
+            heap.push({gain[v], -v});
+        }
+    }
+}
+
+template bool flow_refine_bisection(const WeightedGraph &, std::vector<int> &, double, int);
+template bool flow_refine_bisection(const CompactWeightedGraph &, std::vector<int> &, double, int);
+template bool flow_refine_bisection(const UnweightedGraph &, std::vector<int> &, double, int);
+template bool flow_refine_bisection(const CompressedGraph &, std::vector<int> &, double, int);
+template bool flow_refine_separator(
+    const WeightedGraph &, std::vector<int> &, std::vector<int> &, double, int);
+template bool flow_refine_separator(
+    const CompactWeightedGraph &, std::vector<int> &, std::vector<int> &, double, int);
+template bool flow_refine_separator(
+    const UnweightedGraph &, std::vector<int> &, std::vector<int> &, double, int);
+template void rebalance_bisection(const WeightedGraph &, std::vector<int> &, int);
+template void rebalance_bisection(const CompactWeightedGraph &, std::vector<int> &, int);
+template void rebalance_bisection(const UnweightedGraph &, std::vector<int> &, int);
+template void rebalance_bisection(const CompressedGraph &, std::vector<int> &, int);
@@ -0,0 +1,28 @@
+#pragma once
+#include "GraphUtils.h"
+
+// Flow-based improvement of 2-way cuts and vertex separators (FlowCutter-style corridors).
+// Each round grows a corridor of vertices around the current boundary by BFS, contracts the
+// rest of side 0 into a source and the rest of side 1 into a sink, and replaces the corridor's
+// labels by a minimum s-t edge cut (or minimum vertex cut) of that region computed with
+// MaxFlow. Corridor sizes are capped so that every possible outcome keeps both sides at most
+// ceil((1 + epsilon) * n / 2) vertices, provided the input already satisfies that bound.
+
+// part[v] in {0, 1}. Returns true if the cut weight decreased.
+template<typename Graph>
+bool flow_refine_bisection(const Graph &g, std::vector<int> &part, double epsilon, int rounds = 3);
+
+// part[v] in {0, 1} for non-separator vertices; separator lists S with no edge between the two
+// sides outside S. Separator vertices keep their previous part label (or take the side they
+// came from). Returns true if |S| decreased.
+template<typename Graph>
+bool flow_refine_separator(const Graph &g,
+                           std::vector<int> &part,
+                           std::vector<int> &separator,
+                           double epsilon,
+                           int rounds = 3);
+
+// Moves vertices with the best gain (external minus internal weight) from the larger side until
+// both sides of part[] hold at most max_side vertices.
+template<typename Graph>
+void rebalance_bisection(const Graph &g, std::vector<int> &part, int max_side);
@@ -1,11 +1,13 @@
 #include "GlobalMinCutSolver.h"
 
-std::string GlobalMinCutSolver::name() const
+template<typename Graph>
+std::string BasicGlobalMinCutSolver<Graph>::name() const
 {
     return "Global Minimum Cut (Stoer-Wagner)";
 }
 
-std::string GlobalMinCutSolver::statement() const
+template<typename Graph>
+std::string BasicGlobalMinCutSolver<Graph>::statement() const
 {
     return "Input: undirected weighted graph G=(V,E,w).\n"
            "Goal: find a nontrivial cut (A,B) where A is nonempty and A != V, and B = V\\A.\n"
@@ -14,12 +16,14 @@ std::string GlobalMinCutSolver::statement() const
            "Output: part[v] indicates which side of the minimum cut each vertex belongs to.";
 }
 
-std::string GlobalMinCutSolver::complexity() const
+template<typename Graph>
+std::string BasicGlobalMinCutSolver<Graph>::complexity() const
 {
     return "Polynomial: O(n^3) time (dense form), O(nm + n^2 log n) variants exist.";
 }
 
-void GlobalMinCutSolver::solve(const WeightedGraph &g)
+template<typename Graph>
+void BasicGlobalMinCutSolver<Graph>::solve(const Graph &g)
 {
     res_ = {};
     if (g.n == 0)
@@ -49,8 +53,9 @@ void GlobalMinCutSolver::solve(const WeightedGraph &g)
     Weight best = std::numeric_limits<Weight>::max();
     std::vector<int> bestA;
 
+    // Every phase yields a valid cut, so a stopped solve keeps the best one found so far.
     int curN = n;
-    while (curN > 1) {
+    while (curN > 1 && (bestA.empty() || !should_stop(this->control_))) {
         std::vector<Weight> dist(curN, 0);
         std::vector<char> added(curN, 0);
         int prev = -1;
@@ -95,20 +100,24 @@ void GlobalMinCutSolver::solve(const WeightedGraph &g)
 
         vtx.erase(vtx.begin() + t);
         curN--;
+        report_progress(this->control_, "phase", n - curN, best);
     }
 
     res_.part.assign(n, 1);
     for (int v : bestA)
         res_.part[v] = 0;
     res_.cut_weight = best;
+    res_.stopped_early = was_stopped(this->control_);
 }
 
-PartitionResult GlobalMinCutSolver::result() const
+template<typename Graph>
+PartitionResult BasicGlobalMinCutSolver<Graph>::result() const
 {
     return res_;
 }
 
-void GlobalMinCutSolver::print(std::ostream &os) const
+template<typename Graph>
+void BasicGlobalMinCutSolver<Graph>::print(std::ostream &os) const
 {
     os << "\n=== " << name() << " ===\n";
     os << "Problem: " << statement() << "\n";
@@ -121,3 +130,7 @@ void GlobalMinCutSolver::print(std::ostream &os) const
     }
     os << "\n";
 }
+
+template class BasicGlobalMinCutSolver<WeightedGraph>;
+template class BasicGlobalMinCutSolver<CompactWeightedGraph>;
+template class BasicGlobalMinCutSolver<UnweightedGraph>;
@@ -1,16 +1,19 @@
 #pragma once
 #include "GraphPartitionSolver.h"
 
-class GlobalMinCutSolver final : public IGraphPartitionSolver
+template<typename Graph>
+class BasicGlobalMinCutSolver final : public IBasicGraphPartitionSolver<Graph>
 {
 public:
     std::string name() const override;
     std::string statement() const override;
     std::string complexity() const override;
-    void solve(const WeightedGraph &g) override;
+    void solve(const Graph &g) override;
     PartitionResult result() const override;
     void print(std::ostream &os) const override;
 
 private:
     PartitionResult res_;
 };
+
+using GlobalMinCutSolver = BasicGlobalMinCutSolver<WeightedGraph>;
@@ -0,0 +1,206 @@
+#include "GraphFile.h"
+
+namespace {
+
+static const char graph_file_magic[8] = {'G', 'P', 'G', 'R', 'A', 'P', 'H', '1'};
+static const std::size_t graph_file_header = sizeof(graph_file_magic) + 2 * sizeof(std::uint64_t);
+
+template<typename T>
+static void write_pod(std::ofstream &out, const T *data, std::size_t count)
+{
+    out.write((const char *) data, (std::streamsize) (count * sizeof(T)));
+}
+
+template<typename T>
+static void read_pod(std::ifstream &in, T *data, std::size_t count)
+{
+    in.read((char *) data, (std::streamsize) (count * sizeof(T)));
+    if (!in)
+        throw std::runtime_error("graph file truncated");
+}
+} // namespace
+
+template<typename Graph>
+void write_graph_file(const Graph &g, const std::string &path)
+{
+    GraphFileWriter out(path, g.n);
+    std::vector<GraphFileWriter::Edge> row;
+    for (int u = 0; u < g.n; ++u) {
+        row.clear();
+        for (auto &e : g.adj[u])
+            row.push_back({(int) e.to, (Weight) e.w});
+        out.append_row(row.data(), row.size());
+    }
+    out.close();
+}
+
+GraphFileWriter::GraphFileWriter(const std::string &path, int n)
+    : out_(path, std::ios::binary | std::ios::trunc)
+    , n_(n)
+    , offsets_{0}
+{
+    if (!out_)
+        throw std::runtime_error("cannot create graph file " + path);
+    if (n < 0)
+        throw std::invalid_argument("vertex count must be nonnegative");
+    offsets_.reserve((std::size_t) n + 1);
+    // Header and offsets are rewritten by close(); reserve their space now so the arcs can be
+    // streamed out behind them.
+    std::vector<char> zeros(graph_file_header + ((std::size_t) n + 1) * sizeof(std::uint64_t), 0);
+    out_.write(zeros.data(), (std::streamsize) zeros.size());
+}
+
+GraphFileWriter::~GraphFileWriter()
+{
+    if (!closed_) {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+}
+
+void GraphFileWriter::append_row(const Edge *edges, std::size_t count)
+{
+    if ((int) offsets_.size() > n_)
+        throw std::out_of_range("more rows than vertices");
+    for (std::size_t i = 0; i < count; ++i) {
+        if (edges[i].to < 0 || edges[i].to >= n_)
+            throw std::out_of_range("vertex");
+        if (edges[i].w < 0)
+            throw std::invalid_argument("weight must be nonnegative");
+    }
+    write_pod(out_, edges, count);
+    offsets_.push_back(offsets_.back() + count);
+}
+
+void GraphFileWriter::close()
+{
+    if (closed_)
+        return;
+    closed_ = true;
+    if ((int) offsets_.size() != n_ + 1)
+        throw std::logic_error("graph file closed before all rows were written");
+    std::uint64_t header[2] = {(std::uint64_t) n_, offsets_.back()};
+    out_.seekp(0);
+    write_pod(out_, graph_file_magic, sizeof(graph_file_magic));
+    write_pod(out_, header, 2);
+    write_pod(out_, offsets_.data(), offsets_.size());
+    out_.close();
+    if (!out_)
+        throw std::runtime_error("graph file write failed");
+}
+
+long long GraphFileWriter::bytes_written() const
+{
+    return (long long) (graph_file_header + offsets_.size() * sizeof(std::uint64_t)
+                        + offsets_.back() * sizeof(Edge));
+}
+
+GraphFile::Row GraphFile::Rows::operator[](int u) const
+{
+    if (u < file_->block_begin_ || u >= file_->block_end_)
+        file_->load_block(u);
+    const Edge *base = file_->block_.data();
+    std::uint64_t first = file_->block_offsets_[0];
+    std::size_t i = (std::size_t) (u - file_->block_begin_);
+    return Row(base + (file_->block_offsets_[i] - first),
+               base + (file_->block_offsets_[i + 1] - first));
+}
+
+GraphFile::GraphFile(const std::string &path, std::size_t block_bytes)
+    : path_(path)
+    , block_bytes_(std::max<std::size_t>(block_bytes, sizeof(Edge)))
+    , in_(path, std::ios::binary)
+{
+    if (!in_)
+        throw std::runtime_error("cannot open graph file " + path);
+    char magic[sizeof(graph_file_magic)];
+    read_pod(in_, magic, sizeof(magic));
+    if (!std::equal(magic, magic + sizeof(magic), graph_file_magic))
+        throw std::runtime_error("not a graph file: " + path);
+    std::uint64_t header[2];
+    read_pod(in_, header, 2);
+    if (header[0] > (std::uint64_t) std::numeric_limits<int>::max())
+        throw std::runtime_error("graph file has too many vertices");
+    n = (int) header[0];
+    arcs_ = (long long) header[1];
+    adj.file_ = this;
+}
+
+void GraphFile::load_block(int u) const
+{
+    if (u < 0 || u >= n)
+        throw std::out_of_range("vertex");
+    // Offsets first: read them in chunks until the block holds block_bytes of arcs or a
+    // single row that is larger.
+    std::size_t max_arcs = block_bytes_ / sizeof(Edge);
+    std::size_t chunk = std::max<std::size_t>(1, std::min<std::size_t>(max_arcs, 1 << 16));
+    block_offsets_.resize(1);
+    in_.seekg((std::streamoff) (graph_file_header + (std::size_t) u * sizeof(std::uint64_t)));
+    read_pod(in_, block_offsets_.data(), 1);
+    int end = u;
+    while (end < n) {
+        std::size_t count = std::min<std::size_t>(chunk, (std::size_t) (n - end));
+        std::size_t old = block_offsets_.size();
+        block_offsets_.resize(old + count);
+        read_pod(in_, block_offsets_.data() + old, count);
+        std::size_t keep = old;
+        while (keep < old + count
+               && (keep == 1 || block_offsets_[keep] - block_offsets_[0] <= max_arcs))
+            ++keep;
+        block_offsets_.resize(keep);
+        end += (int) (keep - old);
+        if (keep < old + count)
+            break;
+    }
+    bytes_read_ += (long long) (block_offsets_.size() * sizeof(std::uint64_t));
+
+    std::size_t arcs = (std::size_t) (block_offsets_.back() - block_offsets_[0]);
+    block_.resize(arcs);
+    std::size_t arc_base = graph_file_header + ((std::size_t) n + 1) * sizeof(std::uint64_t);
+    in_.seekg((std::streamoff) (arc_base + block_offsets_[0] * sizeof(Edge)));
+    read_pod(in_, block_.data(), arcs);
+    bytes_read_ += (long long) (arcs * sizeof(Edge));
+    block_begin_ = u;
+    block_end_ = end;
+}
+
+long long GraphFile::arc_count() const
+{
+    return arcs_;
+}
+
+std::vector<Weight> GraphFile::degrees() const
+{
+    std::vector<Weight> deg(n, 0);
+    for (int u = 0; u < n; ++u) {
+        Row row = adj[u];
+        deg[u] = kernels::row_weight(row.data(), row.size());
+    }
+    return deg;
+}
+
+WeightedGraph GraphFile::load() const
+{
+    WeightedGraph g(n);
+    for (int u = 0; u < n; ++u) {
+        Row row = adj[u];
+        g.adj[u].assign(row.begin(), row.end());
+    }
+    return g;
+}
+
+long long GraphFile::bytes_read() const
+{
+    return bytes_read_;
+}
+
+std::size_t GraphFile::memory_bytes() const
+{
+    return block_.capacity() * sizeof(Edge) + block_offsets_.capacity() * sizeof(std::uint64_t);
+}
+
+template void write_graph_file(const WeightedGraph &, const std::string &);
+template void write_graph_file(const CompactWeightedGraph &, const std::string &);
+template void write_graph_file(const UnweightedGraph &, const std::string &);
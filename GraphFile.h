@@ -0,0 +1,117 @@
+#pragma once
+#include "GraphUtils.h"
+#include <cstdint>
+#include <fstream>
+
+// Binary on-disk graph: a header (magic "GPGRAPH1", n, arc count), n + 1 row offsets (uint64)
+// and the arcs as WeightedGraph::Edge records (16 bytes each). Every undirected edge is stored
+// in both rows, as in WeightedGraph.
+
+template<typename Graph>
+void write_graph_file(const Graph &g, const std::string &path);
+
+// Writes a graph file row by row. Rows must be appended for vertices 0..n-1 in order; the
+// offsets (8 bytes per vertex) are kept in memory and written by close().
+class GraphFileWriter
+{
+public:
+    using Edge = WeightedGraph::Edge;
+
+    GraphFileWriter(const std::string &path, int n);
+    ~GraphFileWriter();
+
+    void append_row(const Edge *edges, std::size_t count);
+    void close();
+    long long bytes_written() const;
+
+private:
+    std::ofstream out_;
+    int n_;
+    std::vector<std::uint64_t> offsets_;
+    bool closed_ = false;
+};
+
+// Read-only graph backed by a graph file. adj[u] loads the block of rows containing u (at most
+// block_bytes of arcs, at least one row) and returns a view into it, so row pointers stay valid
+// only until the next adj[] call. Scans in increasing vertex order read the file sequentially;
+// any order works. Satisfies the same read interface as WeightedGraph (n, adj[u], degrees(),
+// Edge, coarse_graph), so streamed passes such as cut_weight_undirected and
+// refine_kway_partition run on it directly. Not thread-safe.
+class GraphFile
+{
+public:
+    using vertex_type = int;
+    using weight_type = Weight;
+    using Edge = WeightedGraph::Edge;
+    using coarse_graph = WeightedGraph;
+    static constexpr bool is_weighted = true;
+
+    class Row
+    {
+    public:
+        Row(const Edge *begin, const Edge *end)
+            : begin_(begin)
+            , end_(end)
+        {}
+        const Edge *begin() const
+        {
+            return begin_;
+        }
+        const Edge *end() const
+        {
+            return end_;
+        }
+        const Edge *data() const
+        {
+            return begin_;
+        }
+        std::size_t size() const
+        {
+            return (std::size_t) (end_ - begin_);
+        }
+
+    private:
+        const Edge *begin_;
+        const Edge *end_;
+    };
+
+    class Rows
+    {
+    public:
+        Row operator[](int u) const;
+
+    private:
+        friend class GraphFile;
+        GraphFile *file_ = nullptr;
+    };
+
+    int n = 0;
+    Rows adj;
+
+    explicit GraphFile(const std::string &path, std::size_t block_bytes = 1 << 24);
+    GraphFile(const GraphFile &) = delete;
+    GraphFile &operator=(const GraphFile &) = delete;
+
+    long long arc_count() const;
+    // One sequential pass over the file.
+    std::vector<Weight> degrees() const;
+    // Reads the whole graph into memory.
+    WeightedGraph load() const;
+    // Bytes read from the file so far (header excluded).
+    long long bytes_read() const;
+    // Bytes held by the cached block (arcs and offsets).
+    std::size_t memory_bytes() const;
+
+private:
+    void load_block(int u) const;
+
+    std::string path_;
+    std::size_t block_bytes_;
+    long long arcs_ = 0;
+    mutable std::ifstream in_;
+    // Rows [block_begin_, block_end_) are cached: offsets in block_offsets_, arcs in block_.
+    mutable int block_begin_ = 0, block_end_ = 0;
+    mutable std::vector<std::uint64_t> block_offsets_;
+    mutable std::vector<Edge> block_;
+    mutable long long bytes_read_ = 0;
+};
@@ -0,0 +1,334 @@
+#include "GraphIO.h"
+#include "GraphFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+static const char graph_file_magic[8] = {'G', 'P', 'G', 'R', 'A', 'P', 'H', '1'};
+
+static std::runtime_error
+parse_error(const std::string &source, long long line, const std::string &what)
+{
+    return std::runtime_error(source + ":" + std::to_string(line) + ": " + what);
+}
+
+static bool is_blank(const std::string &line)
+{
+    return line.find_first_not_of(" \t\r") == std::string::npos;
+}
+
+// Splits a line into integers; returns false on a token that is not one.
+static bool parse_integers(const std::string &line, std::vector<long long> &out)
+{
+    out.clear();
+    const char *p = line.c_str();
+    for (;;) {
+        while (*p == ' ' || *p == '\t' || *p == '\r')
+            ++p;
+        if (!*p)
+            return true;
+        char *end = nullptr;
+        errno = 0;
+        long long value = std::strtoll(p, &end, 10);
+        if (end == p || errno == ERANGE || (*end && *end != ' ' && *end != '\t' && *end != '\r'))
+            return false;
+        out.push_back(value);
+        p = end;
+    }
+}
+
+// Every u -> v entry needs a v -> u entry of the same weight, as often as it is listed. Rows
+// are compared as (neighbor, weight) multisets; the first row, in file order, with an entry
+// its neighbor does not repeat is reported.
+static void check_metis_symmetry(const WeightedGraph &g,
+                                 const std::vector<long long> &row_line,
+                                 const std::string &source)
+{
+    std::vector<std::vector<std::pair<int, Weight>>> sorted(g.n);
+    for (int u = 0; u < g.n; ++u) {
+        for (auto &e : g.adj[u])
+            sorted[u].push_back({e.to, e.w});
+        std::sort(sorted[u].begin(), sorted[u].end());
+    }
+    for (int u = 0; u < g.n; ++u) {
+        const auto &row = sorted[u];
+        for (std::size_t i = 0, j = 0; i < row.size(); i = j) {
+            while (j < row.size() && row[j] == row[i])
+                ++j;
+            int v = row[i].first;
+            Weight w = row[i].second;
+            auto back = std::equal_range(
+                sorted[v].begin(), sorted[v].end(), std::pair<int, Weight>{u, w});
+            if (back.second - back.first < (std::ptrdiff_t) (j - i))
+                throw parse_error(source,
+                                  row_line[u],
+                                  "vertex " + std::to_string(u + 1) + " lists neighbor "
+                                      + std::to_string(v + 1) + " with weight "
+                                      + std::to_string(w) + " but vertex "
+                                      + std::to_string(v + 1) + " (line "
+                                      + std::to_string(row_line[v])
+                                      + ") does not list it back with that weight");
+        }
+    }
+}
+
+static bool ends_with(const std::string &s, const char *suffix)
+{
+    std::size_t len = std::strlen(suffix);
+    return s.size() >= len && s.compare(s.size() - len, len, suffix) == 0;
+}
+
+} // namespace
+
+GraphFormat parse_graph_format(const std::string &name)
+{
+    if (name == "auto")
+        return GraphFormat::Auto;
+    if (name == "metis")
+        return GraphFormat::Metis;
+    if (name == "edges")
+        return GraphFormat::EdgeList;
+    if (name == "binary")
+        return GraphFormat::Binary;
+    throw std::invalid_argument("unknown graph format " + name);
+}
+
+std::string graph_format_name(GraphFormat format)
+{
+    switch (format) {
+    case GraphFormat::Auto:
+        return "auto";
+    case GraphFormat::Metis:
+        return "metis";
+    case GraphFormat::EdgeList:
+        return "edges";
+    case GraphFormat::Binary:
+        return "binary";
+    }
+    return "unknown";
+}
+
+GraphInput read_metis_graph(std::istream &in, const std::string &source)
+{
+    std::string line;
+    long long line_no = 0;
+    auto next_line = [&] {
+        while (std::getline(in, line)) {
+            ++line_no;
+            if (line.empty() || line[0] != '%')
+                return true;
+        }
+        return false;
+    };
+
+    std::vector<long long> values;
+    do {
+        if (!next_line())
+            throw parse_error(source, line_no, "missing METIS header");
+    } while (is_blank(line));
+    if (!parse_integers(line, values) || values.size() < 2 || values.size() > 4)
+        throw parse_error(source, line_no, "header must be \"n m [fmt [ncon]]\"");
+    long long n = values[0], m = values[1];
+    long long fmt = values.size() > 2 ? values[2] : 0;
+    long long ncon = values.size() > 3 ? values[3] : 0;
+    if (n < 0 || n > std::numeric_limits<int>::max() || m < 0 || ncon < 0)
+        throw parse_error(source, line_no, "vertex or edge count out of range");
+    if (fmt < 0 || fmt > 111 || fmt % 10 > 1 || fmt / 10 % 10 > 1)
+        throw parse_error(source, line_no, "unsupported fmt " + std::to_string(fmt));
+    bool edge_weights = fmt % 10 == 1;
+    bool has_sizes = fmt / 100 == 1;
+    if (fmt / 10 % 10 == 1 && ncon == 0)
+        ncon = 1;
+
+    GraphInput out;
+    out.format = GraphFormat::Metis;
+    out.graph = WeightedGraph((int) n);
+    if (ncon > 0)
+        out.vertex_weights.assign((std::size_t) n, 0);
+    long long arcs = 0;
+    std::vector<long long> row_line((std::size_t) n);
+    for (int u = 0; u < (int) n; ++u) {
+        if (!next_line())
+            throw parse_error(source,
+                              line_no,
+                              "expected " + std::to_string(n) + " vertex lines, found "
+                                  + std::to_string(u));
+        if (!parse_integers(line, values))
+            throw parse_error(source, line_no, "expected integers");
+        row_line[u] = line_no;
+        std::size_t i = 0;
+        if (has_sizes)
+            i++;
+        // Only the first balance constraint is kept.
+        if (ncon > 0) {
+            if ((long long) values.size() < (long long) i + ncon)
+                throw parse_error(source, line_no, "missing vertex weight");
+            if (values[i] < 0)
+                throw parse_error(source, line_no, "negative vertex weight");
+            out.vertex_weights[u] = values[i];
+            i += ncon;
+        }
+        if (edge_weights && (values.size() - i) % 2 != 0)
+            throw parse_error(source, line_no, "neighbor without edge weight");
+        auto &row = out.graph.adj[u];
+        for (; i < values.size(); i += edge_weights ? 2 : 1) {
+            long long v = values[i];
+            Weight w = edge_weights ? values[i + 1] : 1;
+            if (v < 1 || v > n)
+                throw parse_error(
+                    source, line_no, "neighbor " + std::to_string(v) + " out of range");
+            if (w < 0)
+                throw parse_error(source, line_no, "negative edge weight");
+            arcs++;
+            if (v - 1 != u)
+                row.push_back({(int) (v - 1), w});
+        }
+    }
+    check_metis_symmetry(out.graph, row_line, source);
+    if (arcs != 2 * m)
+        throw parse_error(source,
+                          line_no,
+                          "header announces " + std::to_string(m) + " edges, rows list "
+                              + std::to_string(arcs) + " arcs");
+    return out;
+}
+
+WeightedGraph read_edge_list(std::istream &in, const std::string &source)
+{
+    struct EdgeRecord
+    {
+        int u, v;
+        Weight w;
+    };
+    std::vector<EdgeRecord> edges;
+    std::vector<long long> values;
+    std::string line;
+    long long line_no = 0;
+    int n = 0;
+    while (std::getline(in, line)) {
+        ++line_no;
+        if (is_blank(line) || line[0] == '#' || line[0] == '%')
+            continue;
+        if (!parse_integers(line, values) || values.size() < 2 || values.size() > 3)
+            throw parse_error(source, line_no, "expected \"u v [w]\"");
+        if (values[0] < 0 || values[1] < 0 || values[0] >= std::numeric_limits<int>::max()
+            || values[1] >= std::numeric_limits<int>::max())
+            throw parse_error(source, line_no, "vertex id out of range");
+        Weight w = values.size() > 2 ? values[2] : 1;
+        if (w < 0)
+            throw parse_error(source, line_no, "negative edge weight");
+        n = std::max(n, (int) std::max(values[0], values[1]) + 1);
+        if (values[0] != values[1])
+            edges.push_back({(int) values[0], (int) values[1], w});
+    }
+    WeightedGraph g(n);
+    for (auto &e : edges)
+        g.add_undirected(e.u, e.v, e.w);
+    return g;
+}
+
+GraphFormat detect_graph_format(const std::string &path)
+{
+    std::ifstream probe(path, std::ios::binary);
+    if (!probe)
+        throw std::runtime_error("cannot open graph " + path);
+    char magic[sizeof(graph_file_magic)] = {};
+    probe.read(magic, sizeof(magic));
+    if (probe.gcount() == (std::streamsize) sizeof(magic)
+        && std::memcmp(magic, graph_file_magic, sizeof(magic)) == 0)
+        return GraphFormat::Binary;
+    if (ends_with(path, ".graph") || ends_with(path, ".metis"))
+        return GraphFormat::Metis;
+    return GraphFormat::EdgeList;
+}
+
+GraphInput read_graph(const std::string &path, GraphFormat format)
+{
+    if (format == GraphFormat::Auto)
+        format = detect_graph_format(path);
+
+    GraphInput out;
+    if (format == GraphFormat::Binary) {
+        out.graph = GraphFile(path).load();
+        out.format = format;
+        return out;
+    }
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("cannot open graph " + path);
+    if (format == GraphFormat::Metis)
+        return read_metis_graph(in, path);
+    out.graph = read_edge_list(in, path);
+    out.format = GraphFormat::EdgeList;
+    return out;
+}
+
+void write_metis_graph(std::ostream &out,
+                       const WeightedGraph &g,
+                       const std::vector<Weight> &vertex_weights)
+{
+    if (!vertex_weights.empty() && (int) vertex_weights.size() != g.n)
+        throw std::invalid_argument("vertex_weights must have one entry per vertex");
+    long long arcs = 0;
+    for (int u = 0; u < g.n; ++u)
+        for (auto &e : g.adj[u])
+            arcs += e.to != u;
+    out << g.n << " " << arcs / 2 << " " << (vertex_weights.empty() ? "1" : "11") << "\n";
+    for (int u = 0; u < g.n; ++u) {
+        bool first = true;
+        if (!vertex_weights.empty()) {
+            out << vertex_weights[u];
+            first = false;
+        }
+        for (auto &e : g.adj[u]) {
+            if (e.to == u)
+                continue;
+            out << (first ? "" : " ") << e.to + 1 << " " << e.w;
+            first = false;
+        }
+        out << "\n";
+    }
+}
+
+void write_partition(const std::string &path, const std::vector<int> &part)
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("cannot create partition file " + path);
+    std::string buf;
+    for (int p : part) {
+        buf += std::to_string(p);
+        buf += '\n';
+        if (buf.size() >= (1 << 16)) {
+            out << buf;
+            buf.clear();
+        }
+    }
+    out << buf;
+    if (!out)
+        throw std::runtime_error("partition file write failed: " + path);
+}
+
+std::vector<int> read_partition(const std::string &path)
+{
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("cannot open partition file " + path);
+    std::vector<int> part;
+    std::vector<long long> values;
+    std::string line;
+    long long line_no = 0;
+    while (std::getline(in, line)) {
+        ++line_no;
+        if (is_blank(line))
+            continue;
+        if (!parse_integers(line, values) || values.size() != 1 || values[0] < -1
+            || values[0] > std::numeric_limits<int>::max())
+            throw parse_error(path, line_no, "expected one block per line");
+        part.push_back((int) values[0]);
+    }
+    return part;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "GraphUtils.h"
+#include <istream>
+#include <ostream>
+
+// Text graph formats and partition files.
+//   - METIS: header "n m [fmt [ncon]]", then one line per vertex listing its neighbors
+//     (1-based), each followed by the edge weight if fmt ends in 1; with fmt 1x (or ncon > 0)
+//     the line starts with the vertex weight, with fmt 1xx with the vertex size (ignored).
+//     Lines starting with '%' are comments. Every edge appears in both rows.
+//   - edge list: one "u v [w]" line per undirected edge, 0-based ids, weight 1 if omitted;
+//     n is the largest id plus one. Lines starting with '#' or '%' are comments and self
+//     loops are dropped, since no partition cuts them.
+//   - binary: the GraphFile format (GraphFile.h).
+enum class GraphFormat {
+    Auto,     // binary if the file starts with the graph file magic, METIS for .graph/.metis
+    Metis,    // METIS / Chaco adjacency format
+    EdgeList, // whitespace-separated edge list
+    Binary    // write_graph_file output
+};
+
+// "auto", "metis", "edges" or "binary". Throws std::invalid_argument for anything else.
+GraphFormat parse_graph_format(const std::string &name);
+std::string graph_format_name(GraphFormat format);
+
+struct GraphInput
+{
+    WeightedGraph graph;
+    // Empty unless the file carries vertex weights (METIS fmt 1x).
+    std::vector<Weight> vertex_weights;
+    // The format actually read (never Auto).
+    GraphFormat format = GraphFormat::Metis;
+};
+
+// Format of the file at path as GraphFormat::Auto resolves it. Throws std::runtime_error if
+// the file cannot be opened.
+GraphFormat detect_graph_format(const std::string &path);
+
+// Reads a graph file. Malformed input throws std::runtime_error naming the file and line.
+GraphInput read_graph(const std::string &path, GraphFormat format = GraphFormat::Auto);
+// METIS rows must be symmetric: each u -> v entry needs a v -> u entry of the same weight.
+GraphInput read_metis_graph(std::istream &in, const std::string &source = "input");
+WeightedGraph read_edge_list(std::istream &in, const std::string &source = "input");
+
+// METIS output, with edge weights and, if given, vertex weights.
+void write_metis_graph(std::ostream &out,
+                       const WeightedGraph &g,
+                       const std::vector<Weight> &vertex_weights = {});
+
+// Partition files hold one block per line, vertex 0 first (the METIS .part format).
+void write_partition(const std::string &path, const std::vector<int> &part);
+std::vector<int> read_partition(const std::string &path);
@@ -0,0 +1,402 @@
+#include "GraphKernels.h"
+#include "GraphUtils.h"
+#include <cstddef>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define GRAPH_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace kernels {
+namespace {
+
+template<typename W>
+using Edge = GraphEdge<int, W>;
+
+template<typename W>
+constexpr bool is_unit = std::is_same<W, Unweighted>::value;
+
+// Distance between consecutive edge targets, in ints.
+template<typename W>
+constexpr int edge_stride = (int) (sizeof(Edge<W>) / sizeof(int));
+
+static_assert(sizeof(Edge<Weight>) == 16, "unexpected edge layout");
+static_assert(sizeof(Edge<int>) == 8, "unexpected edge layout");
+static_assert(sizeof(Edge<Unweighted>) == 4, "unexpected edge layout");
+
+template<typename W>
+Weight row_weight_scalar(const Edge<W> *e, std::size_t cnt)
+{
+    if constexpr (is_unit<W>)
+        return (Weight) cnt;
+    Weight s = 0;
+    for (std::size_t i = 0; i < cnt; ++i)
+        s += e[i].w;
+    return s;
+}
+
+// Sum of e[i].w over edges with e[i].to > min_to and (labels[e[i].to] == label) == equal.
+template<typename W>
+Weight select_sum_scalar(
+    const Edge<W> *e, std::size_t cnt, const int *labels, int label, bool equal, int min_to)
+{
+    Weight s = 0;
+    for (std::size_t i = 0; i < cnt; ++i) {
+        int v = e[i].to;
+        if (v > min_to && (labels[v] == label) == equal)
+            s += e[i].w;
+    }
+    return s;
+}
+
+template<typename W>
+void block_weights_scalar(const Edge<W> *e, std::size_t cnt, const int *part, int k, Weight *acc)
+{
+    for (std::size_t i = 0; i < cnt; ++i) {
+        int q = part[e[i].to];
+        if (q >= 0 && q < k)
+            acc[q] += e[i].w;
+    }
+}
+
+#ifdef GRAPH_KERNELS_X86
+
+// GCC's AVX-512 intrinsics self-initialize their "undefined" passthrough operands, which trips
+// the uninitialized-value warnings once they are inlined.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// ---- AVX2: 8 edges per iteration.
+//
+// Edges are loaded with plain vector loads and de-interleaved with permutes, so lane j always
+// holds edge j. Weights are widened to two 4 x int64 halves (edges 0-3 and 4-7).
+
+struct EdgeBlockAvx2
+{
+    __m256i to;
+    __m256i w_lo;
+    __m256i w_hi;
+};
+
+template<typename W>
+__attribute__((target("avx2"))) inline EdgeBlockAvx2 load_edges_avx2(const Edge<W> *e)
+{
+    const __m256i *p = reinterpret_cast<const __m256i *>(e);
+    EdgeBlockAvx2 b;
+    if constexpr (edge_stride<W> == 1) {
+        b.to = _mm256_loadu_si256(p);
+    } else if constexpr (edge_stride<W> == 2) {
+        // [t0 w0 t1 w1 t2 w2 t3 w3] -> [t0 t1 t2 t3 w0 w1 w2 w3]
+        const __m256i split = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+        __m256i a = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(p), split);
+        __m256i c = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(p + 1), split);
+        b.to = _mm256_permute2x128_si256(a, c, 0x20);
+        __m256i w = _mm256_permute2x128_si256(a, c, 0x31);
+        b.w_lo = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(w));
+        b.w_hi = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(w, 1));
+    } else {
+        // Each register holds two edges: [t pad w w | t pad w w].
+        __m256i r0 = _mm256_loadu_si256(p), r1 = _mm256_loadu_si256(p + 1);
+        __m256i r2 = _mm256_loadu_si256(p + 2), r3 = _mm256_loadu_si256(p + 3);
+        const __m256i pick = _mm256_setr_epi32(0, 4, 0, 4, 0, 4, 0, 4);
+        __m256i to = _mm256_permutevar8x32_epi32(r0, pick);
+        to = _mm256_blend_epi32(to, _mm256_permutevar8x32_epi32(r1, pick), 0x0C);
+        to = _mm256_blend_epi32(to, _mm256_permutevar8x32_epi32(r2, pick), 0x30);
+        b.to = _mm256_blend_epi32(to, _mm256_permutevar8x32_epi32(r3, pick), 0xC0);
+        b.w_lo = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(r0, r1), 0xD8);
+        b.w_hi = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(r2, r3), 0xD8);
+    }
+    return b;
+}
+
+__attribute__((target("avx2"))) inline Weight hsum_epi64_avx2(__m256i v)
+{
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return (Weight) _mm_cvtsi128_si64(s) + (Weight) _mm_extract_epi64(s, 1);
+}
+
+// Adds the weights of the edges whose 32-bit lane in m is all-ones.
+template<typename W>
+__attribute__((target("avx2"))) inline void add_masked_avx2(const EdgeBlockAvx2 &b,
+                                                            __m256i m,
+                                                            __m256i &acc,
+                                                            Weight &count)
+{
+    if constexpr (is_unit<W>) {
+        count += __builtin_popcount((unsigned) _mm256_movemask_ps(_mm256_castsi256_ps(m)));
+    } else {
+        __m256i m_lo = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(m));
+        __m256i m_hi = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(m, 1));
+        acc = _mm256_add_epi64(acc, _mm256_and_si256(b.w_lo, m_lo));
+        acc = _mm256_add_epi64(acc, _mm256_and_si256(b.w_hi, m_hi));
+    }
+}
+
+template<typename W>
+__attribute__((target("avx2"))) Weight row_weight_avx2(const Edge<W> *e, std::size_t cnt)
+{
+    if constexpr (is_unit<W>) {
+        return (Weight) cnt;
+    } else {
+        __m256i acc = _mm256_setzero_si256();
+        std::size_t i = 0;
+        for (; i + 8 <= cnt; i += 8) {
+            EdgeBlockAvx2 b = load_edges_avx2<W>(e + i);
+            acc = _mm256_add_epi64(acc, _mm256_add_epi64(b.w_lo, b.w_hi));
+        }
+        return hsum_epi64_avx2(acc) + row_weight_scalar(e + i, cnt - i);
+    }
+}
+
+template<typename W>
+__attribute__((target("avx2"))) Weight select_sum_avx2(
+    const Edge<W> *e, std::size_t cnt, const int *labels, int label, bool equal, int min_to)
+{
+    const __m256i lab = _mm256_set1_epi32(label);
+    const __m256i lo = _mm256_set1_epi32(min_to);
+    const __m256i flip = equal ? _mm256_setzero_si256() : _mm256_set1_epi32(-1);
+    __m256i acc = _mm256_setzero_si256();
+    Weight count = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= cnt; i += 8) {
+        EdgeBlockAvx2 b = load_edges_avx2<W>(e + i);
+        __m256i m = _mm256_cmpgt_epi32(b.to, lo);
+        __m256i lv = _mm256_mask_i32gather_epi32(lab, labels, b.to, m, 4);
+        m = _mm256_and_si256(m, _mm256_xor_si256(_mm256_cmpeq_epi32(lv, lab), flip));
+        add_masked_avx2<W>(b, m, acc, count);
+    }
+    return count + hsum_epi64_avx2(acc)
+           + select_sum_scalar(e + i, cnt - i, labels, label, equal, min_to);
+}
+
+// ---- AVX-512: 16 edges per iteration, same lane order as above.
+
+struct EdgeBlockAvx512
+{
+    __m512i to;
+    __m512i w_lo;
+    __m512i w_hi;
+};
+
+template<typename W>
+__attribute__((target("avx512f"))) inline EdgeBlockAvx512 load_edges_avx512(const Edge<W> *e)
+{
+    const int *p = reinterpret_cast<const int *>(e);
+    EdgeBlockAvx512 b;
+    if constexpr (edge_stride<W> == 1) {
+        b.to = _mm512_loadu_si512(p);
+    } else if constexpr (edge_stride<W> == 2) {
+        const __m512i even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14,
+                                               16, 18, 20, 22, 24, 26, 28, 30);
+        const __m512i odd = _mm512_add_epi32(even, _mm512_set1_epi32(1));
+        __m512i a = _mm512_loadu_si512(p), c = _mm512_loadu_si512(p + 16);
+        b.to = _mm512_permutex2var_epi32(a, even, c);
+        __m512i w = _mm512_permutex2var_epi32(a, odd, c);
+        b.w_lo = _mm512_cvtepi32_epi64(_mm512_castsi512_si256(w));
+        b.w_hi = _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(w, 1));
+    } else {
+        // Each register holds four edges; targets sit at int 4j, weights at int64 2j+1.
+        const __m512i pick_to = _mm512_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28,
+                                                  0, 4, 8, 12, 16, 20, 24, 28);
+        const __m512i pick_w = _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15);
+        __m512i r0 = _mm512_loadu_si512(p), r1 = _mm512_loadu_si512(p + 16);
+        __m512i r2 = _mm512_loadu_si512(p + 32), r3 = _mm512_loadu_si512(p + 48);
+        __m512i t_lo = _mm512_permutex2var_epi32(r0, pick_to, r1);
+        __m512i t_hi = _mm512_permutex2var_epi32(r2, pick_to, r3);
+        b.to = _mm512_inserti64x4(t_lo, _mm512_castsi512_si256(t_hi), 1);
+        b.w_lo = _mm512_permutex2var_epi64(r0, pick_w, r1);
+        b.w_hi = _mm512_permutex2var_epi64(r2, pick_w, r3);
+    }
+    return b;
+}
+
+template<typename W>
+__attribute__((target("avx512f"))) inline void add_masked_avx512(const EdgeBlockAvx512 &b,
+                                                                 __mmask16 m,
+                                                                 __m512i &acc,
+                                                                 Weight &count)
+{
+    if constexpr (is_unit<W>) {
+        count += __builtin_popcount((unsigned) m);
+    } else {
+        acc = _mm512_mask_add_epi64(acc, (__mmask8) m, acc, b.w_lo);
+        acc = _mm512_mask_add_epi64(acc, (__mmask8) (m >> 8), acc, b.w_hi);
+    }
+}
+
+template<typename W>
+__attribute__((target("avx512f"))) Weight row_weight_avx512(const Edge<W> *e, std::size_t cnt)
+{
+    if constexpr (is_unit<W>) {
+        return (Weight) cnt;
+    } else {
+        __m512i acc = _mm512_setzero_si512();
+        std::size_t i = 0;
+        for (; i + 16 <= cnt; i += 16) {
+            EdgeBlockAvx512 b = load_edges_avx512<W>(e + i);
+            acc = _mm512_add_epi64(acc, _mm512_add_epi64(b.w_lo, b.w_hi));
+        }
+        return _mm512_reduce_add_epi64(acc) + row_weight_scalar(e + i, cnt - i);
+    }
+}
+
+template<typename W>
+__attribute__((target("avx512f"))) Weight select_sum_avx512(
+    const Edge<W> *e, std::size_t cnt, const int *labels, int label, bool equal, int min_to)
+{
+    const __m512i lab = _mm512_set1_epi32(label);
+    const __m512i lo = _mm512_set1_epi32(min_to);
+    __m512i acc = _mm512_setzero_si512();
+    Weight count = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= cnt; i += 16) {
+        EdgeBlockAvx512 b = load_edges_avx512<W>(e + i);
+        __mmask16 m = _mm512_cmpgt_epi32_mask(b.to, lo);
+        __m512i lv = _mm512_mask_i32gather_epi32(lab, m, b.to, labels, 4);
+        m = equal ? _mm512_mask_cmpeq_epi32_mask(m, lv, lab)
+                  : _mm512_mask_cmpneq_epi32_mask(m, lv, lab);
+        add_masked_avx512<W>(b, m, acc, count);
+    }
+    return count + _mm512_reduce_add_epi64(acc)
+           + select_sum_scalar(e + i, cnt - i, labels, label, equal, min_to);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+Isa detect_isa()
+{
+#ifdef GRAPH_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return Isa::Avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return Isa::Avx2;
+#endif
+    return Isa::Scalar;
+}
+
+// Fastest measured instruction set the CPU supports (benchmarks/KernelBenchmark.cpp): AVX-512
+// runs the cut and label sums slower than AVX2, so it is only used when selected explicitly.
+Isa default_isa()
+{
+    return detected_isa() == Isa::Avx512 ? Isa::Avx2 : detected_isa();
+}
+
+Isa &current_isa()
+{
+    static Isa isa = default_isa();
+    return isa;
+}
+
+template<typename W>
+Weight select_sum(
+    const Edge<W> *e, std::size_t cnt, const int *labels, int label, bool equal, int min_to)
+{
+    switch (current_isa()) {
+#ifdef GRAPH_KERNELS_X86
+    case Isa::Avx512:
+        return select_sum_avx512(e, cnt, labels, label, equal, min_to);
+    case Isa::Avx2:
+        return select_sum_avx2(e, cnt, labels, label, equal, min_to);
+#endif
+    default:
+        return select_sum_scalar(e, cnt, labels, label, equal, min_to);
+    }
+}
+} // namespace
+
+Isa detected_isa()
+{
+    static const Isa isa = detect_isa();
+    return isa;
+}
+
+Isa active_isa()
+{
+    return current_isa();
+}
+
+void set_isa(Isa isa)
+{
+    if ((int) isa > (int) detected_isa())
+        throw std::invalid_argument(std::string("instruction set not supported: ")
+                                    + isa_name(isa));
+    current_isa() = isa;
+}
+
+const char *isa_name(Isa isa)
+{
+    switch (isa) {
+    case Isa::Avx512:
+        return "avx512";
+    case Isa::Avx2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+template<typename W>
+Weight row_weight(const GraphEdge<int, W> *e, std::size_t cnt)
+{
+    // 16-byte edges leave one weight per 128-bit lane after de-interleaving; the vector sum
+    // measured slower than the scalar loop there.
+    if constexpr (std::is_same<W, Weight>::value)
+        return row_weight_scalar(e, cnt);
+    switch (current_isa()) {
+#ifdef GRAPH_KERNELS_X86
+    case Isa::Avx512:
+        return row_weight_avx512(e, cnt);
+    case Isa::Avx2:
+        return row_weight_avx2(e, cnt);
+#endif
+    default:
+        return row_weight_scalar(e, cnt);
+    }
+}
+
+template<typename W>
+Weight row_cut(const GraphEdge<int, W> *e, std::size_t cnt, const int *part, int u)
+{
+    return select_sum(e, cnt, part, part[u], false, u);
+}
+
+template<typename W>
+Weight row_label_weight(const GraphEdge<int, W> *e, std::size_t cnt, const int *labels, int label)
+{
+    return select_sum(e, cnt, labels, label, true, std::numeric_limits<int>::min());
+}
+
+template<typename W>
+void row_block_weights(
+    const GraphEdge<int, W> *e, std::size_t cnt, const int *part, int k, Weight *acc)
+{
+    // The scatter into acc dominates; gathering labels with AVX2/AVX-512 first measured
+    // slower than the scalar loop (benchmarks/KernelBenchmark.cpp), so all ISAs share it.
+    block_weights_scalar(e, cnt, part, k, acc);
+}
+
+#define GRAPH_KERNELS_INSTANTIATE(W) \
+    template Weight row_weight<W>(const GraphEdge<int, W> *, std::size_t); \
+    template Weight row_cut<W>(const GraphEdge<int, W> *, std::size_t, const int *, int); \
+    template Weight row_label_weight<W>(const GraphEdge<int, W> *, std::size_t, const int *, int); \
+    template void row_block_weights<W>(const GraphEdge<int, W> *, \
+                                       std::size_t, \
+                                       const int *, \
+                                       int, \
+                                       Weight *);
+
+GRAPH_KERNELS_INSTANTIATE(Weight)
+GRAPH_KERNELS_INSTANTIATE(int)
+GRAPH_KERNELS_INSTANTIATE(Unweighted)
+
+#undef GRAPH_KERNELS_INSTANTIATE
+
+} // namespace kernels
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+
+using Weight = long long;
+
+struct Unweighted;
+template<typename VertexId, typename W>
+struct GraphEdge;
+
+// Reductions over one adjacency row, i.e. a contiguous array of GraphEdge<int, W>. The kernels
+// have scalar, AVX2 and AVX-512 implementations, picked at runtime; the default is the fastest
+// measured one the CPU supports (AVX2 over AVX-512). Results are bit-identical across
+// implementations (all sums are integer sums).
+namespace kernels {
+
+enum class Isa { Scalar, Avx2, Avx512 };
+
+// Widest instruction set supported by the running CPU.
+Isa detected_isa();
+// Instruction set currently used by the kernels: AVX2 if supported, else detected_isa().
+Isa active_isa();
+// Selects the instruction set, e.g. for benchmarking. Throws std::invalid_argument if the CPU
+// does not support isa. Not thread-safe.
+void set_isa(Isa isa);
+const char *isa_name(Isa isa);
+
+template<typename Edge>
+struct has_row_kernels : std::false_type
+{};
+template<>
+struct has_row_kernels<GraphEdge<int, Weight>> : std::true_type
+{};
+template<>
+struct has_row_kernels<GraphEdge<int, int>> : std::true_type
+{};
+template<>
+struct has_row_kernels<GraphEdge<int, Unweighted>> : std::true_type
+{};
+
+// Sum of e[i].w. Scalar on every ISA for 64-bit weights.
+template<typename W>
+Weight row_weight(const GraphEdge<int, W> *e, std::size_t cnt);
+
+// Sum of e[i].w over edges with e[i].to > u and part[e[i].to] != part[u]; summing this over all
+// rows u counts every cut edge exactly once.
+template<typename W>
+Weight row_cut(const GraphEdge<int, W> *e, std::size_t cnt, const int *part, int u);
+
+// Sum of e[i].w over edges with labels[e[i].to] == label.
+template<typename W>
+Weight row_label_weight(const GraphEdge<int, W> *e,
+                        std::size_t cnt,
+                        const int *labels,
+                        int label);
+
+// acc[part[e[i].to]] += e[i].w for every neighbor whose label lies in [0, k). Scalar on every
+// ISA: the loop is bound by the scatter into acc, which vector gathers do not speed up.
+template<typename W>
+void row_block_weights(const GraphEdge<int, W> *e,
+                       std::size_t cnt,
+                       const int *part,
+                       int k,
+                       Weight *acc);
+
+} // namespace kernels
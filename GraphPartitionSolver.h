@@ -1,13 +1,35 @@
 #pragma once
 #include "GraphUtils.h"
-class IGraphPartitionSolver
+#include "SolveControl.h"
+
+template<typename Graph>
+class IBasicGraphPartitionSolver
 {
 public:
-    virtual ~IGraphPartitionSolver() = default;
+    using graph_type = Graph;
+
+    virtual ~IBasicGraphPartitionSolver() = default;
     virtual std::string name() const = 0;
     virtual std::string statement() const = 0;
     virtual std::string complexity() const = 0;
-    virtual void solve(const WeightedGraph &g) = 0;
+    virtual void solve(const Graph &g) = 0;
     virtual PartitionResult result() const = 0;
     virtual void print(std::ostream &os) const = 0;
+
+    // Attaches a solve control (deadline, cancellation, progress) to the following solve()
+    // calls; nullptr detaches it. It must outlive those calls. Solvers that cannot stop early
+    // ignore it.
+    void set_control(const SolveControl *control)
+    {
+        control_ = control;
+    }
+    const SolveControl *control() const
+    {
+        return control_;
+    }
+
+protected:
+    const SolveControl *control_ = nullptr;
 };
+
+using IGraphPartitionSolver = IBasicGraphPartitionSolver<WeightedGraph>;
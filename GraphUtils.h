@@ -1,90 +1,149 @@
 #pragma once
+#include "GraphKernels.h"
 #include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <limits>
 #include <numeric>
 #include <queue>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 using Weight = long long;
 
-struct WeightedGraph
+// Weight tag for graphs whose edges all have unit weight; such edges store no weight field.
+struct Unweighted
+{};
+
+template<typename VertexId, typename W>
+struct GraphEdge
 {
-    struct Edge
-    {
-        int to{};
-        Weight w{};
-    };
+    VertexId to{};
+    W w{};
+};
+
+template<typename VertexId>
+struct GraphEdge<VertexId, Unweighted>
+{
+    VertexId to{};
+    static constexpr int w = 1;
+};
+
+// Undirected graph with nonnegative edge weights. VertexId is the stored neighbor id type and
+// W the stored edge weight type (or Unweighted). Sums such as degrees and cuts are always
+// accumulated in Weight.
+template<typename VertexId = int, typename W = Weight>
+struct BasicWeightedGraph
+{
+    static_assert(std::is_integral<VertexId>::value && std::is_signed<VertexId>::value,
+                  "VertexId must be a signed integer type");
+
+    using vertex_type = VertexId;
+    using weight_type = W;
+    using Edge = GraphEdge<VertexId, W>;
+    // Graph type produced by contracting edges; merged edges need real weights.
+    using coarse_graph = BasicWeightedGraph<VertexId, Weight>;
 
-    int n{};
+    static constexpr bool is_weighted = !std::is_same<W, Unweighted>::value;
+
+    VertexId n{};
     std::vector<std::vector<Edge>> adj;
 
-    explicit WeightedGraph(int n_ = 0)
+    explicit BasicWeightedGraph(VertexId n_ = 0)
         : n(n_)
         , adj(n_)
     {}
 
-    void add_undirected(int u, int v, Weight w)
+    void add_undirected(VertexId u, VertexId v, Weight w = 1)
     {
         if (u < 0 || v < 0 || u >= n || v >= n)
             throw std::out_of_range("vertex");
         if (w < 0)
             throw std::invalid_argument("weight must be nonnegative");
-        adj[u].push_back({v, w});
-        adj[v].push_back({u, w});
+        if constexpr (is_weighted) {
+            if (w > (Weight) std::numeric_limits<W>::max())
+                throw std::invalid_argument("weight does not fit the graph weight type");
+            adj[u].push_back({v, (W) w});
+            adj[v].push_back({u, (W) w});
+        } else {
+            if (w != 1)
+                throw std::invalid_argument("unweighted graph requires unit weights");
+            adj[u].push_back({v});
+            adj[v].push_back({u});
+        }
     }
 
     std::vector<Weight> degrees() const
     {
         std::vector<Weight> deg(n, 0);
-        for (int u = 0; u < n; ++u) {
-            Weight s = 0;
-            for (auto &e : adj[u])
-                s += e.w;
-            deg[u] = s;
+        for (VertexId u = 0; u < n; ++u) {
+            if constexpr (kernels::has_row_kernels<Edge>::value) {
+                deg[u] = kernels::row_weight(adj[u].data(), adj[u].size());
+            } else {
+                Weight s = 0;
+                for (auto &e : adj[u])
+                    s += e.w;
+                deg[u] = s;
+            }
         }
         return deg;
     }
 };
 
+using WeightedGraph = BasicWeightedGraph<int, Weight>;
+using CompactWeightedGraph = BasicWeightedGraph<int, int>;
+using UnweightedGraph = BasicWeightedGraph<int, Unweighted>;
+
 struct PartitionResult
 {
     std::vector<int> part;
     std::vector<int> separator;
     Weight cut_weight = 0;
     double score = 0.0;
+    // True if a SolveControl deadline or cancellation cut the solve short; the partition is
+    // still valid, only less refined.
+    bool stopped_early = false;
 };
 namespace {
 
-static Weight cut_weight_undirected(const WeightedGraph &g, const std::vector<int> &part)
+template<typename Graph>
+static Weight cut_weight_undirected(const Graph &g, const std::vector<int> &part)
 {
     Weight sum = 0;
     for (int u = 0; u < g.n; ++u) {
-        for (auto &e : g.adj[u]) {
-            int v = e.to;
-            if (u < v && part[u] != part[v])
-                sum += e.w;
+        if constexpr (kernels::has_row_kernels<typename Graph::Edge>::value) {
+            sum += kernels::row_cut(g.adj[u].data(), g.adj[u].size(), part.data(), u);
+        } else {
+            for (auto &e : g.adj[u]) {
+                int v = e.to;
+                if (u < v && part[u] != part[v])
+                    sum += e.w;
+            }
         }
     }
     return sum;
 }
 
-static std::vector<int> order_by_internal_degree(const WeightedGraph &g,
-                                                 const std::vector<int> &vertices)
+template<typename Graph>
+static std::vector<int> order_by_internal_degree(const Graph &g, const std::vector<int> &vertices)
 {
-    std::vector<bool> in(g.n, 0);
+    std::vector<int> in(g.n, 0);
     for (int v : vertices)
         in[v] = 1;
     std::vector<std::pair<Weight, int>> dv;
     dv.reserve(vertices.size());
     for (int v : vertices) {
         Weight d = 0;
-        for (auto &e : g.adj[v])
-            if (in[e.to])
-                d += e.w;
+        if constexpr (kernels::has_row_kernels<typename Graph::Edge>::value) {
+            d = kernels::row_label_weight(g.adj[v].data(), g.adj[v].size(), in.data(), 1);
+        } else {
+            for (auto &e : g.adj[v])
+                if (in[e.to])
+                    d += e.w;
+        }
         dv.push_back({d, v});
     }
     std::sort(dv.begin(), dv.end(), [](auto &a, auto &b) {
@@ -98,4 +157,24 @@ static std::vector<int> order_by_internal_degree(const WeightedGraph &g,
         out.push_back(p.second);
     return out;
 }
+
+// Subgraph induced by `vertices`: vertex i of the result is vertices[i] of g.
+template<typename Graph>
+static Graph induced_subgraph(const Graph &g, const std::vector<int> &vertices)
+{
+    std::vector<int> local(g.n, -1);
+    for (int i = 0; i < (int) vertices.size(); ++i)
+        local[vertices[i]] = i;
+    Graph sub((int) vertices.size());
+    for (int i = 0; i < (int) vertices.size(); ++i) {
+        for (auto e : g.adj[vertices[i]]) {
+            int v = local[e.to];
+            if (v < 0)
+                continue;
+            e.to = v;
+            sub.adj[i].push_back(e);
+        }
+    }
+    return sub;
+}
 } // namespace
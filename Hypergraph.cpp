@@ -0,0 +1,145 @@
+#include "Hypergraph.h"
+#include "CompressedGraph.h"
+
+Hypergraph::Hypergraph(int n_,
+                       const std::vector<std::vector<int>> &nets,
+                       std::vector<Weight> net_weights,
+                       std::vector<Weight> vertex_weights)
+    : n(n_)
+    , net_weights_(std::move(net_weights))
+    , vertex_weights_(std::move(vertex_weights))
+{
+    for (auto &net : nets) {
+        pins_.insert(pins_.end(), net.begin(), net.end());
+        net_offsets_.push_back((long long) pins_.size());
+    }
+    finish();
+}
+
+Hypergraph::Hypergraph(int n_,
+                       std::vector<long long> net_offsets,
+                       std::vector<int> pins,
+                       std::vector<Weight> net_weights,
+                       std::vector<Weight> vertex_weights)
+    : n(n_)
+    , net_offsets_(std::move(net_offsets))
+    , pins_(std::move(pins))
+    , net_weights_(std::move(net_weights))
+    , vertex_weights_(std::move(vertex_weights))
+{
+    if (net_offsets_.empty() || net_offsets_.front() != 0
+        || net_offsets_.back() != (long long) pins_.size())
+        throw std::invalid_argument("net offsets must span the pin list");
+    for (std::size_t e = 0; e + 1 < net_offsets_.size(); ++e)
+        if (net_offsets_[e] > net_offsets_[e + 1])
+            throw std::invalid_argument("net offsets must be nondecreasing");
+    finish();
+}
+
+void Hypergraph::finish()
+{
+    if (n < 0)
+        throw std::invalid_argument("vertex count must be nonnegative");
+    int nets = (int) net_offsets_.size() - 1;
+    if (!net_weights_.empty() && (int) net_weights_.size() != nets)
+        throw std::invalid_argument("net_weights must have one entry per net");
+    if (!vertex_weights_.empty() && (int) vertex_weights_.size() != n)
+        throw std::invalid_argument("vertex_weights must have one entry per vertex");
+    for (Weight w : net_weights_)
+        if (w < 0)
+            throw std::invalid_argument("net weight must be nonnegative");
+    for (Weight w : vertex_weights_)
+        if (w < 0)
+            throw std::invalid_argument("vertex weight must be nonnegative");
+    for (int v : pins_)
+        if (v < 0 || v >= n)
+            throw std::out_of_range("vertex");
+
+    // Compact in place: every kept net only moves towards the front.
+    long long out = 0;
+    int kept = 0;
+    for (int e = 0; e < nets; ++e) {
+        long long b = net_offsets_[e], end = net_offsets_[e + 1];
+        std::sort(pins_.begin() + b, pins_.begin() + end);
+        long long size = std::unique(pins_.begin() + b, pins_.begin() + end) - (pins_.begin() + b);
+        if (size < 2)
+            continue;
+        std::copy(pins_.begin() + b, pins_.begin() + b + size, pins_.begin() + out);
+        if (!net_weights_.empty())
+            net_weights_[kept] = net_weights_[e];
+        net_offsets_[kept] = out;
+        out += size;
+        ++kept;
+    }
+    pins_.resize(out);
+    pins_.shrink_to_fit();
+    net_offsets_.resize(kept + 1);
+    net_offsets_[kept] = out;
+    if (!net_weights_.empty())
+        net_weights_.resize(kept);
+
+    vertex_offsets_.assign(n + 1, 0);
+    for (int v : pins_)
+        vertex_offsets_[v + 1]++;
+    std::partial_sum(vertex_offsets_.begin(), vertex_offsets_.end(), vertex_offsets_.begin());
+    incident_nets_.assign(pins_.size(), 0);
+    std::vector<long long> fill(vertex_offsets_.begin(), vertex_offsets_.end() - 1);
+    for (int e = 0; e < kept; ++e)
+        for (long long i = net_offsets_[e]; i < net_offsets_[e + 1]; ++i)
+            incident_nets_[fill[pins_[i]]++] = e;
+}
+
+Weight Hypergraph::total_vertex_weight() const
+{
+    if (vertex_weights_.empty())
+        return n;
+    Weight total = 0;
+    for (Weight w : vertex_weights_)
+        total += w;
+    return total;
+}
+
+template<typename Graph>
+Hypergraph communication_hypergraph(const Graph &g)
+{
+    std::vector<long long> offsets{0};
+    std::vector<int> pins;
+    offsets.reserve(g.n + 1);
+    for (int u = 0; u < g.n; ++u) {
+        pins.push_back(u);
+        for (auto &e : g.adj[u])
+            pins.push_back((int) e.to);
+        offsets.push_back((long long) pins.size());
+    }
+    return Hypergraph(g.n, std::move(offsets), std::move(pins));
+}
+
+Weight connectivity_objective(const Hypergraph &h, const std::vector<int> &part, int k)
+{
+    if ((int) part.size() != h.n)
+        throw std::invalid_argument("part must have one entry per vertex");
+    for (int p : part)
+        if (p < 0 || p >= k)
+            throw std::invalid_argument("block label out of range");
+    // seen[b] == e + 1 once net e has a pin in block b.
+    std::vector<int> seen(k, 0);
+    Weight total = 0;
+    const auto &pins = h.pins();
+    for (int e = 0; e < h.num_nets(); ++e) {
+        int lambda = 0;
+        for (long long i = h.net_begin(e); i < h.net_end(e); ++i) {
+            int b = part[pins[i]];
+            if (seen[b] != e + 1) {
+                seen[b] = e + 1;
+                ++lambda;
+            }
+        }
+        total += h.net_weight(e) * (lambda - 1);
+    }
+    return total;
+}
+
+template Hypergraph communication_hypergraph(const WeightedGraph &);
+template Hypergraph communication_hypergraph(const CompactWeightedGraph &);
+template Hypergraph communication_hypergraph(const UnweightedGraph &);
+template Hypergraph communication_hypergraph(const CompressedGraph &);
@@ -0,0 +1,101 @@
+#pragma once
+#include "GraphUtils.h"
+
+// Read-only hypergraph with contiguous pin lists. Net e connects the vertices
+// pins()[net_begin(e) .. net_end(e)), sorted and without duplicates; the nets incident to
+// vertex v are listed in incident_nets()[vertex_begin(v) .. vertex_end(v)). Nets and vertices
+// carry weights (empty vectors mean unit weights). Nets with fewer than two pins are dropped
+// on construction since no partition can cut them.
+class Hypergraph
+{
+public:
+    int n = 0;
+
+    Hypergraph() = default;
+    // nets[e] lists the pins of net e (duplicates are removed). Throws std::out_of_range for a
+    // pin outside [0, n) and std::invalid_argument for mis-sized or negative weights.
+    Hypergraph(int n,
+               const std::vector<std::vector<int>> &nets,
+               std::vector<Weight> net_weights = {},
+               std::vector<Weight> vertex_weights = {});
+    // The same from pin lists already laid out contiguously: net e is
+    // pins[net_offsets[e] .. net_offsets[e + 1]).
+    Hypergraph(int n,
+               std::vector<long long> net_offsets,
+               std::vector<int> pins,
+               std::vector<Weight> net_weights = {},
+               std::vector<Weight> vertex_weights = {});
+
+    int num_nets() const
+    {
+        return (int) net_offsets_.size() - 1;
+    }
+    long long num_pins() const
+    {
+        return (long long) pins_.size();
+    }
+    long long net_begin(int e) const
+    {
+        return net_offsets_[e];
+    }
+    long long net_end(int e) const
+    {
+        return net_offsets_[e + 1];
+    }
+    int net_size(int e) const
+    {
+        return (int) (net_offsets_[e + 1] - net_offsets_[e]);
+    }
+    Weight net_weight(int e) const
+    {
+        return net_weights_.empty() ? 1 : net_weights_[e];
+    }
+    long long vertex_begin(int v) const
+    {
+        return vertex_offsets_[v];
+    }
+    long long vertex_end(int v) const
+    {
+        return vertex_offsets_[v + 1];
+    }
+    Weight vertex_weight(int v) const
+    {
+        return vertex_weights_.empty() ? 1 : vertex_weights_[v];
+    }
+    const std::vector<int> &pins() const
+    {
+        return pins_;
+    }
+    const std::vector<int> &incident_nets() const
+    {
+        return incident_nets_;
+    }
+    const std::vector<Weight> &vertex_weights() const
+    {
+        return vertex_weights_;
+    }
+    Weight total_vertex_weight() const;
+
+private:
+    // Sorts and deduplicates the pin lists, drops nets with fewer than two pins and builds the
+    // incidence lists.
+    void finish();
+
+    std::vector<long long> net_offsets_{0};
+    std::vector<int> pins_;
+    std::vector<Weight> net_weights_;
+    std::vector<long long> vertex_offsets_{0};
+    std::vector<int> incident_nets_;
+    std::vector<Weight> vertex_weights_;
+};
+
+// Column-net model of a graph: one net per vertex u holding u and its neighbors. Its
+// connectivity-minus-one objective equals PartitionMetrics::communication_volume, the data each
+// block sends when every vertex's value is needed by the blocks of its neighbors.
+template<typename Graph>
+Hypergraph communication_hypergraph(const Graph &g);
+
+// Sum over nets e of net_weight(e) * (lambda(e) - 1), where lambda(e) is the number of blocks
+// that net e has pins in. Throws std::invalid_argument if part has the wrong size or a label
+// outside [0, k).
+Weight connectivity_objective(const Hypergraph &h, const std::vector<int> &part, int k);
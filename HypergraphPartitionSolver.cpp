@@ -0,0 +1,552 @@
+#include "HypergraphPartitionSolver.h"
+#include "CompressedGraph.h"
+#include "KWayPartitionSolver.h"
+#include "PartitionMetrics.h"
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+namespace {
+
+// Nets with more pins than this are ignored when rating neighbors: they say little about which
+// pair to merge and would make rating quadratic.
+static const int large_net = 1000;
+// Nets up to this size become cliques in the expansion of the coarsest hypergraph; larger ones
+// become cycles through their pins.
+static const int clique_net = 32;
+// Coarsening stops at max(min_coarse, coarse_per_block * k) vertices.
+static const int min_coarse = 100;
+static const int coarse_per_block = 20;
+// One level shrinks the vertex count by at most this factor, so that clusters stay compact
+// and every level leaves refinement something to work with.
+static const double max_shrink = 2.5;
+
+// Clusters vertices by heavy-net rating divided by the product of the two weights (so large
+// clusters do not keep absorbing their neighbors); returns the number of clusters and fills
+// fine_to_coarse. No cluster grows beyond max_weight unless a single vertex is heavier.
+static int
+cluster_vertices(const Hypergraph &h, Weight max_weight, std::vector<int> &fine_to_coarse)
+{
+    int n = h.n;
+    const auto &pins = h.pins();
+    const auto &nets = h.incident_nets();
+    fine_to_coarse.assign(n, -1);
+    std::vector<Weight> cluster_weight;
+    // leader[c]: first vertex of cluster c; ratings are accumulated per leader.
+    std::vector<int> leader;
+    std::vector<double> rating(n, 0.0);
+    std::vector<int> touched;
+    int clusters_left = n, target = (int) std::ceil(n / max_shrink);
+    for (int u = 0; u < n; ++u) {
+        if (fine_to_coarse[u] != -1)
+            continue;
+        Weight w_u = h.vertex_weight(u);
+        if (clusters_left <= target) {
+            fine_to_coarse[u] = (int) leader.size();
+            leader.push_back(u);
+            cluster_weight.push_back(w_u);
+            continue;
+        }
+        touched.clear();
+        for (long long i = h.vertex_begin(u); i < h.vertex_end(u); ++i) {
+            int e = nets[i];
+            int size = h.net_size(e);
+            if (size > large_net)
+                continue;
+            double r = (double) h.net_weight(e) / (size - 1);
+            for (long long j = h.net_begin(e); j < h.net_end(e); ++j) {
+                int v = pins[j];
+                if (v == u)
+                    continue;
+                int key = fine_to_coarse[v] == -1 ? v : leader[fine_to_coarse[v]];
+                if (rating[key] == 0.0)
+                    touched.push_back(key);
+                rating[key] += r;
+            }
+        }
+        int best = -1;
+        double best_rating = 0.0;
+        for (int key : touched) {
+            Weight w_key = fine_to_coarse[key] == -1 ? h.vertex_weight(key)
+                                                     : cluster_weight[fine_to_coarse[key]];
+            if (w_key + w_u > max_weight)
+                continue;
+            double score = rating[key] / ((double) std::max<Weight>(1, w_u)
+                                          * (double) std::max<Weight>(1, w_key));
+            if (score > best_rating || (score == best_rating && key < best)) {
+                best_rating = score;
+                best = key;
+            }
+        }
+        for (int key : touched)
+            rating[key] = 0.0;
+
+        if (best != -1 && fine_to_coarse[best] == -1) {
+            fine_to_coarse[best] = (int) leader.size();
+            leader.push_back(best);
+            cluster_weight.push_back(h.vertex_weight(best));
+        }
+        if (best == -1) {
+            fine_to_coarse[u] = (int) leader.size();
+            leader.push_back(u);
+            cluster_weight.push_back(w_u);
+        } else {
+            fine_to_coarse[u] = fine_to_coarse[best];
+            cluster_weight[fine_to_coarse[u]] += w_u;
+            --clusters_left;
+        }
+    }
+    return (int) leader.size();
+}
+
+// Contracts every cluster to one vertex. Pins are mapped and deduplicated, nets left with one
+// pin are dropped and nets with identical pin lists merged into one of summed weight.
+static Hypergraph
+contract(const Hypergraph &h, const std::vector<int> &fine_to_coarse, int coarse_n)
+{
+    const auto &pins = h.pins();
+    std::vector<long long> offsets{0};
+    std::vector<int> coarse_pins;
+    std::vector<Weight> weights;
+    std::unordered_map<std::uint64_t, std::vector<int>> by_hash;
+    std::vector<int> net;
+    for (int e = 0; e < h.num_nets(); ++e) {
+        net.clear();
+        for (long long i = h.net_begin(e); i < h.net_end(e); ++i)
+            net.push_back(fine_to_coarse[pins[i]]);
+        std::sort(net.begin(), net.end());
+        net.erase(std::unique(net.begin(), net.end()), net.end());
+        if (net.size() < 2)
+            continue;
+        std::uint64_t hash = net.size();
+        for (int v : net)
+            hash = (hash ^ (std::uint64_t) v) * 0x100000001b3ULL;
+        bool merged = false;
+        auto &same_hash = by_hash[hash];
+        for (int c : same_hash)
+            if (offsets[c + 1] - offsets[c] == (long long) net.size()
+                && std::equal(net.begin(), net.end(), coarse_pins.begin() + offsets[c])) {
+                weights[c] += h.net_weight(e);
+                merged = true;
+                break;
+            }
+        if (merged)
+            continue;
+        same_hash.push_back((int) weights.size());
+        coarse_pins.insert(coarse_pins.end(), net.begin(), net.end());
+        offsets.push_back((long long) coarse_pins.size());
+        weights.push_back(h.net_weight(e));
+    }
+    std::vector<Weight> vertex_weights(coarse_n, 0);
+    for (int u = 0; u < h.n; ++u)
+        vertex_weights[fine_to_coarse[u]] += h.vertex_weight(u);
+    return Hypergraph(coarse_n,
+                      std::move(offsets),
+                      std::move(coarse_pins),
+                      std::move(weights),
+                      std::move(vertex_weights));
+}
+
+// Weighted graph standing in for h in the initial partition: a net of s pins contributes
+// w(e) / (s - 1) per pin pair (scaled to integers), as a clique or, for large nets, a cycle.
+static WeightedGraph clique_expansion(const Hypergraph &h)
+{
+    const auto &pins = h.pins();
+    std::vector<std::unordered_map<int, Weight>> rows(h.n);
+    for (int e = 0; e < h.num_nets(); ++e) {
+        long long b = h.net_begin(e), end = h.net_end(e);
+        int size = h.net_size(e);
+        Weight w = std::max<Weight>(1, h.net_weight(e) * 64 / (size - 1));
+        if (size <= clique_net) {
+            for (long long i = b; i < end; ++i)
+                for (long long j = i + 1; j < end; ++j) {
+                    rows[pins[i]][pins[j]] += w;
+                    rows[pins[j]][pins[i]] += w;
+                }
+        } else {
+            for (long long i = b; i < end; ++i) {
+                int u = pins[i], v = pins[i + 1 < end ? i + 1 : b];
+                rows[u][v] += w;
+                rows[v][u] += w;
+            }
+        }
+    }
+    WeightedGraph g(h.n);
+    for (int u = 0; u < h.n; ++u)
+        for (auto &p : rows[u])
+            g.adj[u].push_back({p.first, p.second});
+    return g;
+}
+
+// Moves vertices out of blocks heavier than max_size, best gain first, into blocks with room.
+// gain(v, b) is supplied by the caller; move(v, b) applies a move and updates the gains.
+template<typename Gain, typename Move>
+static void rebalance(const Hypergraph &h,
+                      const std::vector<int> &part,
+                      int k,
+                      const std::vector<Weight> &sizes,
+                      Weight max_size,
+                      Gain &&gain,
+                      Move &&move)
+{
+    bool over = false;
+    for (int q = 0; q < k; ++q)
+        over |= sizes[q] > max_size;
+    if (!over)
+        return;
+
+    struct Candidate
+    {
+        Weight gain;
+        int v;
+    };
+    std::vector<Candidate> candidates;
+    for (int v = 0; v < h.n; ++v) {
+        int p = part[v];
+        if (sizes[p] <= max_size)
+            continue;
+        Weight best = std::numeric_limits<Weight>::min();
+        for (int q = 0; q < k; ++q)
+            if (q != p && sizes[q] < max_size)
+                best = std::max(best, gain(v, q));
+        if (best != std::numeric_limits<Weight>::min())
+            candidates.push_back({best, v});
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        if (a.gain != b.gain)
+            return a.gain > b.gain;
+        return a.v < b.v;
+    });
+    for (auto &c : candidates) {
+        int p = part[c.v];
+        Weight w = h.vertex_weight(c.v);
+        if (sizes[p] <= max_size)
+            continue;
+        // Gains may have changed since the scan: pick the best target with room now.
+        int to = -1;
+        for (int q = 0; q < k; ++q)
+            if (q != p && sizes[q] + w <= max_size && (to == -1 || gain(c.v, q) > gain(c.v, to)))
+                to = q;
+        if (to != -1)
+            move(c.v, to);
+    }
+}
+} // namespace
+
+HypergraphGainCache::HypergraphGainCache(const Hypergraph &h, std::vector<int> part, int k)
+    : h_(h)
+    , k_(k)
+    , part_(std::move(part))
+    , pin_count_((std::size_t) h.num_nets() * k, 0)
+    , benefit_(h.n, 0)
+    , incident_weight_(h.n, 0)
+    , affinity_((std::size_t) h.n * k, 0)
+{
+    if ((int) part_.size() != h.n)
+        throw std::invalid_argument("part must have one entry per vertex");
+    for (int p : part_)
+        if (p < 0 || p >= k)
+            throw std::invalid_argument("block label out of range");
+    const auto &pins = h.pins();
+    std::vector<int> blocks;
+    for (int e = 0; e < h.num_nets(); ++e) {
+        int *count = &pin_count_[(std::size_t) e * k];
+        for (long long i = h.net_begin(e); i < h.net_end(e); ++i)
+            count[part_[pins[i]]]++;
+        blocks.clear();
+        for (int b = 0; b < k; ++b)
+            if (count[b] > 0)
+                blocks.push_back(b);
+        Weight w = h.net_weight(e);
+        for (long long i = h.net_begin(e); i < h.net_end(e); ++i) {
+            int v = pins[i];
+            incident_weight_[v] += w;
+            if (count[part_[v]] == 1)
+                benefit_[v] += w;
+            for (int b : blocks)
+                affinity_[(std::size_t) v * k + b] += w;
+        }
+    }
+}
+
+void HypergraphGainCache::move(int v, int to)
+{
+    const auto &pins = h_.pins();
+    const auto &incident = h_.incident_nets();
+    int k = k_, from = part_[v];
+    if (to == from)
+        return;
+    part_[v] = to;
+    Weight own = 0;
+    for (long long i = h_.vertex_begin(v); i < h_.vertex_end(v); ++i) {
+        int e = incident[i];
+        Weight w = h_.net_weight(e);
+        int &in_from = pin_count_[(std::size_t) e * k + from];
+        int &in_to = pin_count_[(std::size_t) e * k + to];
+        --in_from;
+        ++in_to;
+        long long b = h_.net_begin(e), end = h_.net_end(e);
+        if (in_from == 0) {
+            for (long long j = b; j < end; ++j)
+                affinity_[(std::size_t) pins[j] * k + from] -= w;
+        } else if (in_from == 1) {
+            for (long long j = b; j < end; ++j)
+                if (part_[pins[j]] == from) {
+                    benefit_[pins[j]] += w;
+                    break;
+                }
+        }
+        if (in_to == 1) {
+            for (long long j = b; j < end; ++j)
+                affinity_[(std::size_t) pins[j] * k + to] += w;
+        } else if (in_to == 2) {
+            for (long long j = b; j < end; ++j)
+                if (pins[j] != v && part_[pins[j]] == to) {
+                    benefit_[pins[j]] -= w;
+                    break;
+                }
+        }
+        if (in_to == 1)
+            own += w;
+    }
+    benefit_[v] = own;
+}
+
+void refine_hypergraph_partition(const Hypergraph &h,
+                                 std::vector<int> &part,
+                                 int k,
+                                 int max_passes,
+                                 const SolveControl *control)
+{
+    if (k <= 1)
+        return;
+    int n = h.n;
+    HypergraphGainCache cache(h, part, k);
+    const auto &labels = cache.part();
+
+    Weight total = 0, heaviest = 0;
+    std::vector<Weight> sizes(k, 0);
+    for (int v = 0; v < n; ++v) {
+        Weight w = h.vertex_weight(v);
+        total += w;
+        heaviest = std::max(heaviest, w);
+        sizes[labels[v]] += w;
+    }
+    Weight min_size = total / k - (heaviest - 1);
+    Weight max_size = (total + k - 1) / k + (heaviest - 1);
+
+    auto gain = [&](int v, int b) { return cache.gain(v, b); };
+    auto move = [&](int v, int to) {
+        Weight w_v = h.vertex_weight(v);
+        sizes[labels[v]] -= w_v;
+        sizes[to] += w_v;
+        cache.move(v, to);
+    };
+
+    rebalance(h, labels, k, sizes, max_size, gain, move);
+    for (int pass = 0; pass < max_passes && !should_stop(control); ++pass) {
+        bool moved = false;
+        for (int v = 0; v < n; ++v) {
+            // gain(v, b) <= benefit(v), so vertices without benefit cannot improve.
+            if (cache.benefit(v) <= 0)
+                continue;
+            int p = labels[v];
+            Weight w_v = h.vertex_weight(v);
+            if (sizes[p] - w_v < min_size)
+                continue;
+            int best = -1;
+            Weight best_gain = 0;
+            for (int q = 0; q < k; ++q) {
+                if (q == p || sizes[q] + w_v > max_size)
+                    continue;
+                Weight g = gain(v, q);
+                if (g > best_gain) {
+                    best_gain = g;
+                    best = q;
+                }
+            }
+            if (best != -1) {
+                move(v, best);
+                moved = true;
+            }
+        }
+        if (!moved)
+            break;
+    }
+    part = labels;
+}
+
+MultilevelHypergraphSolver::MultilevelHypergraphSolver(int k,
+                                                       int bisection_passes,
+                                                       int refine_passes,
+                                                       int max_levels)
+    : k_(k)
+    , bisection_passes_(bisection_passes)
+    , refine_passes_(refine_passes)
+    , max_levels_(max_levels)
+{}
+
+std::string MultilevelHypergraphSolver::name() const
+{
+    return "k-Way Hypergraph Partition (Multilevel coarsen-refine heuristic)";
+}
+
+std::string MultilevelHypergraphSolver::statement() const
+{
+    return "Input: hypergraph H=(V,N) with net weights w(e) and vertex weights c(v), integer "
+           "k >= 2.\n"
+           "Goal: assign each vertex a label part[v] in {0..k-1} such that:\n"
+           "  - block weights c(V_i) are as equal as possible\n"
+           "Objective: minimize the connectivity metric:\n"
+           "  sum of w(e) * (lambda(e) - 1) over nets e, lambda(e) = number of blocks e spans.";
+}
+
+std::string MultilevelHypergraphSolver::complexity() const
+{
+    return "Optimization is NP-hard. Multilevel heuristic: O(L*p) clustering and contraction "
+           "for p pins + coarse partitioning + O(L*(p*lambda + n*k)) refinement with "
+           "incremental gains.";
+}
+
+void MultilevelHypergraphSolver::solve(const Hypergraph &h)
+{
+    res_ = {};
+    block_weights_.clear();
+    if (h.n == 0)
+        return;
+    int k = std::max(1, std::min(k_, h.n));
+    res_.part.assign(h.n, 0);
+    if (k == 1) {
+        block_weights_.assign(1, h.total_vertex_weight());
+        return;
+    }
+
+    // coarse[i] is level i+1 and maps[i] projects level i onto level i+1.
+    std::vector<Hypergraph> coarse;
+    std::vector<std::vector<int>> maps;
+    auto level = [&](int i) -> const Hypergraph & { return i == 0 ? h : coarse[i - 1]; };
+    const SolveControl *control = this->control_;
+    int limit = std::max(min_coarse, coarse_per_block * k);
+    Weight max_cluster = std::max<Weight>(1, (h.total_vertex_weight() + limit - 1) / limit);
+    for (int i = 0; i < max_levels_ && level(i).n > limit && !should_stop(control); ++i) {
+        const Hypergraph &fine = level(i);
+        std::vector<int> map;
+        int coarse_n = cluster_vertices(fine, max_cluster, map);
+        if (coarse_n > fine.n - fine.n / 20)
+            break;
+        coarse.push_back(contract(fine, map, coarse_n));
+        maps.push_back(std::move(map));
+        report_progress(control, "coarsen level", i);
+    }
+
+    const Hypergraph &coarsest = level((int) coarse.size());
+    BasicKWayPartitionSolver<WeightedGraph> initial(k, bisection_passes_);
+    initial.set_control(control);
+    initial.solve(clique_expansion(coarsest));
+    std::vector<int> part = initial.result().part;
+    refine_hypergraph_partition(coarsest, part, k, refine_passes_, control);
+
+    for (int i = (int) maps.size() - 1; i >= 0; --i) {
+        const auto &map = maps[i];
+        std::vector<int> fine_part(map.size(), 0);
+        for (int u = 0; u < (int) map.size(); ++u)
+            fine_part[u] = part[map[u]];
+        part = std::move(fine_part);
+        refine_hypergraph_partition(level(i), part, k, refine_passes_, control);
+        report_progress(control, "refine level", i);
+    }
+
+    res_.part = std::move(part);
+    res_.cut_weight = connectivity_objective(h, res_.part, k);
+    res_.stopped_early = was_stopped(control);
+    block_weights_ = partition_block_sizes(res_.part, k, h.vertex_weights());
+}
+
+PartitionResult MultilevelHypergraphSolver::result() const
+{
+    return res_;
+}
+
+void MultilevelHypergraphSolver::print(std::ostream &os) const
+{
+    os << "\n=== " << name() << " ===\n";
+    os << "Problem: " << statement() << "\n";
+    os << "Complexity: " << complexity() << "\n";
+    if (!res_.part.empty()) {
+        os << "Result: k=" << block_weights_.size() << " connectivity-1=" << res_.cut_weight
+           << " ";
+        print_block_sizes(os, block_weights_);
+        os << "\n";
+    }
+    os << "\n";
+}
+
+template<typename Graph>
+BasicCommunicationVolumeSolver<Graph>::BasicCommunicationVolumeSolver(int k,
+                                                                      int bisection_passes,
+                                                                      int refine_passes,
+                                                                      int max_levels)
+    : inner_(k, bisection_passes, refine_passes, max_levels)
+{}
+
+template<typename Graph>
+std::string BasicCommunicationVolumeSolver<Graph>::name() const
+{
+    return "k-Way Communication Volume Partition (Multilevel hypergraph heuristic)";
+}
+
+template<typename Graph>
+std::string BasicCommunicationVolumeSolver<Graph>::statement() const
+{
+    return "Input: undirected graph G=(V,E) and integer k >= 2.\n"
+           "Goal: assign each vertex a label part[v] in {0..k-1} with block sizes as equal as "
+           "possible.\n"
+           "Objective: minimize the communication volume:\n"
+           "  sum over v of the number of blocks other than part[v] that hold a neighbor of v\n"
+           "  (the connectivity metric of the column-net hypergraph {v} U N(v)).";
+}
+
+template<typename Graph>
+std::string BasicCommunicationVolumeSolver<Graph>::complexity() const
+{
+    return "Optimization is NP-hard. Builds a hypergraph with n nets and n+2m pins, then runs "
+           "the multilevel hypergraph heuristic on it.";
+}
+
+template<typename Graph>
+void BasicCommunicationVolumeSolver<Graph>::solve(const Graph &g)
+{
+    res_ = {};
+    inner_.set_control(this->control_);
+    inner_.solve(communication_hypergraph(g));
+    res_ = inner_.result();
+    res_.score = (double) res_.cut_weight;
+    res_.cut_weight = res_.part.empty() ? 0 : cut_weight_undirected(g, res_.part);
+}
+
+template<typename Graph>
+PartitionResult BasicCommunicationVolumeSolver<Graph>::result() const
+{
+    return res_;
+}
+
+template<typename Graph>
+void BasicCommunicationVolumeSolver<Graph>::print(std::ostream &os) const
+{
+    os << "\n=== " << name() << " ===\n";
+    os << "Problem: " << statement() << "\n";
+    os << "Complexity: " << complexity() << "\n";
+    if (!res_.part.empty()) {
+        auto sizes = partition_block_sizes(res_.part);
+        os << "Result: k=" << sizes.size() << " cut=" << res_.cut_weight
+           << " volume=" << (long long) res_.score << " ";
+        print_block_sizes(os, sizes);
+        os << "\n";
+    }
+    os << "\n";
+}
+
+template class BasicCommunicationVolumeSolver<WeightedGraph>;
+template class BasicCommunicationVolumeSolver<CompactWeightedGraph>;
+template class BasicCommunicationVolumeSolver<UnweightedGraph>;
+template class BasicCommunicationVolumeSolver<CompressedGraph>;
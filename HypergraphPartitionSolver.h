@@ -0,0 +1,114 @@
+#pragma once
+#include "GraphPartitionSolver.h"
+#include "Hypergraph.h"
+
+// Connectivity-minus-one gains of a k-way labeling, kept incrementally: per net the pin count
+// of every block, per vertex the weight of its nets that would leave the cut if it moved
+// (benefit) and, per block, the weight of its nets that already have a pin there (affinity).
+// gain(v, b) = benefit(v) - (incident weight(v) - affinity(v, b)), and a move only touches the
+// nets of the moved vertex. Memory is O((nets + n) * k).
+class HypergraphGainCache
+{
+public:
+    // Throws std::invalid_argument if part has the wrong size or a label outside [0, k).
+    HypergraphGainCache(const Hypergraph &h, std::vector<int> part, int k);
+
+    // Decrease of connectivity_objective if v moved to block b (b other than part()[v]).
+    Weight gain(int v, int b) const
+    {
+        return benefit_[v] - (incident_weight_[v] - affinity_[(std::size_t) v * k_ + b]);
+    }
+    // Upper bound of gain(v, b) over all b.
+    Weight benefit(int v) const
+    {
+        return benefit_[v];
+    }
+    // Moves v to block to and updates the gains.
+    void move(int v, int to);
+    const std::vector<int> &part() const
+    {
+        return part_;
+    }
+
+private:
+    const Hypergraph &h_;
+    int k_;
+    std::vector<int> part_;
+    // pin_count_[e * k + b]: pins of net e in block b.
+    std::vector<int> pin_count_;
+    std::vector<Weight> benefit_, incident_weight_, affinity_;
+};
+
+// Greedy k-way refinement of the connectivity-minus-one objective with a HypergraphGainCache.
+// Block weights must lie in the same window as refine_kway_partition's ([W/k, ceil(W/k)]
+// widened by the heaviest vertex weight minus one); overweight blocks are drained first.
+void refine_hypergraph_partition(const Hypergraph &h,
+                                 std::vector<int> &part,
+                                 int k,
+                                 int max_passes,
+                                 const SolveControl *control = nullptr);
+
+// The coarsen/partition/refine skeleton of MultilevelKWayPartitionSolver for hypergraphs:
+//   - coarsening by heavy-net clustering: each vertex joins the cluster of the neighbor with the
+//     highest rating sum of w(e) / (|e| - 1) over shared nets, up to a cluster weight limit;
+//     contraction drops nets left with one pin and merges identical nets;
+//   - the coarsest hypergraph is partitioned by KWayPartitionSolver on its clique expansion;
+//   - refine_hypergraph_partition on every level while uncoarsening.
+// result().cut_weight holds the connectivity-minus-one objective.
+class MultilevelHypergraphSolver final : public IBasicGraphPartitionSolver<Hypergraph>
+{
+public:
+    explicit MultilevelHypergraphSolver(int k,
+                                        int bisection_passes = 8,
+                                        int refine_passes = 4,
+                                        int max_levels = 20);
+
+    std::string name() const override;
+    std::string statement() const override;
+    std::string complexity() const override;
+
+    void solve(const Hypergraph &h) override;
+
+    PartitionResult result() const override;
+
+    void print(std::ostream &os) const override;
+
+private:
+    int k_;
+    int bisection_passes_;
+    int refine_passes_;
+    int max_levels_;
+    PartitionResult res_;
+    // Summed vertex weight of every block of res_.part, for print().
+    std::vector<long long> block_weights_;
+};
+
+// Partitions a graph for minimum communication volume (PartitionMetrics::communication_volume)
+// instead of edge cut, by running MultilevelHypergraphSolver on communication_hypergraph(g).
+// result().cut_weight is the edge cut as for every graph solver; result().score holds the
+// communication volume.
+template<typename Graph>
+class BasicCommunicationVolumeSolver final : public IBasicGraphPartitionSolver<Graph>
+{
+public:
+    explicit BasicCommunicationVolumeSolver(int k,
+                                            int bisection_passes = 8,
+                                            int refine_passes = 4,
+                                            int max_levels = 20);
+
+    std::string name() const override;
+    std::string statement() const override;
+    std::string complexity() const override;
+
+    void solve(const Graph &g) override;
+
+    PartitionResult result() const override;
+
+    void print(std::ostream &os) const override;
+
+private:
+    MultilevelHypergraphSolver inner_;
+    PartitionResult res_;
+};
+
+using CommunicationVolumeSolver = BasicCommunicationVolumeSolver<WeightedGraph>;
@@ -1,17 +1,22 @@
 #include "KWayPartitionSolver.h"
+#include "CompressedGraph.h"
 #include "MinimumBisectionSolver.h"
+#include "PartitionMetrics.h"
 
-KWayPartitionSolver::KWayPartitionSolver(int k, int bisection_passes)
+template<typename Graph>
+BasicKWayPartitionSolver<Graph>::BasicKWayPartitionSolver(int k, int bisection_passes)
     : k_(k)
     , passes_(bisection_passes)
 {}
 
-std::string KWayPartitionSolver::name() const
+template<typename Graph>
+std::string BasicKWayPartitionSolver<Graph>::name() const
 {
     return "k-Way Balanced Partition (Recursive bisection heuristic)";
 }
 
-std::string KWayPartitionSolver::statement() const
+template<typename Graph>
+std::string BasicKWayPartitionSolver<Graph>::statement() const
 {
     return "Input: undirected weighted graph G=(V,E,w) and integer k >= 2.\n"
            "Goal: assign each vertex a label part[v] in {0..k-1} defining k disjoint blocks "
@@ -22,13 +27,15 @@ std::string KWayPartitionSolver::statement() const
            "  Cut_k = sum of w(u,v) over edges {u,v} with part[u] != part[v].";
 }
 
-std::string KWayPartitionSolver::complexity() const
+template<typename Graph>
+std::string BasicKWayPartitionSolver<Graph>::complexity() const
 {
     return "Optimization is NP-hard. Recursive bisection heuristic: ~O((k-1)*p*n^2) on splits "
            "(varies by split sizes).";
 }
 
-void KWayPartitionSolver::solve(const WeightedGraph &g)
+template<typename Graph>
+void BasicKWayPartitionSolver<Graph>::solve(const Graph &g)
 {
     res_ = {};
     if (g.n == 0)
@@ -54,7 +61,8 @@ void KWayPartitionSolver::solve(const WeightedGraph &g)
             break;
 
         auto subset = parts[idx];
-        auto bi = MinimumBisectionSolver::bisection_on_subset(g, subset, passes_);
+        auto bi = BasicMinimumBisectionSolver<Graph>::bisection_on_subset(
+            g, subset, passes_, this->control_, initial_, spectral_);
 
         std::vector<int> A, B;
         A.reserve(subset.size());
@@ -67,6 +75,7 @@ void KWayPartitionSolver::solve(const WeightedGraph &g)
 
         parts[idx] = std::move(A);
         parts.push_back(std::move(B));
+        report_progress(this->control_, "split", (int) parts.size() - 1);
     }
 
     for (int i = 0; i < (int) parts.size(); ++i) {
@@ -75,31 +84,39 @@ void KWayPartitionSolver::solve(const WeightedGraph &g)
     }
 
     res_.cut_weight = cut_weight_undirected(g, res_.part);
+    res_.stopped_early = was_stopped(this->control_);
 }
 
-PartitionResult KWayPartitionSolver::result() const
+template<typename Graph>
+PartitionResult BasicKWayPartitionSolver<Graph>::result() const
 {
     return res_;
 }
 
-void KWayPartitionSolver::print(std::ostream &os) const
+template<typename Graph>
+void BasicKWayPartitionSolver<Graph>::print(std::ostream &os) const
 {
     os << "\n=== " << name() << " ===\n";
     os << "Problem: " << statement() << "\n";
     os << "Complexity: " << complexity() << "\n";
     if (!res_.part.empty()) {
-        std::vector<int> sizes;
-        int maxp = *std::max_element(res_.part.begin(), res_.part.end());
-        sizes.assign(maxp + 1, 0);
-        for (int p : res_.part)
-            sizes[p]++;
-        os << "Result: k=" << sizes.size() << " cut=" << res_.cut_weight << " sizes=[";
-        for (size_t i = 0; i < sizes.size(); ++i) {
-            if (i)
-                os << ",";
-            os << sizes[i];
-        }
-        os << "]\n";
+        auto sizes = partition_block_sizes(res_.part);
+        os << "Result: k=" << sizes.size() << " cut=" << res_.cut_weight << " ";
+        print_block_sizes(os, sizes);
+        os << "\n";
     }
     os << "\n";
 }
+
+template<typename Graph>
+void BasicKWayPartitionSolver<Graph>::set_initial_bisection(InitialBisection initial,
+                                                            SpectralOptions spectral)
+{
+    initial_ = initial;
+    spectral_ = spectral;
+}
+
+template class BasicKWayPartitionSolver<WeightedGraph>;
+template class BasicKWayPartitionSolver<CompactWeightedGraph>;
+template class BasicKWayPartitionSolver<UnweightedGraph>;
+template class BasicKWayPartitionSolver<CompressedGraph>;
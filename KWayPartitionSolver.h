@@ -1,19 +1,28 @@
 #pragma once
 #include "GraphPartitionSolver.h"
+#include "SpectralBisection.h"
 
-class KWayPartitionSolver final : public IGraphPartitionSolver
+template<typename Graph>
+class BasicKWayPartitionSolver final : public IBasicGraphPartitionSolver<Graph>
 {
 public:
-    explicit KWayPartitionSolver(int k, int bisection_passes = 15);
+    explicit BasicKWayPartitionSolver(int k, int bisection_passes = 15);
     std::string name() const override;
     std::string statement() const override;
     std::string complexity() const override;
-    void solve(const WeightedGraph &g) override;
+    void solve(const Graph &g) override;
     PartitionResult result() const override;
     void print(std::ostream &os) const override;
 
+    // Seed of every bisection (default: internal-degree order).
+    void set_initial_bisection(InitialBisection initial, SpectralOptions spectral = {});
+
 private:
     int k_;
     int passes_;
+    InitialBisection initial_ = InitialBisection::DegreeOrder;
+    SpectralOptions spectral_;
     PartitionResult res_;
 };
+
+using KWayPartitionSolver = BasicKWayPartitionSolver<WeightedGraph>;
@@ -0,0 +1,340 @@
+#include "MaxFlow.h"
+#include "ParallelUtils.h"
+
+MaxFlow::MaxFlow(int n)
+    : n_(n)
+    , g_(n)
+{}
+
+int MaxFlow::node_count() const
+{
+    return n_;
+}
+
+int MaxFlow::add_node()
+{
+    g_.emplace_back();
+    return n_++;
+}
+
+void MaxFlow::add_edge(int u, int v, Weight c)
+{
+    c = std::min(c, infinite_capacity);
+    Arc a{v, (int) g_[v].size(), c};
+    Arc b{u, (int) g_[u].size(), 0};
+    g_[u].push_back(a);
+    g_[v].push_back(b);
+}
+
+void MaxFlow::add_undirected_edge(int u, int v, Weight c)
+{
+    c = std::min(c, infinite_capacity);
+    Arc a{v, (int) g_[v].size(), c};
+    Arc b{u, (int) g_[u].size(), c};
+    g_[u].push_back(a);
+    g_[v].push_back(b);
+}
+
+bool MaxFlow::bfs(int s, int t)
+{
+    lvl_.assign(n_, -1);
+    std::queue<int> q;
+    lvl_[s] = 0;
+    q.push(s);
+    while (!q.empty()) {
+        int u = q.front();
+        q.pop();
+        for (auto &e : g_[u])
+            if (e.cap > 0 && lvl_[e.to] < 0) {
+                lvl_[e.to] = lvl_[u] + 1;
+                q.push(e.to);
+            }
+    }
+    return lvl_[t] >= 0;
+}
+
+// Iterative blocking flow over the level graph with current-arc pointers. After each
+// augmentation the descent retreats only to the tail of the first saturated arc, so one descent
+// from s pushes flow along many paths; dead ends are removed from the level graph.
+Weight MaxFlow::blocking_flow(int s, int t)
+{
+    Weight total = 0;
+    path_.clear();
+    int u = s;
+    while (true) {
+        if (u == t) {
+            Weight f = infinite_capacity;
+            for (int v : path_)
+                f = std::min(f, g_[v][it_[v]].cap);
+            int retreat = -1;
+            for (int i = 0; i < (int) path_.size(); ++i) {
+                Arc &e = g_[path_[i]][it_[path_[i]]];
+                e.cap -= f;
+                g_[e.to][e.rev].cap += f;
+                if (e.cap == 0 && retreat < 0)
+                    retreat = i;
+            }
+            total += f;
+            // Nothing saturates only on reverse arcs of undirected arcs holding more than
+            // infinite_capacity; this push brings them within it, so restarting from s ends.
+            if (retreat < 0)
+                retreat = 0;
+            u = path_[retreat];
+            path_.resize(retreat);
+            continue;
+        }
+        int &i = it_[u];
+        while (i < (int) g_[u].size()) {
+            const Arc &e = g_[u][i];
+            if (e.cap > 0 && lvl_[e.to] == lvl_[u] + 1)
+                break;
+            ++i;
+        }
+        if (i < (int) g_[u].size()) {
+            path_.push_back(u);
+            u = g_[u][i].to;
+            continue;
+        }
+        // No admissible arc left: u is dead for the rest of this phase.
+        lvl_[u] = -1;
+        if (path_.empty())
+            break;
+        u = path_.back();
+        path_.pop_back();
+        ++it_[u];
+    }
+    return total;
+}
+
+Weight MaxFlow::max_flow(int s, int t)
+{
+    if (s == t)
+        throw std::invalid_argument("source equals sink");
+    Weight flow = 0;
+    while (bfs(s, t)) {
+        it_.assign(n_, 0);
+        flow += blocking_flow(s, t);
+    }
+    return flow;
+}
+
+// Synchronous push-relabel in the style of Baumstark, Blelloch and Shun: every round, all active
+// vertices push against labels frozen for the round, then relabel from the same snapshot. Each
+// arc is written by exactly one vertex per phase (its tail pushes, later the same tail updates
+// the reverse arc), so only excess arriving at a vertex needs atomics.
+Weight MaxFlow::parallel_max_flow(int s, int t, int threads)
+{
+    if (s == t)
+        throw std::invalid_argument("source equals sink");
+    threads = resolve_threads(threads);
+    const long long chunk = 64;
+
+    std::vector<long long> off(n_ + 1, 0);
+    for (int u = 0; u < n_; ++u)
+        off[u + 1] = off[u] + (long long) g_[u].size();
+    long long m = off[n_];
+
+    std::vector<Weight> excess(n_, 0), sent(m, 0);
+    std::vector<std::atomic<Weight>> added(n_);
+    std::vector<std::atomic<char>> queued(n_);
+    std::vector<int> label(n_, 0), new_label(n_, 0);
+    std::vector<std::vector<int>> found(threads);
+    std::vector<long long> work(threads, 0);
+
+    // Saturate the arcs out of s, capped by what the head could ever pass on.
+    for (auto &a : g_[s]) {
+        if (a.cap <= 0 || a.to == s)
+            continue;
+        Weight out = a.to == t ? a.cap : 0;
+        if (a.to != t)
+            for (auto &b : g_[a.to])
+                out = std::min(infinite_capacity, out + b.cap);
+        Weight f = std::min(a.cap, out);
+        a.cap -= f;
+        g_[a.to][a.rev].cap += f;
+        excess[a.to] += f;
+    }
+
+    std::vector<int> active, candidates;
+    auto collect_active = [&](const std::vector<int> &from) {
+        active.clear();
+        for (int v : from)
+            if (v != s && v != t && excess[v] > 0 && label[v] < n_) {
+                queued[v] = 1;
+                active.push_back(v);
+            } else {
+                queued[v] = 0;
+            }
+    };
+    global_relabel(s, t, label, threads);
+    std::vector<int> all(n_);
+    std::iota(all.begin(), all.end(), 0);
+    collect_active(all);
+
+    // Global relabel once the local relabel work reaches this (the usual 6n + m heuristic).
+    const long long relabel_work = 6LL * n_ + m;
+    long long work_since_relabel = 0;
+    while (!active.empty()) {
+        long long na = (long long) active.size();
+
+        parallel_for_chunks(na, threads, chunk, [&](long long b, long long e, int w) {
+            for (long long i = b; i < e; ++i) {
+                int v = active[i];
+                Weight ex = excess[v];
+                int d = label[v];
+                for (int j = 0; j < (int) g_[v].size() && ex > 0; ++j) {
+                    Arc &a = g_[v][j];
+                    int x = a.to;
+                    if (a.cap <= 0 || label[x] != d - 1)
+                        continue;
+                    Weight f = std::min(ex, a.cap);
+                    a.cap -= f;
+                    sent[off[v] + j] += f;
+                    ex -= f;
+                    added[x].fetch_add(f, std::memory_order_relaxed);
+                    if (x != t && !queued[x].exchange(1, std::memory_order_relaxed))
+                        found[w].push_back(x);
+                }
+                excess[v] = ex;
+            }
+        });
+
+        parallel_for_chunks(na, threads, chunk, [&](long long b, long long e, int) {
+            for (long long i = b; i < e; ++i) {
+                int v = active[i];
+                for (int j = 0; j < (int) g_[v].size(); ++j) {
+                    Weight &f = sent[off[v] + j];
+                    if (f > 0) {
+                        const Arc &a = g_[v][j];
+                        g_[a.to][a.rev].cap += f;
+                        f = 0;
+                    }
+                }
+            }
+        });
+
+        parallel_for_chunks(na, threads, chunk, [&](long long b, long long e, int w) {
+            for (long long i = b; i < e; ++i) {
+                int v = active[i];
+                new_label[v] = label[v];
+                if (excess[v] == 0)
+                    continue;
+                int best = n_;
+                for (auto &a : g_[v])
+                    if (a.cap > 0)
+                        best = std::min(best, label[a.to] + 1);
+                new_label[v] = best;
+                work[w] += (long long) g_[v].size() + 12;
+            }
+        });
+
+        candidates.assign(active.begin(), active.end());
+        for (auto &f : found) {
+            candidates.insert(candidates.end(), f.begin(), f.end());
+            f.clear();
+        }
+        for (int v : active)
+            label[v] = new_label[v];
+        for (int v : candidates)
+            excess[v] += added[v].exchange(0, std::memory_order_relaxed);
+        for (auto &w : work) {
+            work_since_relabel += w;
+            w = 0;
+        }
+        if (work_since_relabel >= relabel_work) {
+            global_relabel(s, t, label, threads);
+            work_since_relabel = 0;
+        }
+        collect_active(candidates);
+    }
+
+    Weight flow = excess[t] + added[t].load();
+    excess[t] = 0;
+    return_excess(s, excess);
+    return flow;
+}
+
+void MaxFlow::global_relabel(int s, int t, std::vector<int> &label, int threads) const
+{
+    std::vector<std::atomic<char>> seen(n_);
+    std::fill(label.begin(), label.end(), n_);
+    seen[s] = 1;
+    seen[t] = 1;
+    label[t] = 0;
+    std::vector<int> frontier{t};
+    std::vector<std::vector<int>> next(threads);
+    for (int d = 1; !frontier.empty(); ++d) {
+        parallel_for_chunks(
+            (long long) frontier.size(), threads, 256, [&](long long b, long long e, int w) {
+                for (long long i = b; i < e; ++i)
+                    for (auto &a : g_[frontier[i]]) {
+                        int x = a.to;
+                        if (g_[x][a.rev].cap <= 0 || seen[x].load(std::memory_order_relaxed)
+                            || seen[x].exchange(1, std::memory_order_relaxed))
+                            continue;
+                        label[x] = d;
+                        next[w].push_back(x);
+                    }
+            });
+        frontier.clear();
+        for (auto &nx : next) {
+            frontier.insert(frontier.end(), nx.begin(), nx.end());
+            nx.clear();
+        }
+    }
+}
+
+void MaxFlow::return_excess(int s, const std::vector<Weight> &excess)
+{
+    // A super source x feeds every excess; a max x->s flow moves all of it back to s.
+    int x = add_node();
+    for (int v = 0; v < x; ++v)
+        if (v != s && excess[v] > 0)
+            add_edge(x, v, excess[v]);
+    while (!g_[x].empty() && bfs(x, s)) {
+        it_.assign(n_, 0);
+        blocking_flow(x, s);
+    }
+    // Every arc into x is the last one added to its tail.
+    for (auto &a : g_[x])
+        g_[a.to].pop_back();
+    g_.pop_back();
+    --n_;
+}
+
+std::vector<char> MaxFlow::source_side(int s) const
+{
+    std::vector<char> vis(n_, 0);
+    std::queue<int> q;
+    vis[s] = 1;
+    q.push(s);
+    while (!q.empty()) {
+        int u = q.front();
+        q.pop();
+        for (auto &e : g_[u])
+            if (e.cap > 0 && !vis[e.to]) {
+                vis[e.to] = 1;
+                q.push(e.to);
+            }
+    }
+    return vis;
+}
+
+std::vector<char> MaxFlow::sink_side(int t) const
+{
+    std::vector<char> vis(n_, 0);
+    std::queue<int> q;
+    vis[t] = 1;
+    q.push(t);
+    while (!q.empty()) {
+        int u = q.front();
+        q.pop();
+        // e.to can reach u if the opposite arc e.to->u has residual capacity.
+        for (auto &e : g_[u])
+            if (!vis[e.to] && g_[e.to][e.rev].cap > 0) {
+                vis[e.to] = 1;
+                q.push(e.to);
+            }
+    }
+    return vis;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "GraphUtils.h"
+
+// Dinic max-flow on a directed network with Weight capacities. Shared by the s-t cut solver
+// and the flow-based refinement stages.
+class MaxFlow
+{
+public:
+    // Large enough to never be saturated, small enough that sums of a few do not overflow.
+    static constexpr Weight infinite_capacity = std::numeric_limits<Weight>::max() / 4;
+
+    explicit MaxFlow(int n = 0);
+
+    int node_count() const;
+    int add_node();
+    // Arc u->v with capacity cap. Capacities above infinite_capacity are clamped to it, so
+    // every augmenting path has an arc that its bottleneck saturates.
+    void add_edge(int u, int v, Weight cap);
+    // Undirected edge: capacity cap in both directions on a single arc pair.
+    void add_undirected_edge(int u, int v, Weight cap);
+
+    // Augments to a maximum s-t flow and returns its value. Can be called once per network;
+    // throws std::invalid_argument if s == t. Uses no recursion, so depth is not bounded by the
+    // thread's stack.
+    Weight max_flow(int s, int t);
+    // Same value as max_flow, computed by synchronous parallel push-relabel on `threads`
+    // workers (<= 0: all hardware threads) with parallel global relabeling. Stranded excess is
+    // then routed back to s sequentially, so source_side and sink_side stay valid.
+    Weight parallel_max_flow(int s, int t, int threads = 0);
+    // Vertices reachable from s in the residual network (the minimal source side of a min cut).
+    std::vector<char> source_side(int s) const;
+    // Vertices that can reach t in the residual network (the minimal sink side of a min cut).
+    std::vector<char> sink_side(int t) const;
+
+private:
+    struct Arc
+    {
+        int to;
+        int rev;
+        Weight cap;
+    };
+
+    bool bfs(int s, int t);
+    Weight blocking_flow(int s, int t);
+    // Exact distance to t in the residual network (n_ if t is unreachable), by parallel BFS.
+    void global_relabel(int s, int t, std::vector<int> &label, int threads) const;
+    // Sends all excess[v] > 0 back to s through the residual network.
+    void return_excess(int s, const std::vector<Weight> &excess);
+
+    int n_;
+    std::vector<std::vector<Arc>> g_;
+    // lvl_: BFS level (-1 once a node is known to be dead in this phase); it_: current arc.
+    std::vector<int> lvl_, it_;
+    // Nodes of the current s->t descent; the arc taken from path_[i] is g_[path_[i]][it_[..]].
+    std::vector<int> path_;
+};
@@ -1,15 +1,24 @@
 #include "MinimumBisectionSolver.h"
+#include "CompressedGraph.h"
+#include "FlowRefinement.h"
 
-MinimumBisectionSolver::MinimumBisectionSolver(int max_passes)
+// Imbalance the flow corridor may explore before the result is rebalanced to |A|-|B| <= 1.
+static constexpr double flow_epsilon = 0.3;
+
+template<typename Graph>
+BasicMinimumBisectionSolver<Graph>::BasicMinimumBisectionSolver(int max_passes, int flow_rounds)
     : max_passes_(max_passes)
+    , flow_rounds_(flow_rounds)
 {}
 
-std::string MinimumBisectionSolver::name() const
+template<typename Graph>
+std::string BasicMinimumBisectionSolver<Graph>::name() const
 {
     return "Minimum Bisection (Heuristic KL-style swaps)";
 }
 
-std::string MinimumBisectionSolver::statement() const
+template<typename Graph>
+std::string BasicMinimumBisectionSolver<Graph>::statement() const
 {
     return "Input: undirected weighted graph G=(V,E,w) with w(e) >= 0.\n"
            "Goal: split vertex set into two blocks A and B such that:\n"
@@ -20,13 +29,16 @@ std::string MinimumBisectionSolver::statement() const
            "Output: part[v]=0 means v in A, part[v]=1 means v in B.";
 }
 
-std::string MinimumBisectionSolver::complexity() const
+template<typename Graph>
+std::string BasicMinimumBisectionSolver<Graph>::complexity() const
 {
     return "Optimization is NP-hard. This heuristic is typically O(p*n^2 + p*m) where "
-           "p=passes.";
+           "p=passes, plus r flow-refinement rounds of O(V^2*E) Dinic each on a corridor around "
+           "the cut.";
 }
 
-void MinimumBisectionSolver::solve(const WeightedGraph &g)
+template<typename Graph>
+void BasicMinimumBisectionSolver<Graph>::solve(const Graph &g)
 {
     if (g.n == 0) {
         res_ = {};
@@ -34,16 +46,33 @@ void MinimumBisectionSolver::solve(const WeightedGraph &g)
     }
     std::vector<int> all(g.n);
     std::iota(all.begin(), all.end(), 0);
-    res_.part = bisection_on_subset(g, all, max_passes_);
+    const SolveControl *control = this->control_;
+    res_.part = bisection_on_subset(g, all, max_passes_, control);
     res_.cut_weight = cut_weight_undirected(g, res_.part);
+
+    if (flow_rounds_ > 0 && g.n >= 4 && !should_stop(control)) {
+        auto part = res_.part;
+        if (flow_refine_bisection(g, part, flow_epsilon, flow_rounds_)) {
+            rebalance_bisection(g, part, (g.n + 1) / 2);
+            Weight cut = cut_weight_undirected(g, part);
+            if (cut < res_.cut_weight) {
+                res_.part = std::move(part);
+                res_.cut_weight = cut;
+            }
+        }
+        report_progress(control, "flow refinement", flow_rounds_, res_.cut_weight);
+    }
+    res_.stopped_early = was_stopped(control);
 }
 
-PartitionResult MinimumBisectionSolver::result() const
+template<typename Graph>
+PartitionResult BasicMinimumBisectionSolver<Graph>::result() const
 {
     return res_;
 }
 
-void MinimumBisectionSolver::print(std::ostream &os) const
+template<typename Graph>
+void BasicMinimumBisectionSolver<Graph>::print(std::ostream &os) const
 {
     os << "\n=== " << name() << " ===\n";
     os << "Problem: " << statement() << "\n";
@@ -57,9 +86,14 @@ void MinimumBisectionSolver::print(std::ostream &os) const
     os << "\n";
 }
 
-std::vector<int> MinimumBisectionSolver::bisection_on_subset(const WeightedGraph &g,
-                                                             const std::vector<int> &vertices,
-                                                             int max_passes)
+template<typename Graph>
+std::vector<int>
+BasicMinimumBisectionSolver<Graph>::bisection_on_subset(const Graph &g,
+                                                        const std::vector<int> &vertices,
+                                                        int max_passes,
+                                                        const SolveControl *control,
+                                                        InitialBisection initial,
+                                                        const SpectralOptions &spectral)
 {
     int n = g.n;
     std::vector<bool> in(n, 0);
@@ -69,7 +103,8 @@ std::vector<int> MinimumBisectionSolver::bisection_on_subset(const WeightedGraph
     int targetA = (s + 1) / 2;
 
     std::vector<int> part(n, -1);
-    auto order = order_by_internal_degree(g, vertices);
+    auto order = initial == InitialBisection::Spectral ? spectral_order(g, vertices, spectral)
+                                                       : order_by_internal_degree(g, vertices);
     int cntA = 0;
     for (int v : order) {
         if (cntA < targetA) {
@@ -99,15 +134,20 @@ std::vector<int> MinimumBisectionSolver::bisection_on_subset(const WeightedGraph
         return D;
     };
 
-    for (int pass = 0; pass < max_passes; ++pass) {
+    for (int pass = 0; pass < max_passes && !should_stop(control); ++pass) {
         bool improved = false;
         auto D = compute_D(part);
 
         Weight best_gain = 0;
         int best_u = -1, best_v = -1;
 
+        // A pass is O(n^2); poll the control every 64 candidates so deadlines hold on large
+        // inputs. An interrupted pass still applies the best swap found so far.
+        int scanned = 0;
         for (int u : vertices)
             if (part[u] == 0) {
+                if ((++scanned & 63) == 0 && should_stop(control))
+                    break;
                 for (int v : vertices)
                     if (part[v] == 1) {
                         Weight wuv = 0;
@@ -130,6 +170,7 @@ std::vector<int> MinimumBisectionSolver::bisection_on_subset(const WeightedGraph
             improved = true;
         }
 
+        report_progress(control, "swap pass", pass);
         if (!improved)
             break;
     }
@@ -139,3 +180,8 @@ std::vector<int> MinimumBisectionSolver::bisection_on_subset(const WeightedGraph
             part[u] = 0;
     return part;
 }
+
+template class BasicMinimumBisectionSolver<WeightedGraph>;
+template class BasicMinimumBisectionSolver<CompactWeightedGraph>;
+template class BasicMinimumBisectionSolver<UnweightedGraph>;
+template class BasicMinimumBisectionSolver<CompressedGraph>;
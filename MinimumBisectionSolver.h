@@ -1,22 +1,36 @@
 #pragma once
 #include "GraphPartitionSolver.h"
+#include "SpectralBisection.h"
 
-class MinimumBisectionSolver final : public IGraphPartitionSolver
+template<typename Graph>
+class BasicMinimumBisectionSolver final : public IBasicGraphPartitionSolver<Graph>
 {
 public:
-    explicit MinimumBisectionSolver(int max_passes = 20);
+    // flow_rounds > 0 polishes the swap result with flow_refine_bisection (FlowRefinement.h) and
+    // rebalances it; 0 keeps the plain swap heuristic.
+    explicit BasicMinimumBisectionSolver(int max_passes = 20, int flow_rounds = 3);
     std::string name() const override;
     std::string statement() const override;
     std::string complexity() const override;
-    void solve(const WeightedGraph &g) override;
+    void solve(const Graph &g) override;
     PartitionResult result() const override;
     void print(std::ostream &os) const override;
 
-    static std::vector<int> bisection_on_subset(const WeightedGraph &g,
-                                                const std::vector<int> &vertices,
-                                                int max_passes);
+    // Stops swapping once control->should_stop(); the split is balanced after every pass.
+    // `initial` picks the order whose first half forms the starting block A; `spectral` only
+    // applies to InitialBisection::Spectral.
+    static std::vector<int>
+    bisection_on_subset(const Graph &g,
+                        const std::vector<int> &vertices,
+                        int max_passes,
+                        const SolveControl *control = nullptr,
+                        InitialBisection initial = InitialBisection::DegreeOrder,
+                        const SpectralOptions &spectral = {});
 
 private:
     int max_passes_;
+    int flow_rounds_;
     PartitionResult res_;
 };
+
+using MinimumBisectionSolver = BasicMinimumBisectionSolver<WeightedGraph>;
@@ -1,9 +1,47 @@
 #include "MultilevelKWayPartitionSolver.h"
+#include "CompressedGraph.h"
+#include "GraphFile.h"
 #include "KWayPartitionSolver.h"
+#include "PartitionMetrics.h"
 #include <unordered_map>
 
+template<typename Graph>
+void block_connectivity(
+    const Graph &g, const std::vector<int> &part, int k, int u, std::vector<Weight> &weights)
+{
+    std::fill(weights.begin(), weights.end(), 0);
+    if constexpr (kernels::has_row_kernels<typename Graph::Edge>::value) {
+        kernels::row_block_weights(
+            g.adj[u].data(), g.adj[u].size(), part.data(), k, weights.data());
+    } else {
+        for (auto &e : g.adj[u]) {
+            int q = part[e.to];
+            if (q >= 0 && q < k)
+                weights[q] += e.w;
+        }
+    }
+}
+
 namespace {
-static WeightedGraph coarsen_graph(const WeightedGraph &g, std::vector<int> &fine_to_coarse)
+// Whether u and v may be merged: never two vertices pinned to different blocks, nor two
+// vertices of different groups (empty vectors impose nothing).
+static bool
+can_merge(const std::vector<int> &fixed, const std::vector<int> &groups, int u, int v)
+{
+    if (!groups.empty() && groups[u] != groups[v])
+        return false;
+    return fixed.empty() || fixed[u] == -1 || fixed[v] == -1 || fixed[u] == fixed[v];
+}
+
+// Heavy-edge matching. fixed (empty, or one entry per vertex) forbids merging vertices pinned
+// to different blocks, groups (likewise) vertices of different groups; coarse_fixed receives
+// the pins of the coarse vertices.
+template<typename Graph>
+static typename Graph::coarse_graph coarsen_graph(const Graph &g,
+                                                  std::vector<int> &fine_to_coarse,
+                                                  const std::vector<int> &fixed,
+                                                  const std::vector<int> &groups,
+                                                  std::vector<int> &coarse_fixed)
 {
     int n = g.n;
     fine_to_coarse.assign(n, -1);
@@ -28,6 +66,8 @@ static WeightedGraph coarsen_graph(const WeightedGraph &g, std::vector<int> &fin
             int v = e.to;
             if (matched[v])
                 continue;
+            if (!can_merge(fixed, groups, u, v))
+                continue;
             if (e.w > best_w) {
                 best_w = e.w;
                 best = v;
@@ -44,7 +84,15 @@ static WeightedGraph coarsen_graph(const WeightedGraph &g, std::vector<int> &fin
         }
     }
 
-    WeightedGraph coarse(coarse_n);
+    coarse_fixed.clear();
+    if (!fixed.empty()) {
+        coarse_fixed.assign(coarse_n, -1);
+        for (int u = 0; u < n; ++u)
+            if (fixed[u] != -1)
+                coarse_fixed[fine_to_coarse[u]] = fixed[u];
+    }
+
+    typename Graph::coarse_graph coarse(coarse_n);
     std::vector<std::unordered_map<int, Weight>> adj_map(coarse_n);
     for (int u = 0; u < n; ++u) {
         int cu = fine_to_coarse[u];
@@ -69,44 +117,500 @@ static WeightedGraph coarsen_graph(const WeightedGraph &g, std::vector<int> &fin
     return coarse;
 }
 
-static void refine_partition(const WeightedGraph &g,
+// Moves free vertices out of blocks heavier than max_size, smallest cut increase first, into
+// blocks that stay within max_size. One scan over the rows plus a sort of the candidates.
+template<typename Graph>
+static void rebalance_blocks(const Graph &g,
                              std::vector<int> &part,
                              int k,
-                             int max_passes)
+                             std::vector<Weight> &sizes,
+                             Weight max_size,
+                             const std::vector<int> &fixed,
+                             const std::vector<Weight> &vertex_weights,
+                             std::vector<Weight> &weights)
+{
+    bool over = false;
+    for (int q = 0; q < k; ++q)
+        over |= sizes[q] > max_size;
+    if (!over)
+        return;
+
+    struct Candidate
+    {
+        Weight gain;
+        int u;
+        int to;
+    };
+    std::vector<Candidate> candidates;
+    for (int u = 0; u < g.n; ++u) {
+        int p = part[u];
+        if (p < 0 || p >= k || sizes[p] <= max_size || (!fixed.empty() && fixed[u] != -1))
+            continue;
+        block_connectivity(g, part, k, u, weights);
+        int best = -1;
+        for (int q = 0; q < k; ++q)
+            if (q != p && sizes[q] < max_size && (best == -1 || weights[q] > weights[best]))
+                best = q;
+        if (best != -1)
+            candidates.push_back({weights[best] - weights[p], u, best});
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        if (a.gain != b.gain)
+            return a.gain > b.gain;
+        return a.u < b.u;
+    });
+    for (auto &c : candidates) {
+        int p = part[c.u];
+        Weight w = vertex_weights.empty() ? 1 : vertex_weights[c.u];
+        if (sizes[p] <= max_size)
+            continue;
+        int to = c.to;
+        if (sizes[to] + w > max_size) {
+            // The preferred block filled up meanwhile: take the lightest one with room.
+            to = (int) (std::min_element(sizes.begin(), sizes.end()) - sizes.begin());
+            if (to == p || sizes[to] + w > max_size)
+                continue;
+        }
+        part[c.u] = to;
+        sizes[p] -= w;
+        sizes[to] += w;
+    }
+}
+
+// Recursive-bisection partition of the coarsest graph. With pinned vertices, block labels are
+// first renamed greedily to agree with as many pins as possible, then the pins are enforced.
+template<typename Graph>
+static std::vector<int> initial_partition(const Graph &g,
+                                          int k,
+                                          int bisection_passes,
+                                          const std::vector<int> &fixed,
+                                          const SolveControl *control,
+                                          InitialBisection initial,
+                                          const SpectralOptions &spectral)
+{
+    BasicKWayPartitionSolver<Graph> base(k, bisection_passes);
+    base.set_control(control);
+    base.set_initial_bisection(initial, spectral);
+    base.solve(g);
+    std::vector<int> part = base.result().part;
+    if (fixed.empty())
+        return part;
+
+    std::vector<long long> agree((size_t) k * k, 0);
+    for (int v = 0; v < g.n; ++v)
+        if (fixed[v] != -1)
+            agree[(size_t) part[v] * k + fixed[v]]++;
+    std::vector<std::pair<long long, int>> pairs;
+    for (int i = 0; i < k * k; ++i)
+        if (agree[i] > 0)
+            pairs.push_back({-agree[i], i});
+    std::sort(pairs.begin(), pairs.end());
+    std::vector<int> rename(k, -1);
+    std::vector<char> taken(k, 0);
+    for (auto &p : pairs) {
+        int from = p.second / k, to = p.second % k;
+        if (rename[from] == -1 && !taken[to]) {
+            rename[from] = to;
+            taken[to] = 1;
+        }
+    }
+    for (int from = 0, to = 0; from < k; ++from) {
+        if (rename[from] != -1)
+            continue;
+        while (taken[to])
+            ++to;
+        rename[from] = to;
+        taken[to] = 1;
+    }
+    for (int v = 0; v < g.n; ++v)
+        part[v] = fixed[v] != -1 ? fixed[v] : rename[part[v]];
+    return part;
+}
+
+// Block weight window of refine_kway_partition. With unit weights these are floor(n/k) and
+// ceil(n/k); heavier vertices widen the window by their weight so coarse levels can still move
+// them.
+static void block_bounds(int n,
+                         int k,
+                         const std::vector<Weight> &vertex_weights,
+                         Weight &min_size,
+                         Weight &max_size)
+{
+    Weight total = 0, heaviest = 0;
+    for (int u = 0; u < n; ++u) {
+        Weight w = vertex_weights.empty() ? 1 : vertex_weights[u];
+        total += w;
+        heaviest = std::max(heaviest, w);
+    }
+    min_size = total / k - (heaviest - 1);
+    max_size = (total + k - 1) / k + (heaviest - 1);
+}
+
+// Chunk size of the parallel loops. Per-chunk results are indexed by chunk, never by worker,
+// so the deterministic paths do not depend on how many workers claimed the chunks.
+static const int parallel_chunk = 1024;
+// Upper bound on the proposal rounds of deterministic matching.
+static const int matching_rounds = 16;
+
+// Seeded priority of the edge {u, v}, equal from both endpoints; breaks weight ties in
+// deterministic matching without favoring low ids.
+static std::uint64_t edge_priority(std::uint64_t seed, int u, int v)
+{
+    std::uint64_t h = seed * 0x9e3779b97f4a7c15ULL + (std::uint64_t) std::min(u, v);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h += (std::uint64_t) std::max(u, v);
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+// Synchronous heavy-edge matching: every round, each free vertex proposes to its heaviest free
+// compatible neighbor (ties by edge_priority, then by smaller id) and mutual proposals match.
+// Proposals read only the previous round's state, so the matching is thread-count independent.
+template<typename Graph>
+static void match_deterministic(const Graph &g,
+                                const std::vector<int> &fixed,
+                                const std::vector<int> &groups,
+                                const ParallelOptions &options,
+                                std::vector<int> &mate)
+{
+    int n = g.n;
+    mate.assign(n, -1);
+    std::vector<int> pref(n, -1);
+    for (int round = 0; round < matching_rounds; ++round) {
+        parallel_for_chunks(n, options.threads, parallel_chunk, [&](long long b, long long e, int) {
+            for (int u = (int) b; u < (int) e; ++u) {
+                pref[u] = -1;
+                if (mate[u] != -1)
+                    continue;
+                Weight best_w = -1;
+                std::uint64_t best_h = 0;
+                for (auto &ed : g.adj[u]) {
+                    int v = ed.to;
+                    if (v == u || mate[v] != -1 || !can_merge(fixed, groups, u, v))
+                        continue;
+                    Weight w = ed.w;
+                    std::uint64_t h = edge_priority(options.seed, u, v);
+                    bool better = w != best_w ? w > best_w : h != best_h ? h > best_h : v < pref[u];
+                    if (better) {
+                        best_w = w;
+                        best_h = h;
+                        pref[u] = v;
+                    }
+                }
+            }
+        });
+        std::atomic<bool> progress{false};
+        parallel_for_chunks(n, options.threads, parallel_chunk, [&](long long b, long long e, int) {
+            for (int u = (int) b; u < (int) e; ++u) {
+                int v = pref[u];
+                if (v != -1 && pref[v] == u) {
+                    mate[u] = v;
+                    progress = true;
+                }
+            }
+        });
+        if (!progress)
+            break;
+    }
+}
+
+// Greedy heavy-edge matching in which workers lock a vertex, then claim its heaviest free
+// neighbor with a compare-and-swap. Which claim wins depends on scheduling.
+template<typename Graph>
+static void match_fast(const Graph &g,
+                       const std::vector<int> &fixed,
+                       const std::vector<int> &groups,
+                       const ParallelOptions &options,
+                       std::vector<int> &mate)
+{
+    int n = g.n;
+    // -1 free, -2 locked by the worker matching it, otherwise the mate.
+    std::vector<std::atomic<int>> state(n);
+    for (auto &s : state)
+        s.store(-1, std::memory_order_relaxed);
+    parallel_for_chunks(n, options.threads, parallel_chunk, [&](long long b, long long e, int) {
+        for (int u = (int) b; u < (int) e; ++u) {
+            int expected = -1;
+            if (!state[u].compare_exchange_strong(expected, -2))
+                continue;
+            int best = -1;
+            Weight best_w = -1;
+            for (auto &ed : g.adj[u]) {
+                int v = ed.to;
+                if (v == u || state[v].load() != -1 || !can_merge(fixed, groups, u, v))
+                    continue;
+                if ((Weight) ed.w > best_w) {
+                    best_w = ed.w;
+                    best = v;
+                }
+            }
+            expected = -1;
+            if (best != -1 && state[best].compare_exchange_strong(expected, u))
+                state[u].store(best);
+            else
+                state[u].store(-1);
+        }
+    });
+    mate.assign(n, -1);
+    for (int u = 0; u < n; ++u)
+        mate[u] = std::max(-1, state[u].load());
+}
+
+// Parallel coarsen_graph for ParallelMode::Deterministic and ParallelMode::Fast. Coarse ids
+// follow the smaller id of each pair; each coarse row is built by one worker and sorted by
+// neighbor.
+template<typename Graph>
+static typename Graph::coarse_graph parallel_coarsen_graph(const Graph &g,
+                                                           std::vector<int> &fine_to_coarse,
+                                                           const std::vector<int> &fixed,
+                                                           const std::vector<int> &groups,
+                                                           std::vector<int> &coarse_fixed,
+                                                           const ParallelOptions &options)
+{
+    int n = g.n;
+    std::vector<int> mate;
+    if (options.mode == ParallelMode::Deterministic)
+        match_deterministic(g, fixed, groups, options, mate);
+    else
+        match_fast(g, fixed, groups, options, mate);
+
+    auto is_leader = [&](int u) { return mate[u] == -1 || u < mate[u]; };
+    long long chunks = (n + parallel_chunk - 1) / parallel_chunk;
+    std::vector<int> offset(chunks + 1, 0);
+    parallel_for_chunks(n, options.threads, parallel_chunk, [&](long long b, long long e, int) {
+        int count = 0;
+        for (int u = (int) b; u < (int) e; ++u)
+            count += is_leader(u);
+        offset[b / parallel_chunk + 1] = count;
+    });
+    std::partial_sum(offset.begin(), offset.end(), offset.begin());
+    int coarse_n = offset[chunks];
+    fine_to_coarse.assign(n, -1);
+    std::vector<int> leader(coarse_n);
+    parallel_for_chunks(n, options.threads, parallel_chunk, [&](long long b, long long e, int) {
+        int id = offset[b / parallel_chunk];
+        for (int u = (int) b; u < (int) e; ++u) {
+            if (!is_leader(u))
+                continue;
+            fine_to_coarse[u] = id;
+            if (mate[u] != -1)
+                fine_to_coarse[mate[u]] = id;
+            leader[id++] = u;
+        }
+    });
+
+    coarse_fixed.clear();
+    if (!fixed.empty()) {
+        coarse_fixed.assign(coarse_n, -1);
+        for (int u = 0; u < n; ++u)
+            if (fixed[u] != -1)
+                coarse_fixed[fine_to_coarse[u]] = fixed[u];
+    }
+
+    using CoarseGraph = typename Graph::coarse_graph;
+    using CoarseEdge = typename CoarseGraph::Edge;
+    CoarseGraph coarse(coarse_n);
+    // slot[worker][c]: position of coarse neighbor c in the row being built, -1 if absent.
+    std::vector<std::vector<int>> slot(resolve_threads(options.threads));
+    parallel_for_chunks(
+        coarse_n, options.threads, parallel_chunk, [&](long long b, long long e, int worker) {
+            auto &pos = slot[worker];
+            if (pos.empty())
+                pos.assign(coarse_n, -1);
+            for (int c = (int) b; c < (int) e; ++c) {
+                auto &row = coarse.adj[c];
+                for (int x : {leader[c], mate[leader[c]]}) {
+                    if (x == -1)
+                        continue;
+                    for (auto &ed : g.adj[x]) {
+                        int cv = fine_to_coarse[ed.to];
+                        if (cv == c)
+                            continue;
+                        if (pos[cv] == -1) {
+                            pos[cv] = (int) row.size();
+                            row.push_back({cv, (Weight) ed.w});
+                        } else {
+                            row[pos[cv]].w += ed.w;
+                        }
+                    }
+                }
+                for (auto &ed : row)
+                    pos[ed.to] = -1;
+                std::sort(row.begin(), row.end(), [](const CoarseEdge &a, const CoarseEdge &b) {
+                    return a.to < b.to;
+                });
+            }
+        });
+    return coarse;
+}
+
+// Takes w out of an atomic budget unless that would make it negative.
+static bool take_budget(std::atomic<Weight> &budget, Weight w)
+{
+    Weight cur = budget.load();
+    while (cur >= w)
+        if (budget.compare_exchange_weak(cur, cur - w))
+            return true;
+    return false;
+}
+
+// Parallel refine_kway_partition by synchronous label propagation. Every round first picks, in
+// parallel and against frozen labels and block weights, the best gainful target of each free
+// vertex, then applies the moves that keep the bounds. Deterministic mode applies them in id
+// order and alternates rounds that only move to higher and to lower block ids, so neighbors
+// never swap blocks in the same round. Fast mode applies them concurrently against atomic
+// in/out budgets per block.
+template<typename Graph>
+static void parallel_refine_kway_partition(const Graph &g,
+                                           std::vector<int> &part,
+                                           int k,
+                                           int max_passes,
+                                           const std::vector<int> &fixed,
+                                           const SolveControl *control,
+                                           const std::vector<Weight> &vertex_weights,
+                                           const ParallelOptions &options)
 {
     if (k <= 1)
         return;
     int n = g.n;
-    int min_size = n / k;
-    int max_size = (n + k - 1) / k;
+    auto vertex_weight = [&](int u) { return vertex_weights.empty() ? 1 : vertex_weights[u]; };
+    Weight min_size, max_size;
+    block_bounds(n, k, vertex_weights, min_size, max_size);
+    std::vector<Weight> sizes(k, 0);
+    for (int u = 0; u < n; ++u)
+        if (part[u] >= 0 && part[u] < k)
+            sizes[part[u]] += vertex_weight(u);
+
     std::vector<Weight> weights(k, 0);
-    for (int pass = 0; pass < max_passes; ++pass) {
-        std::vector<int> sizes(k, 0);
-        for (int p : part)
-            if (p >= 0 && p < k)
-                sizes[p]++;
+    rebalance_blocks(g, part, k, sizes, max_size, fixed, vertex_weights, weights);
+
+    bool deterministic = options.mode == ParallelMode::Deterministic;
+    std::vector<std::vector<Weight>> scratch(resolve_threads(options.threads));
+    std::vector<int> target(n, -1);
+    for (int pass = 0; pass < max_passes && !should_stop(control); ++pass) {
+        std::atomic<bool> moved{false};
+        for (int round = 0; round < (deterministic ? 2 : 1); ++round) {
+            parallel_for_chunks(
+                n, options.threads, parallel_chunk, [&](long long b, long long e, int worker) {
+                    auto &conn = scratch[worker];
+                    conn.resize(k);
+                    for (int u = (int) b; u < (int) e; ++u) {
+                        target[u] = -1;
+                        int p = part[u];
+                        if (p < 0 || p >= k)
+                            continue;
+                        Weight w_u = vertex_weight(u);
+                        if (sizes[p] - w_u < min_size || (!fixed.empty() && fixed[u] != -1))
+                            continue;
+                        block_connectivity(g, part, k, u, conn);
+                        Weight best_gain = 0;
+                        int lo = deterministic && round == 0 ? p + 1 : 0;
+                        int hi = deterministic && round == 1 ? p : k;
+                        for (int q = lo; q < hi; ++q) {
+                            if (q == p || sizes[q] + w_u > max_size)
+                                continue;
+                            Weight gain = conn[q] - conn[p];
+                            if (gain > best_gain) {
+                                best_gain = gain;
+                                target[u] = q;
+                            }
+                        }
+                    }
+                });
+
+            if (deterministic) {
+                for (int u = 0; u < n; ++u) {
+                    int q = target[u];
+                    if (q == -1)
+                        continue;
+                    int p = part[u];
+                    Weight w_u = vertex_weight(u);
+                    if (sizes[p] - w_u < min_size || sizes[q] + w_u > max_size)
+                        continue;
+                    part[u] = q;
+                    sizes[p] -= w_u;
+                    sizes[q] += w_u;
+                    moved = true;
+                }
+                continue;
+            }
+
+            // A block may lose at most sizes - min_size and gain at most max_size - sizes this
+            // round, whatever it receives or gives away meanwhile.
+            std::vector<std::atomic<Weight>> out_room(k), in_room(k);
+            for (int q = 0; q < k; ++q) {
+                out_room[q].store(std::max<Weight>(0, sizes[q] - min_size));
+                in_room[q].store(std::max<Weight>(0, max_size - sizes[q]));
+            }
+            parallel_for_chunks(
+                n, options.threads, parallel_chunk, [&](long long b, long long e, int) {
+                    for (int u = (int) b; u < (int) e; ++u) {
+                        int q = target[u];
+                        if (q == -1)
+                            continue;
+                        int p = part[u];
+                        Weight w_u = vertex_weight(u);
+                        if (!take_budget(out_room[p], w_u))
+                            continue;
+                        if (!take_budget(in_room[q], w_u)) {
+                            out_room[p].fetch_add(w_u);
+                            continue;
+                        }
+                        part[u] = q;
+                        moved = true;
+                    }
+                });
+            std::fill(sizes.begin(), sizes.end(), 0);
+            for (int u = 0; u < n; ++u)
+                if (part[u] >= 0 && part[u] < k)
+                    sizes[part[u]] += vertex_weight(u);
+        }
+        if (!moved)
+            break;
+    }
+}
+} // namespace
 
+template<typename Graph>
+void refine_kway_partition(const Graph &g,
+                           std::vector<int> &part,
+                           int k,
+                           int max_passes,
+                           const std::vector<int> &fixed,
+                           const SolveControl *control,
+                           const std::vector<Weight> &vertex_weights)
+{
+    if (k <= 1)
+        return;
+    int n = g.n;
+    auto vertex_weight = [&](int u) { return vertex_weights.empty() ? 1 : vertex_weights[u]; };
+    Weight min_size, max_size;
+    block_bounds(n, k, vertex_weights, min_size, max_size);
+    std::vector<Weight> sizes(k, 0);
+    for (int u = 0; u < n; ++u)
+        if (part[u] >= 0 && part[u] < k)
+            sizes[part[u]] += vertex_weight(u);
+
+    std::vector<Weight> weights(k, 0);
+    rebalance_blocks(g, part, k, sizes, max_size, fixed, vertex_weights, weights);
+    for (int pass = 0; pass < max_passes && !should_stop(control); ++pass) {
         bool moved = false;
         for (int u = 0; u < n; ++u) {
             int p = part[u];
             if (p < 0 || p >= k)
                 continue;
-            if (sizes[p] <= min_size)
+            Weight w_u = vertex_weight(u);
+            if (sizes[p] - w_u < min_size || (!fixed.empty() && fixed[u] != -1))
                 continue;
 
-            std::fill(weights.begin(), weights.end(), 0);
-            for (auto &e : g.adj[u]) {
-                int q = part[e.to];
-                if (q >= 0 && q < k)
-                    weights[q] += e.w;
-            }
+            block_connectivity(g, part, k, u, weights);
             Weight w_p = weights[p];
             int best = p;
             Weight best_gain = 0;
             for (int q = 0; q < k; ++q) {
                 if (q == p)
                     continue;
-                if (sizes[q] >= max_size)
+                if (sizes[q] + w_u > max_size)
                     continue;
                 Weight gain = weights[q] - w_p;
                 if (gain > best_gain) {
@@ -116,8 +620,8 @@ static void refine_partition(const WeightedGraph &g,
             }
             if (best != p && best_gain > 0) {
                 part[u] = best;
-                sizes[p]--;
-                sizes[best]++;
+                sizes[p] -= w_u;
+                sizes[best] += w_u;
                 moved = true;
             }
         }
@@ -125,105 +629,298 @@ static void refine_partition(const WeightedGraph &g,
             break;
     }
 }
-} // namespace
 
-MultilevelKWayPartitionSolver::MultilevelKWayPartitionSolver(int k,
-                                                             int bisection_passes,
-                                                             int refine_passes,
-                                                             int max_levels)
+template<typename Graph>
+BasicMultilevelKWayPartitionSolver<Graph>::BasicMultilevelKWayPartitionSolver(
+    int k,
+    int bisection_passes,
+    int refine_passes,
+    int max_levels,
+    std::vector<int> fixed,
+    std::vector<Weight> vertex_weights)
     : k_(k)
     , bisection_passes_(bisection_passes)
     , refine_passes_(refine_passes)
     , max_levels_(max_levels)
+    , fixed_(std::move(fixed))
+    , vertex_weights_(std::move(vertex_weights))
 {}
 
-std::string MultilevelKWayPartitionSolver::name() const
+template<typename Graph>
+void BasicMultilevelKWayPartitionSolver<Graph>::set_parallel(ParallelOptions options)
+{
+    parallel_ = options;
+}
+
+template<typename Graph>
+void BasicMultilevelKWayPartitionSolver<Graph>::set_initial_bisection(InitialBisection initial,
+                                                                      SpectralOptions spectral)
+{
+    initial_ = initial;
+    spectral_ = spectral;
+}
+
+template<typename Graph>
+void BasicMultilevelKWayPartitionSolver<Graph>::set_combine(std::vector<int> groups,
+                                                            std::vector<int> initial)
+{
+    groups_ = std::move(groups);
+    initial_part_ = std::move(initial);
+}
+
+template<typename Graph>
+std::string BasicMultilevelKWayPartitionSolver<Graph>::name() const
 {
     return "k-Way Balanced Partition (Multilevel coarsen-refine heuristic)";
 }
 
-std::string MultilevelKWayPartitionSolver::statement() const
+template<typename Graph>
+std::string BasicMultilevelKWayPartitionSolver<Graph>::statement() const
 {
     return "Input: undirected weighted graph G=(V,E,w) and integer k >= 2.\n"
            "Goal: assign each vertex a label part[v] in {0..k-1} defining k disjoint blocks "
            "V0..Vk-1:\n"
            "  - blocks are disjoint and their union is V\n"
            "  - balance (typical): block sizes are as equal as possible\n"
+           "  - optional fixed vertices: part[v] = fixed[v] wherever fixed[v] != -1\n"
            "Objective: minimize total inter-block cut weight:\n"
            "  Cut_k = sum of w(u,v) over edges {u,v} with part[u] != part[v].";
 }
 
-std::string MultilevelKWayPartitionSolver::complexity() const
+template<typename Graph>
+std::string BasicMultilevelKWayPartitionSolver<Graph>::complexity() const
 {
     return "Optimization is NP-hard. Multilevel heuristic: O(L*m) coarsening + coarse "
            "partitioning + O(L*(m + n*k)) refinement (varies by level).";
 }
 
-void MultilevelKWayPartitionSolver::solve(const WeightedGraph &g)
+template<typename Graph>
+void BasicMultilevelKWayPartitionSolver<Graph>::solve(const Graph &g)
 {
     res_ = {};
+    if (!fixed_.empty()) {
+        if ((int) fixed_.size() != g.n)
+            throw std::invalid_argument("fixed must have one entry per vertex");
+        for (int f : fixed_)
+            if (f < -1 || f >= k_)
+                throw std::invalid_argument("fixed block out of range");
+    }
+    if (!vertex_weights_.empty()) {
+        if ((int) vertex_weights_.size() != g.n)
+            throw std::invalid_argument("vertex_weights must have one entry per vertex");
+        for (Weight w : vertex_weights_)
+            if (w < 0)
+                throw std::invalid_argument("vertex weight must be nonnegative");
+    }
+    if (!groups_.empty() && (int) groups_.size() != g.n)
+        throw std::invalid_argument("groups must have one entry per vertex");
+    if (!initial_part_.empty()) {
+        if ((int) initial_part_.size() != g.n)
+            throw std::invalid_argument("initial partition must have one entry per vertex");
+        // The projection onto the coarsest level needs one block per group.
+        std::unordered_map<int, int> group_block;
+        for (int v = 0; v < g.n; ++v) {
+            if (initial_part_[v] < 0 || initial_part_[v] >= k_)
+                throw std::invalid_argument("initial block out of range");
+            if (!fixed_.empty() && fixed_[v] != -1 && fixed_[v] != initial_part_[v])
+                throw std::invalid_argument("initial partition disagrees with fixed");
+            if (!groups_.empty()
+                && group_block.emplace(groups_[v], initial_part_[v]).first->second
+                       != initial_part_[v])
+                throw std::invalid_argument("initial partition must be constant on every group");
+        }
+    }
     if (g.n == 0)
         return;
     int k = std::max(1, std::min(k_, g.n));
     res_.part.assign(g.n, 0);
+    if (k < k_ && !fixed_.empty()) {
+        // Fewer vertices than blocks: keep the pins, the rest stays in block 0.
+        for (int v = 0; v < g.n; ++v)
+            res_.part[v] = std::max(0, fixed_[v]);
+        res_.cut_weight = cut_weight_undirected(g, res_.part);
+        return;
+    }
     if (k == 1) {
         res_.cut_weight = 0;
         return;
     }
 
-    std::vector<WeightedGraph> graphs;
-    graphs.push_back(g);
+    // Level 0 is the input graph itself; coarse[i] is level i+1 and maps[i] projects level i
+    // onto level i+1.
+    using CoarseGraph = typename Graph::coarse_graph;
+    std::vector<CoarseGraph> coarse;
     std::vector<std::vector<int>> maps;
+    // fixed_levels[i] holds the pins of level i (empty when nothing is pinned).
+    std::vector<std::vector<int>> fixed_levels{fixed_};
+    // weight_levels[i] holds the vertex weights of level i (empty: unit weights).
+    std::vector<std::vector<Weight>> weight_levels{vertex_weights_};
+    // group_levels[i] holds the merge groups of level i (empty: no restriction).
+    std::vector<std::vector<int>> group_levels{groups_};
+    auto coarsest_n = [&] { return coarse.empty() ? g.n : coarse.back().n; };
+    const SolveControl *control = this->control_;
     int min_coarse = std::max(2 * k, 20);
-    for (int level = 0; level < max_levels_ && graphs.back().n > min_coarse; ++level) {
-        std::vector<int> map;
-        WeightedGraph coarse = coarsen_graph(graphs.back(), map);
-        if (coarse.n >= graphs.back().n)
+    for (int level = 0; level < max_levels_ && coarsest_n() > min_coarse && !should_stop(control);
+         ++level) {
+        std::vector<int> map, next_fixed;
+        const auto &fixed = fixed_levels.back();
+        const auto &groups = group_levels.back();
+        auto coarsen = [&](const auto &fine) {
+            if (parallel_.mode == ParallelMode::Sequential)
+                return coarsen_graph(fine, map, fixed, groups, next_fixed);
+            return parallel_coarsen_graph(fine, map, fixed, groups, next_fixed, parallel_);
+        };
+        CoarseGraph next = coarse.empty() ? coarsen(g) : coarsen(coarse.back());
+        if (next.n >= coarsest_n())
             break;
+        const auto &fine_weights = weight_levels.back();
+        std::vector<Weight> next_weights(next.n, 0);
+        for (int u = 0; u < (int) map.size(); ++u)
+            next_weights[map[u]] += fine_weights.empty() ? 1 : fine_weights[u];
+        weight_levels.push_back(std::move(next_weights));
+        std::vector<int> next_groups;
+        if (!groups.empty()) {
+            next_groups.assign(next.n, 0);
+            for (int u = 0; u < (int) map.size(); ++u)
+                next_groups[map[u]] = groups[u];
+        }
+        group_levels.push_back(std::move(next_groups));
         maps.push_back(std::move(map));
-        graphs.push_back(std::move(coarse));
+        coarse.push_back(std::move(next));
+        fixed_levels.push_back(std::move(next_fixed));
+        report_progress(control, "coarsen level", level);
     }
 
-    KWayPartitionSolver base(k, bisection_passes_);
-    base.solve(graphs.back());
-    std::vector<int> part = base.result().part;
+    auto refine = [&](const auto &graph, std::vector<int> &part, int level) {
+        if (parallel_.mode == ParallelMode::Sequential)
+            refine_kway_partition(
+                graph, part, k, refine_passes_, fixed_levels[level], control, weight_levels[level]);
+        else
+            parallel_refine_kway_partition(graph,
+                                           part,
+                                           k,
+                                           refine_passes_,
+                                           fixed_levels[level],
+                                           control,
+                                           weight_levels[level],
+                                           parallel_);
+    };
+
+    const auto &coarsest_fixed = fixed_levels.back();
+    std::vector<int> part;
+    // The recursive bisection balances vertex counts; refining once more on the coarsest
+    // level restores the weight balance.
+    if (!initial_part_.empty() && k == k_) {
+        // Groups refine the given partition, so it projects exactly onto the coarsest level.
+        part = initial_part_;
+        for (int level = 0; level < (int) maps.size(); ++level) {
+            std::vector<int> coarse_part(coarse[level].n, 0);
+            for (int u = 0; u < (int) maps[level].size(); ++u)
+                coarse_part[maps[level][u]] = part[u];
+            part = std::move(coarse_part);
+        }
+        if (coarse.empty())
+            refine(g, part, 0);
+        else
+            refine(coarse.back(), part, (int) coarse.size());
+    } else if (coarse.empty()) {
+        part = initial_partition(
+            g, k, bisection_passes_, coarsest_fixed, control, initial_, spectral_);
+        refine(g, part, 0);
+    } else {
+        part = initial_partition(
+            coarse.back(), k, bisection_passes_, coarsest_fixed, control, initial_, spectral_);
+        refine(coarse.back(), part, (int) coarse.size());
+    }
 
-    for (int level = (int) graphs.size() - 2; level >= 0; --level) {
+    // Once stopped, the remaining levels are only projected (refinement returns immediately).
+    for (int level = (int) maps.size() - 1; level >= 0; --level) {
         const auto &map = maps[level];
-        std::vector<int> fine_part(graphs[level].n, 0);
-        for (int u = 0; u < graphs[level].n; ++u)
+        std::vector<int> fine_part(map.size(), 0);
+        for (int u = 0; u < (int) map.size(); ++u)
             fine_part[u] = part[map[u]];
         part = std::move(fine_part);
-        refine_partition(graphs[level], part, k, refine_passes_);
+        if (level == 0)
+            refine(g, part, 0);
+        else
+            refine(coarse[level - 1], part, level);
+        report_progress(control, "refine level", level);
     }
 
     res_.part = std::move(part);
     res_.cut_weight = cut_weight_undirected(g, res_.part);
+    res_.stopped_early = was_stopped(control);
 }
 
-PartitionResult MultilevelKWayPartitionSolver::result() const
+template<typename Graph>
+PartitionResult BasicMultilevelKWayPartitionSolver<Graph>::result() const
 {
     return res_;
 }
 
-void MultilevelKWayPartitionSolver::print(std::ostream &os) const
+template<typename Graph>
+void BasicMultilevelKWayPartitionSolver<Graph>::print(std::ostream &os) const
 {
     os << "\n=== " << name() << " ===\n";
     os << "Problem: " << statement() << "\n";
     os << "Complexity: " << complexity() << "\n";
     if (!res_.part.empty()) {
-        std::vector<int> sizes;
-        int maxp = *std::max_element(res_.part.begin(), res_.part.end());
-        sizes.assign(maxp + 1, 0);
-        for (int p : res_.part)
-            sizes[p]++;
-        os << "Result: k=" << sizes.size() << " cut=" << res_.cut_weight << " sizes=[";
-        for (size_t i = 0; i < sizes.size(); ++i) {
-            if (i)
-                os << ",";
-            os << sizes[i];
-        }
-        os << "]\n";
+        auto sizes = partition_block_sizes(res_.part, 0, vertex_weights_);
+        os << "Result: k=" << sizes.size() << " cut=" << res_.cut_weight << " ";
+        print_block_sizes(os, sizes);
+        os << "\n";
     }
     os << "\n";
 }
+
+template class BasicMultilevelKWayPartitionSolver<WeightedGraph>;
+template class BasicMultilevelKWayPartitionSolver<CompactWeightedGraph>;
+template class BasicMultilevelKWayPartitionSolver<UnweightedGraph>;
+template class BasicMultilevelKWayPartitionSolver<CompressedGraph>;
+
+template void refine_kway_partition(const WeightedGraph &,
+                                    std::vector<int> &,
+                                    int,
+                                    int,
+                                    const std::vector<int> &,
+                                    const SolveControl *,
+                                    const std::vector<Weight> &);
+template void refine_kway_partition(const CompactWeightedGraph &,
+                                    std::vector<int> &,
+                                    int,
+                                    int,
+                                    const std::vector<int> &,
+                                    const SolveControl *,
+                                    const std::vector<Weight> &);
+template void refine_kway_partition(const UnweightedGraph &,
+                                    std::vector<int> &,
+                                    int,
+                                    int,
+                                    const std::vector<int> &,
+                                    const SolveControl *,
+                                    const std::vector<Weight> &);
+template void refine_kway_partition(const CompressedGraph &,
+                                    std::vector<int> &,
+                                    int,
+                                    int,
+                                    const std::vector<int> &,
+                                    const SolveControl *,
+                                    const std::vector<Weight> &);
+template void refine_kway_partition(const GraphFile &,
+                                    std::vector<int> &,
+                                    int,
+                                    int,
+                                    const std::vector<int> &,
+                                    const SolveControl *,
+                                    const std::vector<Weight> &);
+
+template void block_connectivity(
+    const WeightedGraph &, const std::vector<int> &, int, int, std::vector<Weight> &);
+template void block_connectivity(
+    const CompactWeightedGraph &, const std::vector<int> &, int, int, std::vector<Weight> &);
+template void block_connectivity(
+    const UnweightedGraph &, const std::vector<int> &, int, int, std::vector<Weight> &);
+template void block_connectivity(
+    const CompressedGraph &, const std::vector<int> &, int, int, std::vector<Weight> &);
+template void block_connectivity(
+    const GraphFile &, const std::vector<int> &, int, int, std::vector<Weight> &);
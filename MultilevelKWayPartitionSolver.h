@@ -1,19 +1,71 @@
 #pragma once
 #include "GraphPartitionSolver.h"
+#include "ParallelUtils.h"
+#include "SpectralBisection.h"
 
-class MultilevelKWayPartitionSolver final : public IGraphPartitionSolver
+// Greedy refinement used on every uncoarsening level. Block sizes are sums of vertex_weights
+// (empty: unit weights) and must lie in [W/k, ceil(W/k)], widened by the heaviest vertex
+// weight minus one. Blocks above the bound are first drained, cheapest moves first; then up to
+// max_passes sweeps over the vertices in id order move a vertex to the block it is most
+// connected to when that lowers the cut and keeps the bounds. Pinned vertices
+// (fixed[v] != -1) stay. Reads the rows in order, so it also runs on a streamed GraphFile.
+template<typename Graph>
+void refine_kway_partition(const Graph &g,
+                           std::vector<int> &part,
+                           int k,
+                           int max_passes,
+                           const std::vector<int> &fixed = {},
+                           const SolveControl *control = nullptr,
+                           const std::vector<Weight> &vertex_weights = {});
+
+// weights[q] = total weight of u's edges into block q; weights has k entries, and edges to
+// vertices labeled outside [0, k) are skipped.
+template<typename Graph>
+void block_connectivity(
+    const Graph &g, const std::vector<int> &part, int k, int u, std::vector<Weight> &weights);
+
+template<typename Graph>
+class BasicMultilevelKWayPartitionSolver final : public IBasicGraphPartitionSolver<Graph>
 {
 public:
-    explicit MultilevelKWayPartitionSolver(int k,
-                                           int bisection_passes = 8,
-                                           int refine_passes = 4,
-                                           int max_levels = 10);
+    // fixed is empty or has one entry per vertex: fixed[v] in [0, k) pins v to that block,
+    // -1 leaves it free. Pinned vertices are only matched with compatible vertices while
+    // coarsening and are never moved by refinement. vertex_weights (empty: all 1) are what
+    // the blocks balance; coarse vertices weigh the sum of the vertices they merge.
+    explicit BasicMultilevelKWayPartitionSolver(int k,
+                                                int bisection_passes = 8,
+                                                int refine_passes = 4,
+                                                int max_levels = 10,
+                                                std::vector<int> fixed = {},
+                                                std::vector<Weight> vertex_weights = {});
 
     std::string name() const override;
     std::string statement() const override;
     std::string complexity() const override;
 
-    void solve(const WeightedGraph &g) override;
+    // Coarsening and refinement threads (default: sequential). Deterministic mode matches by
+    // mutual heaviest-edge proposals in synchronous rounds (ties broken by a seeded hash of the
+    // edge) and refines by synchronous label propagation with moves applied in id order, so the
+    // result is identical for every thread count. Fast mode matches by first-come claims and
+    // applies moves concurrently; it is quicker but not reproducible. The coarsest-level
+    // partition is sequential in every mode.
+    void set_parallel(ParallelOptions options);
+
+    // Seed of the recursive bisections that partition the coarsest graph (default:
+    // internal-degree order). InitialBisection::Spectral starts each split from the Fiedler
+    // vector of the part being split.
+    void set_initial_bisection(InitialBisection initial, SpectralOptions spectral = {});
+
+    // Combine mode for evolutionary search (EvolutionarySolver.h). groups (empty, or one entry
+    // per vertex) forbids merging vertices of different groups, so an edge is never contracted
+    // when its endpoints differ in groups[]; initial (empty, or one block in [0, k) per vertex,
+    // constant on every group) then projects exactly onto the coarsest level and replaces the
+    // recursive bisection there. Groups p1[v] * k + p2[v] with initial = p1 keep every edge cut
+    // by either parent partition uncontracted; refinement starts from p1 on every level, so the
+    // child is rarely worse than p1. Empty vectors restore the default.
+    void set_combine(std::vector<int> groups, std::vector<int> initial);
+
+    void solve(const Graph &g) override;
 
     PartitionResult result() const override;
 
@@ -24,5 +76,14 @@ private:
     int bisection_passes_;
     int refine_passes_;
     int max_levels_;
+    std::vector<int> fixed_;
+    std::vector<Weight> vertex_weights_;
+    ParallelOptions parallel_;
+    InitialBisection initial_ = InitialBisection::DegreeOrder;
+    SpectralOptions spectral_;
+    std::vector<int> groups_;
+    std::vector<int> initial_part_;
     PartitionResult res_;
 };
+
+using MultilevelKWayPartitionSolver = BasicMultilevelKWayPartitionSolver<WeightedGraph>;
@@ -0,0 +1,136 @@
+#include "MultiwayCutSolver.h"
+#include "MaxFlow.h"
+#include "ParallelUtils.h"
+#include "PartitionMetrics.h"
+
+template<typename Graph>
+BasicMultiwayCutSolver<Graph>::BasicMultiwayCutSolver(std::vector<std::vector<int>> terminals,
+                                                      int threads)
+    : terminals_(std::move(terminals))
+    , threads_(threads)
+{}
+
+template<typename Graph>
+std::string BasicMultiwayCutSolver<Graph>::name() const
+{
+    return "Multiway Cut (Isolating cuts via max-flow)";
+}
+
+template<typename Graph>
+std::string BasicMultiwayCutSolver<Graph>::statement() const
+{
+    return "Input: undirected weighted graph G=(V,E,w) and k >= 2 disjoint terminal sets "
+           "T0..Tk-1.\n"
+           "Goal: assign each vertex a label part[v] in {0..k-1} with part[v]=i for every v in "
+           "Ti.\n"
+           "Objective: minimize Cut_k = sum of w(u,v) over edges {u,v} with part[u] != "
+           "part[v].\n"
+           "No balance constraint: blocks may have any size.";
+}
+
+template<typename Graph>
+std::string BasicMultiwayCutSolver<Graph>::complexity() const
+{
+    return "NP-hard for k >= 3 (polynomial for k = 2). Isolating cuts: k max-flow computations "
+           "(Dinic, run in parallel), a (2 - 2/k)-approximation.";
+}
+
+template<typename Graph>
+void BasicMultiwayCutSolver<Graph>::solve(const Graph &g)
+{
+    res_ = {};
+    lower_bound_ = 0.0;
+    int n = g.n;
+    int k = (int) terminals_.size();
+    if (k < 2)
+        throw std::invalid_argument("multiway cut needs at least 2 terminal sets");
+    std::vector<int> owner(n, -1);
+    for (int i = 0; i < k; ++i) {
+        if (terminals_[i].empty())
+            throw std::invalid_argument("empty terminal set");
+        for (int v : terminals_[i]) {
+            if (v < 0 || v >= n)
+                throw std::out_of_range("terminal");
+            if (owner[v] != -1 && owner[v] != i)
+                throw std::invalid_argument("terminal sets overlap");
+            owner[v] = i;
+        }
+    }
+
+    // Isolating cut i: minimum cut between Ti and the union of the other terminal sets. The
+    // minimal source sides of these cuts are pairwise disjoint.
+    std::vector<Weight> cut(k, 0);
+    std::vector<std::vector<char>> side(k);
+    parallel_for_chunks(k, threads_, 1, [&](long long b, long long e, int) {
+        for (long long i = b; i < e; ++i) {
+            MaxFlow net(n + 2);
+            int s = n, t = n + 1;
+            for (int u = 0; u < n; ++u) {
+                for (auto &a : g.adj[u])
+                    if (u < a.to)
+                        net.add_undirected_edge(u, a.to, a.w);
+                if (owner[u] == i)
+                    net.add_edge(s, u, MaxFlow::infinite_capacity);
+                else if (owner[u] != -1)
+                    net.add_edge(u, t, MaxFlow::infinite_capacity);
+            }
+            cut[i] = net.max_flow(s, t);
+            side[i] = net.source_side(s);
+        }
+    });
+
+    // Keep every isolating cut except the heaviest; its terminal set takes the rest of V.
+    int heaviest = (int) (std::max_element(cut.begin(), cut.end()) - cut.begin());
+    res_.part.assign(n, heaviest);
+    for (int i = 0; i < k; ++i)
+        if (i != heaviest)
+            for (int v = 0; v < n; ++v)
+                if (side[i][v])
+                    res_.part[v] = i;
+
+    res_.cut_weight = cut_weight_undirected(g, res_.part);
+    Weight total = 0;
+    for (Weight c : cut)
+        total += c;
+    lower_bound_ = (double) total / 2.0;
+    // A posteriori ratio bound, never worse than approximation_guarantee().
+    res_.score = lower_bound_ > 0 ? (double) res_.cut_weight / lower_bound_ : 1.0;
+}
+
+template<typename Graph>
+PartitionResult BasicMultiwayCutSolver<Graph>::result() const
+{
+    return res_;
+}
+
+template<typename Graph>
+double BasicMultiwayCutSolver<Graph>::approximation_guarantee() const
+{
+    return 2.0 - 2.0 / (double) std::max<size_t>(2, terminals_.size());
+}
+
+template<typename Graph>
+double BasicMultiwayCutSolver<Graph>::lower_bound() const
+{
+    return lower_bound_;
+}
+
+template<typename Graph>
+void BasicMultiwayCutSolver<Graph>::print(std::ostream &os) const
+{
+    os << "\n=== " << name() << " ===\n";
+    os << "Problem: " << statement() << "\n";
+    os << "Complexity: " << complexity() << "\n";
+    if (!res_.part.empty()) {
+        auto sizes = partition_block_sizes(res_.part, (int) terminals_.size());
+        os << "Result: k=" << sizes.size() << " cut=" << res_.cut_weight << " ";
+        print_block_sizes(os, sizes);
+        os << " lower-bound=" << lower_bound_ << " ratio<=" << res_.score
+           << " guarantee=" << approximation_guarantee() << "\n";
+    }
+    os << "\n";
+}
+
+template class BasicMultiwayCutSolver<WeightedGraph>;
+template class BasicMultiwayCutSolver<CompactWeightedGraph>;
+template class BasicMultiwayCutSolver<UnweightedGraph>;
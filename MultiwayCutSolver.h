@@ -0,0 +1,30 @@
+#pragma once
+#include "GraphPartitionSolver.h"
+
+template<typename Graph>
+class BasicMultiwayCutSolver final : public IBasicGraphPartitionSolver<Graph>
+{
+public:
+    // terminals[i] is the i-th terminal set (k >= 2 nonempty, pairwise disjoint sets). The k
+    // isolating cuts run on up to `threads` workers (<= 0: all hardware threads).
+    explicit BasicMultiwayCutSolver(std::vector<std::vector<int>> terminals, int threads = 0);
+    std::string name() const override;
+    std::string statement() const override;
+    std::string complexity() const override;
+    void solve(const Graph &g) override;
+    PartitionResult result() const override;
+    void print(std::ostream &os) const override;
+
+    // Guaranteed ratio 2 - 2/k of the isolating-cut heuristic.
+    double approximation_guarantee() const;
+    // Lower bound on the optimal multiway cut: half the sum of all k isolating cuts.
+    double lower_bound() const;
+
+private:
+    std::vector<std::vector<int>> terminals_;
+    int threads_;
+    double lower_bound_ = 0.0;
+    PartitionResult res_;
+};
+
+using MultiwayCutSolver = BasicMultiwayCutSolver<WeightedGraph>;
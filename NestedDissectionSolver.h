@@ -0,0 +1,45 @@
+#pragma once
+#include "GraphPartitionSolver.h"
+
+// Node of the separator tree. The subtree rooted here owns permutation positions
+// [begin, end): the children's ranges come first, then this node's separator in
+// [separator_begin, end). A leaf has no children and owns its whole range as one block, with
+// separator_begin == end.
+struct SeparatorTreeNode
+{
+    int parent = -1;
+    int begin = 0;
+    int separator_begin = 0;
+    int end = 0;
+    std::vector<int> children;
+};
+
+template<typename Graph>
+class BasicNestedDissectionSolver final : public IBasicGraphPartitionSolver<Graph>
+{
+public:
+    explicit BasicNestedDissectionSolver(int leaf_size = 64,
+                                         int threads = 0,
+                                         int refine_passes = 4);
+    std::string name() const override;
+    std::string statement() const override;
+    std::string complexity() const override;
+    void solve(const Graph &g) override;
+    PartitionResult result() const override;
+    void print(std::ostream &os) const override;
+
+    // permutation()[i] is the vertex eliminated i-th.
+    const std::vector<int> &permutation() const;
+    // Nodes in preorder; node 0 is the root.
+    const std::vector<SeparatorTreeNode> &separator_tree() const;
+
+private:
+    int leaf_size_;
+    int threads_;
+    int refine_passes_;
+    std::vector<int> perm_;
+    std::vector<SeparatorTreeNode> tree_;
+    PartitionResult res_;
+};
+
+using NestedDissectionSolver = BasicNestedDissectionSolver<WeightedGraph>;
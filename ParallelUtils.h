@@ -0,0 +1,68 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <vector>
+
+// How a solver with a parallel path uses its threads.
+enum class ParallelMode {
+    Sequential,    // the sequential algorithms; threads are ignored
+    Deterministic, // synchronous rounds, seeded tie-breaking: same result for any thread count
+    Fast           // first-come first-served claims: faster, may differ between runs
+};
+
+struct ParallelOptions
+{
+    ParallelMode mode = ParallelMode::Sequential;
+    // Worker threads; <= 0 means all hardware threads.
+    int threads = 0;
+    // Seeds the tie-breaking between equally good choices (Deterministic mode).
+    std::uint64_t seed = 1;
+};
+
+// Number of worker threads to use for a requested count; <= 0 means all hardware threads.
+inline int resolve_threads(int threads)
+{
+    if (threads <= 0)
+        threads = (int) std::thread::hardware_concurrency();
+    return std::max(1, threads);
+}
+
+// Splits [0, n) into chunks of `chunk` indices that `threads` workers claim dynamically, and
+// calls fn(begin, end, worker) for each chunk, with worker in [0, threads). Runs inline when a
+// single worker suffices. The first exception thrown by a worker is rethrown to the caller.
+template<typename Fn>
+void parallel_for_chunks(long long n, int threads, long long chunk, Fn &&fn)
+{
+    chunk = std::max(1LL, chunk);
+    threads = (int) std::min<long long>(resolve_threads(threads), (n + chunk - 1) / chunk);
+    if (threads <= 1) {
+        for (long long b = 0; b < n; b += chunk)
+            fn(b, std::min(n, b + chunk), 0);
+        return;
+    }
+
+    std::atomic<long long> next{0};
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    auto worker = [&](int id) {
+        try {
+            for (long long b; !failed && (b = next.fetch_add(chunk)) < n;)
+                fn(b, std::min(n, b + chunk), id);
+        } catch (...) {
+            if (!failed.exchange(true))
+                error = std::current_exception();
+        }
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (int t = 1; t < threads; ++t)
+        pool.emplace_back(worker, t);
+    worker(0);
+    for (auto &t : pool)
+        t.join();
+    if (error)
+        std::rethrow_exception(error);
+}
@@ -0,0 +1,329 @@
+#include "PartitionCache.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+static inline std::uint64_t mix64(std::uint64_t h, std::uint64_t x)
+{
+    x *= 0x9e3779b97f4a7c15ULL;
+    x ^= x >> 29;
+    h = (h ^ x) * 0xbf58476d1ce4e5b9ULL;
+    return h ^ (h >> 31);
+}
+
+// Stored vertex id and edge weight types, e.g. "id32-w64"; graphs of different types can
+// fingerprint alike (a unit-weight graph stored weighted and unweighted).
+template<typename Graph>
+static std::string graph_type_name()
+{
+    std::string name = "id" + std::to_string(8 * sizeof(typename Graph::vertex_type));
+    if constexpr (Graph::is_weighted)
+        name += "-w" + std::to_string(8 * sizeof(typename Graph::weight_type));
+    else
+        name += "-unweighted";
+    return name;
+}
+
+static std::string hex64(std::uint64_t x)
+{
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", (unsigned long long) x);
+    return buf;
+}
+
+static std::uint64_t string_hash(const std::string &s)
+{
+    std::uint64_t h = 0xcbf29ce484222325ULL; // FNV-1a: stable across builds, unlike std::hash
+    for (unsigned char c : s)
+        h = (h ^ c) * 0x100000001b3ULL;
+    return h;
+}
+
+const char spill_magic[4] = {'G', 'P', 'C', '1'};
+
+template<typename T>
+static void write_pod(std::ostream &os, const T &v)
+{
+    os.write(reinterpret_cast<const char *>(&v), sizeof(T));
+}
+
+template<typename T>
+static bool read_pod(std::istream &is, T &v)
+{
+    return (bool) is.read(reinterpret_cast<char *>(&v), sizeof(T));
+}
+
+static void write_ints(std::ostream &os, const std::vector<int> &v)
+{
+    write_pod(os, (std::uint64_t) v.size());
+    os.write(reinterpret_cast<const char *>(v.data()), (std::streamsize) (v.size() * sizeof(int)));
+}
+
+static bool read_ints(std::istream &is, std::vector<int> &v)
+{
+    std::uint64_t size = 0;
+    if (!read_pod(is, size) || size > (std::uint64_t) std::numeric_limits<int>::max())
+        return false;
+    v.resize(size);
+    std::streamsize bytes = (std::streamsize) (size * sizeof(int));
+    return (bool) is.read(reinterpret_cast<char *>(v.data()), bytes);
+}
+} // namespace
+
+template<typename Graph>
+std::uint64_t graph_fingerprint(const Graph &g)
+{
+    std::uint64_t h = mix64(0x243f6a8885a308d3ULL, (std::uint64_t) g.n);
+    for (int u = 0; u < g.n; ++u) {
+        h = mix64(h, (std::uint64_t) g.adj[u].size());
+        for (auto &e : g.adj[u]) {
+            h = mix64(h, (std::uint64_t) e.to);
+            if constexpr (Graph::is_weighted)
+                h = mix64(h, (std::uint64_t) e.w);
+        }
+    }
+    return h;
+}
+
+bool PartitionCacheKey::operator==(const PartitionCacheKey &o) const
+{
+    return graph_hash == o.graph_hash && vertices == o.vertices && arcs == o.arcs
+           && graph_type == o.graph_type && config == o.config;
+}
+
+std::string PartitionCacheKey::to_string() const
+{
+    return hex64(graph_hash) + ":" + std::to_string(vertices) + ":" + std::to_string(arcs) + ":"
+           + graph_type + ":" + config;
+}
+
+PartitionCache::PartitionCache(std::size_t capacity, std::string spill_dir)
+    : capacity_(capacity)
+    , spill_dir_(std::move(spill_dir))
+{
+    if (!spill_dir_.empty())
+        std::filesystem::create_directories(spill_dir_);
+}
+
+bool PartitionCache::get(const PartitionCacheKey &key, PartitionResult &out)
+{
+    std::string k = key.to_string();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(k);
+    if (it != index_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        out = it->second->second;
+        ++hits_;
+        return true;
+    }
+    PartitionResult loaded;
+    if (!spill_dir_.empty() && load(k, loaded)) {
+        out = loaded;
+        insert_locked(std::move(k), std::move(loaded));
+        ++hits_;
+        ++disk_hits_;
+        return true;
+    }
+    ++misses_;
+    return false;
+}
+
+void PartitionCache::put(const PartitionCacheKey &key, const PartitionResult &result)
+{
+    std::string k = key.to_string();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(k);
+    if (it != index_.end()) {
+        it->second->second = result;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+    insert_locked(std::move(k), result);
+}
+
+void PartitionCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+}
+
+std::size_t PartitionCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+long long PartitionCache::hits() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+long long PartitionCache::misses() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+long long PartitionCache::disk_hits() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return disk_hits_;
+}
+
+void PartitionCache::insert_locked(std::string key, PartitionResult result)
+{
+    lru_.emplace_front(std::move(key), std::move(result));
+    index_[lru_.front().first] = lru_.begin();
+    while (lru_.size() > capacity_) {
+        if (!spill_dir_.empty())
+            spill(lru_.back());
+        index_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+}
+
+std::string PartitionCache::spill_path(const std::string &key) const
+{
+    return (std::filesystem::path(spill_dir_) / (hex64(string_hash(key)) + ".gpc")).string();
+}
+
+void PartitionCache::spill(const Entry &entry) const
+{
+    // Write to a temporary name and rename, so a concurrent reader never sees a partial file.
+    std::string path = spill_path(entry.first);
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream os(tmp, std::ios::binary | std::ios::trunc);
+        if (!os)
+            return;
+        const PartitionResult &r = entry.second;
+        os.write(spill_magic, sizeof(spill_magic));
+        write_pod(os, (std::uint64_t) entry.first.size());
+        os.write(entry.first.data(), (std::streamsize) entry.first.size());
+        write_ints(os, r.part);
+        write_ints(os, r.separator);
+        write_pod(os, r.cut_weight);
+        write_pod(os, r.score);
+        if (!os)
+            return;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+}
+
+bool PartitionCache::load(const std::string &key, PartitionResult &out) const
+{
+    std::ifstream is(spill_path(key), std::ios::binary);
+    if (!is)
+        return false;
+    char magic[sizeof(spill_magic)];
+    std::uint64_t key_size = 0;
+    if (!is.read(magic, sizeof(magic)) || !std::equal(magic, magic + 4, spill_magic)
+        || !read_pod(is, key_size) || key_size != key.size())
+        return false;
+    // The file name is only a hash of the key; the stored key decides.
+    std::string stored(key_size, '\0');
+    if (!is.read(&stored[0], (std::streamsize) key_size) || stored != key)
+        return false;
+    PartitionResult r;
+    if (!read_ints(is, r.part) || !read_ints(is, r.separator) || !read_pod(is, r.cut_weight)
+        || !read_pod(is, r.score))
+        return false;
+    out = std::move(r);
+    return true;
+}
+
+template<typename Graph>
+BasicCachedSolver<Graph>::BasicCachedSolver(
+    std::unique_ptr<IBasicGraphPartitionSolver<Graph>> inner,
+    std::shared_ptr<PartitionCache> cache,
+    std::string config_key)
+    : inner_(std::move(inner))
+    , cache_(std::move(cache))
+    , config_key_(std::move(config_key))
+{
+    if (!inner_)
+        throw std::invalid_argument("inner solver is null");
+    if (!cache_)
+        throw std::invalid_argument("cache is null");
+}
+
+template<typename Graph>
+std::string BasicCachedSolver<Graph>::name() const
+{
+    return inner_->name() + " [cached]";
+}
+
+template<typename Graph>
+std::string BasicCachedSolver<Graph>::statement() const
+{
+    return inner_->statement()
+           + "\nCaching: results are reused for graphs with the same structural hash, size and "
+             "solver configuration.";
+}
+
+template<typename Graph>
+std::string BasicCachedSolver<Graph>::complexity() const
+{
+    return inner_->complexity() + " Cache lookup: O(n + m) hash, O(n) copy on a hit.";
+}
+
+template<typename Graph>
+void BasicCachedSolver<Graph>::solve(const Graph &g)
+{
+    res_ = {};
+    PartitionCacheKey key;
+    key.graph_hash = graph_fingerprint(g);
+    key.vertices = g.n;
+    for (auto &row : g.adj)
+        key.arcs += (long long) row.size();
+    key.graph_type = graph_type_name<Graph>();
+    key.config = inner_->name() + "|" + config_key_;
+
+    last_hit_ = cache_->get(key, res_);
+    if (last_hit_)
+        return;
+    inner_->set_control(this->control_);
+    inner_->solve(g);
+    res_ = inner_->result();
+    if (!res_.stopped_early)
+        cache_->put(key, res_);
+}
+
+template<typename Graph>
+PartitionResult BasicCachedSolver<Graph>::result() const
+{
+    return res_;
+}
+
+template<typename Graph>
+void BasicCachedSolver<Graph>::print(std::ostream &os) const
+{
+    os << "\n=== " << name() << " ===\n";
+    os << "Problem: " << statement() << "\n";
+    os << "Complexity: " << complexity() << "\n";
+    if (!res_.part.empty()) {
+        int blocks = *std::max_element(res_.part.begin(), res_.part.end()) + 1;
+        os << "Result: blocks=" << blocks << " cut=" << res_.cut_weight
+           << " |S|=" << res_.separator.size() << " cache=" << (last_hit_ ? "hit" : "miss")
+           << "\n";
+    }
+    os << "\n";
+}
+
+template<typename Graph>
+bool BasicCachedSolver<Graph>::last_hit() const
+{
+    return last_hit_;
+}
+
+template std::uint64_t graph_fingerprint(const WeightedGraph &);
+template std::uint64_t graph_fingerprint(const CompactWeightedGraph &);
+template std::uint64_t graph_fingerprint(const UnweightedGraph &);
+template class BasicCachedSolver<WeightedGraph>;
+template class BasicCachedSolver<CompactWeightedGraph>;
+template class BasicCachedSolver<UnweightedGraph>;
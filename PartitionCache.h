@@ -0,0 +1,90 @@
+#pragma once
+#include "GraphPartitionSolver.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// 64-bit structural hash of a graph: vertex count plus every adjacency row in stored order
+// (each neighbor id and weight mixed in as a separate word). Byte-identical graphs hash equal;
+// one pass over the edges.
+template<typename Graph>
+std::uint64_t graph_fingerprint(const Graph &g);
+
+struct PartitionCacheKey
+{
+    std::uint64_t graph_hash = 0;
+    long long vertices = 0;
+    long long arcs = 0;
+    // Stored vertex id and weight types of the graph.
+    std::string graph_type;
+    // Solver name plus its configuration, e.g. "k=8 passes=4 seed=1".
+    std::string config;
+
+    bool operator==(const PartitionCacheKey &o) const;
+    std::string to_string() const;
+};
+
+// Thread-safe LRU cache of PartitionResults. Entries evicted from memory are written to
+// spill_dir (if not empty) and reloaded from there on a later miss.
+class PartitionCache
+{
+public:
+    explicit PartitionCache(std::size_t capacity = 64, std::string spill_dir = "");
+
+    bool get(const PartitionCacheKey &key, PartitionResult &out);
+    void put(const PartitionCacheKey &key, const PartitionResult &result);
+    void clear();
+
+    std::size_t size() const;
+    long long hits() const;
+    long long misses() const;
+    long long disk_hits() const;
+
+private:
+    using Entry = std::pair<std::string, PartitionResult>;
+
+    std::string spill_path(const std::string &key) const;
+    void spill(const Entry &entry) const;
+    bool load(const std::string &key, PartitionResult &out) const;
+    void insert_locked(std::string key, PartitionResult result);
+
+    std::size_t capacity_;
+    std::string spill_dir_;
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_; // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    long long hits_ = 0, misses_ = 0, disk_hits_ = 0;
+};
+
+// Opt-in wrapper that answers solve() from a PartitionCache when the same graph was solved
+// before with the same solver configuration. Results cut short by a SolveControl are not cached.
+template<typename Graph>
+class BasicCachedSolver final : public IBasicGraphPartitionSolver<Graph>
+{
+public:
+    // config_key must describe every solver parameter that affects the result (k, passes,
+    // seed, ...); it is combined with inner->name().
+    BasicCachedSolver(std::unique_ptr<IBasicGraphPartitionSolver<Graph>> inner,
+                      std::shared_ptr<PartitionCache> cache,
+                      std::string config_key);
+    std::string name() const override;
+    std::string statement() const override;
+    std::string complexity() const override;
+    void solve(const Graph &g) override;
+    PartitionResult result() const override;
+    void print(std::ostream &os) const override;
+
+    // Whether the last solve() was answered from the cache.
+    bool last_hit() const;
+
+private:
+    std::unique_ptr<IBasicGraphPartitionSolver<Graph>> inner_;
+    std::shared_ptr<PartitionCache> cache_;
+    std::string config_key_;
+    bool last_hit_ = false;
+    PartitionResult res_;
+};
+
+using CachedSolver = BasicCachedSolver<WeightedGraph>;
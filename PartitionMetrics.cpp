@@ -0,0 +1,218 @@
+#include "PartitionMetrics.h"
+#include "ParallelUtils.h"
+#include <unordered_set>
+
+namespace {
+
+// Block pairs seen by one worker. Small k uses a k x k bit matrix, larger k a hash set.
+class QuotientEdgeSet
+{
+public:
+    explicit QuotientEdgeSet(int k)
+        : k_(k)
+    {
+        if ((long long) k * k <= (1LL << 24))
+            bits_.assign((size_t) k * k, false);
+    }
+
+    long long key(int p, int q) const { return (long long) p * k_ + q; }
+
+    // Returns true if the pair with this key was not present before.
+    bool insert(long long key)
+    {
+        if (bits_.empty())
+            return pairs_.insert(key).second;
+        if (bits_[key])
+            return false;
+        bits_[key] = true;
+        return true;
+    }
+
+    template<typename Fn>
+    void for_each(Fn &&fn) const
+    {
+        if (!bits_.empty()) {
+            for (size_t i = 0; i < bits_.size(); ++i)
+                if (bits_[i])
+                    fn((long long) i);
+        } else {
+            for (long long key : pairs_)
+                fn(key);
+        }
+    }
+
+private:
+    int k_;
+    std::vector<bool> bits_;
+    std::unordered_set<long long> pairs_;
+};
+
+struct WorkerMetrics
+{
+    Weight cut_weight = 0;
+    long long cut_edges = 0;
+    std::vector<long long> block_sizes, block_boundary, block_volume;
+    std::vector<int> seen;
+    QuotientEdgeSet quotient;
+
+    explicit WorkerMetrics(int k)
+        : block_sizes(k, 0)
+        , block_boundary(k, 0)
+        , block_volume(k, 0)
+        , seen(k, -1)
+        , quotient(k)
+    {}
+};
+} // namespace
+
+template<typename Graph>
+PartitionMetrics compute_partition_metrics(const Graph &g,
+                                           const std::vector<int> &part,
+                                           int k,
+                                           int threads,
+                                           const std::vector<Weight> &vertex_weights)
+{
+    if ((long long) part.size() != (long long) g.n)
+        throw std::invalid_argument("partition size does not match graph");
+    if (!vertex_weights.empty() && vertex_weights.size() != part.size())
+        throw std::invalid_argument("vertex_weights must have one entry per vertex");
+    PartitionMetrics m;
+    if (g.n == 0)
+        return m;
+    if (k <= 0)
+        k = *std::max_element(part.begin(), part.end()) + 1;
+    if (k <= 0)
+        throw std::invalid_argument("partition label out of range");
+    m.k = k;
+
+    threads = resolve_threads(threads);
+    std::vector<WorkerMetrics> local;
+    local.reserve(threads);
+    for (int t = 0; t < threads; ++t)
+        local.emplace_back(k);
+
+    parallel_for_chunks(g.n, threads, 4096, [&](long long begin, long long end, int worker) {
+        WorkerMetrics &w = local[worker];
+        for (int u = (int) begin; u < (int) end; ++u) {
+            int p = part[u];
+            if (p < 0 || p >= k)
+                throw std::invalid_argument("partition label out of range");
+            w.block_sizes[p] += vertex_weights.empty() ? 1 : vertex_weights[u];
+            long long foreign = 0;
+            for (auto &e : g.adj[u]) {
+                int v = e.to;
+                int q = part[v];
+                if (q == p)
+                    continue;
+                if (q < 0 || q >= k)
+                    throw std::invalid_argument("partition label out of range");
+                if (u < v) {
+                    w.cut_weight += e.w;
+                    w.cut_edges++;
+                }
+                if (w.seen[q] != u) {
+                    w.seen[q] = u;
+                    foreign++;
+                    w.quotient.insert(w.quotient.key(p, q));
+                }
+            }
+            if (foreign > 0) {
+                w.block_boundary[p]++;
+                w.block_volume[p] += foreign;
+            }
+        }
+    });
+
+    m.block_sizes.assign(k, 0);
+    m.block_boundary.assign(k, 0);
+    m.block_communication_volume.assign(k, 0);
+    QuotientEdgeSet quotient(k);
+    std::vector<int> quotient_degree(k, 0);
+    for (auto &w : local) {
+        m.cut_weight += w.cut_weight;
+        m.cut_edges += w.cut_edges;
+        for (int b = 0; b < k; ++b) {
+            m.block_sizes[b] += w.block_sizes[b];
+            m.block_boundary[b] += w.block_boundary[b];
+            m.block_communication_volume[b] += w.block_volume[b];
+        }
+        // Every cut edge is scanned from both ends, so each pair shows up as (p,q) and (q,p).
+        w.quotient.for_each([&](long long key) {
+            if (quotient.insert(key))
+                quotient_degree[key / k]++;
+        });
+    }
+
+    long long max_size = 0, total = 0;
+    for (int b = 0; b < k; ++b) {
+        m.boundary_vertices += m.block_boundary[b];
+        m.communication_volume += m.block_communication_volume[b];
+        m.max_communication_volume = std::max(m.max_communication_volume,
+                                              m.block_communication_volume[b]);
+        m.max_quotient_degree = std::max(m.max_quotient_degree, quotient_degree[b]);
+        m.quotient_edges += quotient_degree[b];
+        max_size = std::max(max_size, m.block_sizes[b]);
+        total += m.block_sizes[b];
+    }
+    m.quotient_edges /= 2;
+    long long ideal = std::max(1LL, (total + k - 1) / k);
+    m.imbalance = (double) max_size / (double) ideal - 1.0;
+    return m;
+}
+
+std::vector<long long> partition_block_sizes(const std::vector<int> &part,
+                                             int k,
+                                             const std::vector<Weight> &vertex_weights)
+{
+    if (!vertex_weights.empty() && vertex_weights.size() != part.size())
+        throw std::invalid_argument("vertex_weights must have one entry per vertex");
+    if (k <= 0 && !part.empty())
+        k = *std::max_element(part.begin(), part.end()) + 1;
+    std::vector<long long> sizes(std::max(k, 0), 0);
+    for (size_t v = 0; v < part.size(); ++v) {
+        int p = part[v];
+        if (p < 0 || p >= k)
+            throw std::invalid_argument("partition label out of range");
+        sizes[p] += vertex_weights.empty() ? 1 : vertex_weights[v];
+    }
+    return sizes;
+}
+
+void print_block_sizes(std::ostream &os, const std::vector<long long> &sizes)
+{
+    os << "sizes=[";
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        if (i)
+            os << ",";
+        os << sizes[i];
+    }
+    os << "]";
+}
+
+void PartitionMetrics::print(std::ostream &os) const
+{
+    os << "Metrics: k=" << k << " cut=" << cut_weight << " cut-edges=" << cut_edges
+       << " imbalance=" << imbalance << " boundary=" << boundary_vertices
+       << " comm-volume=" << communication_volume
+       << " max-block-comm-volume=" << max_communication_volume
+       << " quotient-edges=" << quotient_edges << " max-quotient-degree=" << max_quotient_degree
+       << " ";
+    print_block_sizes(os, block_sizes);
+    os << "\n";
+}
+
+template PartitionMetrics compute_partition_metrics(const WeightedGraph &,
+                                                    const std::vector<int> &,
+                                                    int,
+                                                    int,
+                                                    const std::vector<Weight> &);
+template PartitionMetrics compute_partition_metrics(const CompactWeightedGraph &,
+                                                    const std::vector<int> &,
+                                                    int,
+                                                    int,
+                                                    const std::vector<Weight> &);
+template PartitionMetrics compute_partition_metrics(const UnweightedGraph &,
+                                                    const std::vector<int> &,
+                                                    int,
+                                                    int,
+                                                    const std::vector<Weight> &);
@@ -0,0 +1,53 @@
+#pragma once
+#include "GraphUtils.h"
+
+// Quality report for a k-way labeling part[] of a graph. Block sizes are vertex counts, or
+// summed vertex weights when the graph has them.
+struct PartitionMetrics
+{
+    int k = 0;
+    // Sum of w(u,v) over edges {u,v} with part[u] != part[v].
+    Weight cut_weight = 0;
+    // Number of cut edges, ignoring weights.
+    long long cut_edges = 0;
+    std::vector<long long> block_sizes;
+    // max block size / ceil(W/k) - 1 for total vertex weight W (n for unit weights); 0 means
+    // perfectly balanced.
+    double imbalance = 0.0;
+    // Vertices with at least one neighbor in another block, in total and per block.
+    long long boundary_vertices = 0;
+    std::vector<long long> block_boundary;
+    // Sum over v of the number of distinct other blocks adjacent to v, in total and per block
+    // (the per-block value is the data block i sends), plus the largest per-block value.
+    long long communication_volume = 0;
+    std::vector<long long> block_communication_volume;
+    long long max_communication_volume = 0;
+    // Quotient graph: blocks are nodes, two blocks are adjacent if an edge joins them.
+    long long quotient_edges = 0;
+    int max_quotient_degree = 0;
+
+    void print(std::ostream &os) const;
+};
+
+// Computes every PartitionMetrics field in a single parallel pass over the adjacency lists.
+// k <= 0 derives k from the largest label; threads <= 0 uses all hardware threads;
+// vertex_weights (empty: unit weights) weigh the block sizes and the imbalance. Throws
+// std::invalid_argument if part or vertex_weights has the wrong size or a label is outside
+// [0, k).
+template<typename Graph>
+PartitionMetrics compute_partition_metrics(const Graph &g,
+                                           const std::vector<int> &part,
+                                           int k = 0,
+                                           int threads = 0,
+                                           const std::vector<Weight> &vertex_weights = {});
+
+// Block sizes of a finished labeling without a graph pass: vertex counts, or summed
+// vertex_weights when not empty. k <= 0 derives k from the largest label. Throws
+// std::invalid_argument like compute_partition_metrics.
+std::vector<long long> partition_block_sizes(const std::vector<int> &part,
+                                             int k = 0,
+                                             const std::vector<Weight> &vertex_weights = {});
+
+// Writes "sizes=[s0,s1,...]", the block-size field of PartitionMetrics::print and of the
+// solvers' print().
+void print_block_sizes(std::ostream &os, const std::vector<long long> &sizes);
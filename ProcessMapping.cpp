@@ -0,0 +1,309 @@
+#include "ProcessMapping.h"
+#include "CompressedGraph.h"
+#include "MultilevelKWayPartitionSolver.h"
+#include "PartitionMetrics.h"
+
+MachineTopology::MachineTopology(std::vector<int> levels, std::vector<Weight> distances)
+    : levels_(std::move(levels))
+    , distances_(std::move(distances))
+{
+    if (levels_.empty() || levels_.size() != distances_.size())
+        throw std::invalid_argument("topology needs one distance per level");
+    for (size_t i = 0; i < levels_.size(); ++i) {
+        if (levels_[i] < 1)
+            throw std::invalid_argument("topology level must have at least one member");
+        if (distances_[i] < 0 || (i > 0 && distances_[i] < distances_[i - 1]))
+            throw std::invalid_argument("topology distances must be nonnegative and "
+                                        "nondecreasing");
+        if ((long long) num_pes_ * levels_[i] > std::numeric_limits<int>::max())
+            throw std::invalid_argument("topology has too many PEs");
+        num_pes_ *= levels_[i];
+    }
+}
+
+template<typename Graph>
+WeightedGraph quotient_graph(const Graph &g, const std::vector<int> &part, int k)
+{
+    if ((int) part.size() != g.n)
+        throw std::invalid_argument("part must have one entry per vertex");
+    for (int p : part)
+        if (p < 0 || p >= k)
+            throw std::invalid_argument("block out of range");
+    // (a * k + b, w) for every cut edge with a < b; sorting merges the edges of a block pair.
+    std::vector<std::pair<long long, Weight>> arcs;
+    for (int u = 0; u < g.n; ++u)
+        for (auto &e : g.adj[u]) {
+            int v = e.to;
+            if (u < v && part[u] != part[v]) {
+                long long a = std::min(part[u], part[v]), b = std::max(part[u], part[v]);
+                arcs.push_back({a * k + b, (Weight) e.w});
+            }
+        }
+    std::sort(arcs.begin(), arcs.end());
+    WeightedGraph q(k);
+    for (size_t i = 0; i < arcs.size();) {
+        long long key = arcs[i].first;
+        Weight w = 0;
+        for (; i < arcs.size() && arcs[i].first == key; ++i)
+            w += arcs[i].second;
+        q.add_undirected((int) (key / k), (int) (key % k), w);
+    }
+    return q;
+}
+
+template<typename Graph>
+Weight mapping_cost(const Graph &g, const std::vector<int> &part, const MachineTopology &t)
+{
+    if ((int) part.size() != g.n)
+        throw std::invalid_argument("part must have one entry per vertex");
+    Weight cost = 0;
+    for (int u = 0; u < g.n; ++u)
+        for (auto &e : g.adj[u]) {
+            int v = e.to;
+            if (u < v && part[u] != part[v])
+                cost += (Weight) e.w * t.distance(part[u], part[v]);
+        }
+    return cost;
+}
+
+std::vector<int> map_blocks(const WeightedGraph &quotient,
+                            const MachineTopology &t,
+                            int swap_passes,
+                            const SolveControl *control)
+{
+    int k = quotient.n;
+    if (k != t.num_pes())
+        throw std::invalid_argument("quotient graph must have one vertex per PE");
+    const auto &adj = quotient.adj;
+    int group = t.levels()[0];
+
+    // Construction. conn[b]: weight from b to the placed blocks; next_free[i]: lowest PE of
+    // innermost group i that may still be free.
+    std::vector<int> pe(k, -1);
+    std::vector<bool> taken(k, false);
+    std::vector<Weight> conn(k, 0), degree = quotient.degrees();
+    std::vector<int> next_free;
+    for (int first = 0; first < k; first += group)
+        next_free.push_back(first);
+    for (int step = 0; step < k; ++step) {
+        int b = -1;
+        for (int c = 0; c < k; ++c)
+            if (pe[c] == -1
+                && (b == -1 || conn[c] > conn[b] || (conn[c] == conn[b] && degree[c] > degree[b])))
+                b = c;
+        int best_pe = -1;
+        Weight best_cost = 0;
+        for (int i = 0; i < (int) next_free.size(); ++i) {
+            int end = std::min(k, (i + 1) * group);
+            while (next_free[i] < end && taken[next_free[i]])
+                next_free[i]++;
+            int p = next_free[i];
+            if (p == end)
+                continue;
+            Weight cost = 0;
+            for (auto &e : adj[b])
+                if (pe[e.to] != -1)
+                    cost += e.w * t.distance(p, pe[e.to]);
+            if (best_pe == -1 || cost < best_cost) {
+                best_pe = p;
+                best_cost = cost;
+            }
+        }
+        pe[b] = best_pe;
+        taken[best_pe] = true;
+        for (auto &e : adj[b])
+            conn[e.to] += e.w;
+    }
+
+    // Swap refinement. row(c)[offset[i] + p / span[i]] is the weight from block c to the
+    // blocks on the PEs of p's level-i group, for every level below the top (whose one group
+    // holds all of c's neighbors), so the cost of c on any PE takes O(levels).
+    const auto &levels = t.levels();
+    const auto &distances = t.distances();
+    int depth = (int) levels.size();
+    std::vector<int> span(depth), offset(depth);
+    int groups = 0;
+    for (int i = 0, s = 1; i < depth; ++i) {
+        s *= levels[i];
+        span[i] = s;
+        offset[i] = groups;
+        if (i + 1 < depth)
+            groups += k / s;
+    }
+    std::vector<Weight> agg((size_t) k * groups, 0);
+    auto row = [&](int c) { return agg.data() + (size_t) c * groups; };
+    auto add = [&](int c, int p, Weight w) {
+        for (int i = 0; i + 1 < depth; ++i)
+            row(c)[offset[i] + p / span[i]] += w;
+    };
+    for (int c = 0; c < k; ++c)
+        for (auto &e : adj[c])
+            add(c, pe[e.to], e.w);
+    // Cost of block c's edges with c on PE p, where at_p is the weight to the neighbor on p.
+    auto cost_at = [&](int c, int p, Weight at_p) {
+        Weight cost = 0, inner = at_p;
+        for (int i = 0; i < depth; ++i) {
+            Weight within = i + 1 < depth ? row(c)[offset[i] + p / span[i]] : degree[c];
+            cost += distances[i] * (within - inner);
+            inner = within;
+        }
+        return cost;
+    };
+
+    // Swapping a and b leaves the length of the edge between them unchanged; every other edge
+    // of either block changes with the block's PE.
+    std::vector<int> mark(k, -1), candidates;
+    std::vector<Weight> weight_to(k, 0);
+    for (int pass = 0; pass < swap_passes && !should_stop(control); ++pass) {
+        bool improved = false;
+        for (int a = 0; a < k; ++a) {
+            candidates.clear();
+            mark[a] = a;
+            for (auto &e : adj[a]) {
+                weight_to[e.to] = e.w;
+                if (mark[e.to] != a) {
+                    mark[e.to] = a;
+                    candidates.push_back(e.to);
+                }
+                for (auto &f : adj[e.to])
+                    if (mark[f.to] != a) {
+                        mark[f.to] = a;
+                        candidates.push_back(f.to);
+                    }
+            }
+            int pa = pe[a], best_b = -1;
+            Weight a_cost = cost_at(a, pa, 0), best_delta = 0;
+            for (int b : candidates) {
+                int pb = pe[b];
+                Weight w = weight_to[b];
+                Weight delta = cost_at(a, pb, w) - a_cost + cost_at(b, pa, w) - cost_at(b, pb, 0)
+                               + 2 * w * t.distance(pa, pb);
+                if (delta < best_delta) {
+                    best_b = b;
+                    best_delta = delta;
+                }
+            }
+            for (auto &e : adj[a])
+                weight_to[e.to] = 0;
+            if (best_b != -1) {
+                int pb = pe[best_b];
+                for (auto &e : adj[a]) {
+                    add(e.to, pa, -e.w);
+                    add(e.to, pb, e.w);
+                }
+                for (auto &e : adj[best_b]) {
+                    add(e.to, pb, -e.w);
+                    add(e.to, pa, e.w);
+                }
+                std::swap(pe[a], pe[best_b]);
+                improved = true;
+            }
+        }
+        report_progress(control, "mapping swap pass", pass);
+        if (!improved)
+            break;
+    }
+    return pe;
+}
+
+template<typename Graph>
+BasicProcessMappingSolver<Graph>::BasicProcessMappingSolver(MachineTopology topology,
+                                                            int bisection_passes,
+                                                            int refine_passes,
+                                                            int max_levels,
+                                                            int swap_passes)
+    : topology_(std::move(topology))
+    , bisection_passes_(bisection_passes)
+    , refine_passes_(refine_passes)
+    , max_levels_(max_levels)
+    , swap_passes_(swap_passes)
+{}
+
+template<typename Graph>
+std::string BasicProcessMappingSolver<Graph>::name() const
+{
+    return "k-Way Partition with Process Mapping (Multilevel + swap-refined mapping)";
+}
+
+template<typename Graph>
+std::string BasicProcessMappingSolver<Graph>::statement() const
+{
+    return "Input: undirected weighted graph G=(V,E,w) and a hierarchical machine of k PEs with "
+           "distances d(p,q).\n"
+           "Goal: assign each vertex a PE part[v] in {0..k-1} with block sizes as equal as "
+           "possible.\n"
+           "Objective: minimize the communication cost:\n"
+           "  sum of w(u,v) * d(part[u], part[v]) over edges {u,v}.";
+}
+
+template<typename Graph>
+std::string BasicProcessMappingSolver<Graph>::complexity() const
+{
+    return "NP-hard (partitioning and quadratic assignment). Multilevel partition, then "
+           "O(k^2/g * deg) greedy mapping (g = PEs per innermost group) and O(k * d2 * L) per "
+           "swap pass over the quotient graph (d2 = blocks within two hops, L = levels).";
+}
+
+template<typename Graph>
+void BasicProcessMappingSolver<Graph>::solve(const Graph &g)
+{
+    res_ = {};
+    block_to_pe_.clear();
+    if (g.n == 0)
+        return;
+    int k = topology_.num_pes();
+    const SolveControl *control = this->control_;
+    BasicMultilevelKWayPartitionSolver<Graph> ml(k, bisection_passes_, refine_passes_, max_levels_);
+    ml.set_control(control);
+    ml.solve(g);
+    std::vector<int> part = ml.result().part;
+
+    block_to_pe_ = map_blocks(quotient_graph(g, part, k), topology_, swap_passes_, control);
+    for (int &p : part)
+        p = block_to_pe_[p];
+    res_.part = std::move(part);
+    res_.cut_weight = cut_weight_undirected(g, res_.part);
+    res_.score = (double) mapping_cost(g, res_.part, topology_);
+    res_.stopped_early = was_stopped(control);
+}
+
+template<typename Graph>
+PartitionResult BasicProcessMappingSolver<Graph>::result() const
+{
+    return res_;
+}
+
+template<typename Graph>
+void BasicProcessMappingSolver<Graph>::print(std::ostream &os) const
+{
+    os << "\n=== " << name() << " ===\n";
+    os << "Problem: " << statement() << "\n";
+    os << "Complexity: " << complexity() << "\n";
+    if (!res_.part.empty()) {
+        auto sizes = partition_block_sizes(res_.part);
+        os << "Result: k=" << sizes.size() << " cut=" << res_.cut_weight
+           << " cost=" << (long long) res_.score << " ";
+        print_block_sizes(os, sizes);
+        os << "\n";
+    }
+    os << "\n";
+}
+
+template WeightedGraph quotient_graph(const WeightedGraph &, const std::vector<int> &, int);
+template WeightedGraph quotient_graph(const CompactWeightedGraph &, const std::vector<int> &, int);
+template WeightedGraph quotient_graph(const UnweightedGraph &, const std::vector<int> &, int);
+template WeightedGraph quotient_graph(const CompressedGraph &, const std::vector<int> &, int);
+
+template Weight
+mapping_cost(const WeightedGraph &, const std::vector<int> &, const MachineTopology &);
+template Weight
+mapping_cost(const CompactWeightedGraph &, const std::vector<int> &, const MachineTopology &);
+template Weight
+mapping_cost(const UnweightedGraph &, const std::vector<int> &, const MachineTopology &);
+template Weight
+mapping_cost(const CompressedGraph &, const std::vector<int> &, const MachineTopology &);
+
+template class BasicProcessMappingSolver<WeightedGraph>;
+template class BasicProcessMappingSolver<CompactWeightedGraph>;
+template class BasicProcessMappingSolver<UnweightedGraph>;
+template class BasicProcessMappingSolver<CompressedGraph>;
@@ -0,0 +1,112 @@
+#pragma once
+#include "GraphPartitionSolver.h"
+
+// Hierarchical machine. PEs are numbered so that each run of levels[0] consecutive PEs shares
+// the innermost group (e.g. the cores of a socket), each run of levels[1] such groups the next
+// one (the sockets of a node), and so on. distances[i] is the cost per unit of data between two
+// distinct PEs whose innermost common group is at level i, e.g. levels {8, 2, 16} with
+// distances {1, 10, 100} for 8 cores per socket, 2 sockets per node and 16 nodes.
+class MachineTopology
+{
+public:
+    // Throws std::invalid_argument unless both vectors are non-empty and of equal length, every
+    // level is at least 1 and the distances are nonnegative and nondecreasing.
+    MachineTopology(std::vector<int> levels, std::vector<Weight> distances);
+
+    int num_pes() const
+    {
+        return num_pes_;
+    }
+    const std::vector<int> &levels() const
+    {
+        return levels_;
+    }
+    const std::vector<Weight> &distances() const
+    {
+        return distances_;
+    }
+    // 0 for p == q, otherwise the distance of the innermost level whose group holds both.
+    Weight distance(int p, int q) const
+    {
+        if (p == q)
+            return 0;
+        for (size_t i = 0; i < levels_.size(); ++i) {
+            p /= levels_[i];
+            q /= levels_[i];
+            if (p == q)
+                return distances_[i];
+        }
+        return distances_.back();
+    }
+
+private:
+    std::vector<int> levels_;
+    std::vector<Weight> distances_;
+    int num_pes_ = 1;
+};
+
+// Quotient graph of a k-way labeling: one vertex per block, and an edge between two blocks
+// weighing the total weight of the graph edges that join them.
+template<typename Graph>
+WeightedGraph quotient_graph(const Graph &g, const std::vector<int> &part, int k);
+
+// Sum over edges {u,v} of w(u,v) * t.distance(part[u], part[v]), with part labeling PEs.
+template<typename Graph>
+Weight mapping_cost(const Graph &g, const std::vector<int> &part, const MachineTopology &t);
+
+// Assigns each vertex of `quotient` (a block, one per PE) a distinct PE; returns pe[block].
+//   - construction: the block most connected to the placed ones goes next, onto the free PE
+//     with the lowest distance-weighted cost to its placed neighbors. Free PEs of one innermost
+//     group cost the same, so only one per group is evaluated;
+//   - refinement: up to swap_passes sweeps over the blocks, each swapping the PEs of a block
+//     and the block among its neighbors and their neighbors that lowers the cost most. Every
+//     block keeps its edge weight per group of every level, so a swap's gain costs
+//     O(levels) and applying it O((deg a + deg b) * levels). These sums take
+//     O(k^2 / levels[0]) memory.
+// Throws std::invalid_argument unless quotient.n == t.num_pes().
+std::vector<int> map_blocks(const WeightedGraph &quotient,
+                            const MachineTopology &t,
+                            int swap_passes = 8,
+                            const SolveControl *control = nullptr);
+
+// Partitions a graph for a hierarchical machine: MultilevelKWayPartitionSolver splits it into
+// one block per PE, then map_blocks places the blocks so that heavily communicating blocks sit
+// close together. result().part labels vertices by PE, result().cut_weight is the edge cut and
+// result().score the distance-weighted communication cost (mapping_cost).
+template<typename Graph>
+class BasicProcessMappingSolver final : public IBasicGraphPartitionSolver<Graph>
+{
+public:
+    explicit BasicProcessMappingSolver(MachineTopology topology,
+                                       int bisection_passes = 8,
+                                       int refine_passes = 4,
+                                       int max_levels = 10,
+                                       int swap_passes = 8);
+
+    std::string name() const override;
+    std::string statement() const override;
+    std::string complexity() const override;
+
+    void solve(const Graph &g) override;
+
+    PartitionResult result() const override;
+
+    // PE of every block of the multilevel partition.
+    const std::vector<int> &block_to_pe() const
+    {
+        return block_to_pe_;
+    }
+
+    void print(std::ostream &os) const override;
+
+private:
+    MachineTopology topology_;
+    int bisection_passes_;
+    int refine_passes_;
+    int max_levels_;
+    int swap_passes_;
+    std::vector<int> block_to_pe_;
+    PartitionResult res_;
+};
+
+using ProcessMappingSolver = BasicProcessMappingSolver<WeightedGraph>;
@@ -1,18 +1,24 @@
 #pragma once
 #include "GraphPartitionSolver.h"
 
-class STMinCutSolver final : public IGraphPartitionSolver
+template<typename Graph>
+class BasicSTMinCutSolver final : public IBasicGraphPartitionSolver<Graph>
 {
 public:
-    STMinCutSolver(int s, int t);
+    // threads == 1 runs sequential Dinic; any other value runs MaxFlow::parallel_max_flow on
+    // that many workers (<= 0: all hardware threads). Both give the same cut value.
+    BasicSTMinCutSolver(int s, int t, int threads = 1);
     std::string name() const override;
     std::string statement() const override;
     std::string complexity() const override;
-    void solve(const WeightedGraph &g) override;
+    void solve(const Graph &g) override;
     PartitionResult result() const override;
     void print(std::ostream &os) const override;
 
 private:
     int s_, t_;
+    int threads_;
     PartitionResult res_;
 };
+
+using STMinCutSolver = BasicSTMinCutSolver<WeightedGraph>;
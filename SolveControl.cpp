@@ -0,0 +1,62 @@
+#include "SolveControl.h"
+
+CancellationToken::CancellationToken()
+    : flag_(std::make_shared<std::atomic<bool>>(false))
+{}
+
+void CancellationToken::cancel() const
+{
+    flag_->store(true);
+}
+
+bool CancellationToken::cancelled() const
+{
+    return flag_->load();
+}
+
+SolveControl &SolveControl::set_deadline(Clock::time_point deadline)
+{
+    has_deadline_ = true;
+    deadline_ = deadline;
+    return *this;
+}
+
+SolveControl &SolveControl::set_time_limit(std::chrono::nanoseconds limit)
+{
+    return set_deadline(Clock::now() + limit);
+}
+
+SolveControl &SolveControl::set_cancellation(CancellationToken token)
+{
+    has_token_ = true;
+    token_ = std::move(token);
+    return *this;
+}
+
+SolveControl &SolveControl::set_progress(std::function<void(const SolveProgress &)> callback)
+{
+    progress_ = std::move(callback);
+    return *this;
+}
+
+bool SolveControl::should_stop() const
+{
+    if (stopped_.load(std::memory_order_relaxed))
+        return true;
+    if ((has_token_ && token_.cancelled()) || (has_deadline_ && Clock::now() >= deadline_)) {
+        stopped_.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool SolveControl::stopped() const
+{
+    return stopped_.load(std::memory_order_relaxed);
+}
+
+void SolveControl::report(const SolveProgress &progress) const
+{
+    if (progress_)
+        progress_(progress);
+}
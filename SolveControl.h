@@ -0,0 +1,81 @@
+#pragma once
+#include "GraphUtils.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+// Shared cancellation flag. Copies refer to the same flag; cancel() may be called from any
+// thread.
+class CancellationToken
+{
+public:
+    CancellationToken();
+    void cancel() const;
+    bool cancelled() const;
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+// Progress snapshot passed to the progress callback.
+struct SolveProgress
+{
+    const char *stage = "";
+    // Index of the finished pass or level within the stage.
+    int step = 0;
+    // Cut weight of the current partition, or -1 if not known at this point.
+    Weight cut_weight = -1;
+};
+
+// Deadline, cancellation token and progress callback for one solve. Solvers that support
+// anytime solving poll should_stop() between passes or levels and, once it returns true, finish
+// with the best valid partition found so far. Thread-safe except for the setters.
+class SolveControl
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    SolveControl() = default;
+
+    SolveControl &set_deadline(Clock::time_point deadline);
+    SolveControl &set_time_limit(std::chrono::nanoseconds limit);
+    SolveControl &set_cancellation(CancellationToken token);
+    // Called from the solving thread (or one of its workers) after each pass or level.
+    SolveControl &set_progress(std::function<void(const SolveProgress &)> callback);
+
+    // True once the deadline has passed or the token was cancelled. Sticky: after returning
+    // true it keeps returning true.
+    bool should_stop() const;
+    // Whether should_stop() has returned true, i.e. whether a solver cut its work short.
+    bool stopped() const;
+    void report(const SolveProgress &progress) const;
+
+private:
+    bool has_deadline_ = false;
+    Clock::time_point deadline_{};
+    bool has_token_ = false;
+    CancellationToken token_;
+    std::function<void(const SolveProgress &)> progress_;
+    mutable std::atomic<bool> stopped_{false};
+};
+
+// Convenience wrappers for optional controls (nullptr means run to completion).
+inline bool should_stop(const SolveControl *control)
+{
+    return control && control->should_stop();
+}
+
+inline bool was_stopped(const SolveControl *control)
+{
+    return control && control->stopped();
+}
+
+inline void report_progress(const SolveControl *control,
+                            const char *stage,
+                            int step,
+                            Weight cut_weight = -1)
+{
+    if (control)
+        control->report({stage, step, cut_weight});
+}
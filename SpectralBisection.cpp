@@ -0,0 +1,293 @@
+#include "SpectralBisection.h"
+#include "CompressedGraph.h"
+#include "ParallelUtils.h"
+#include <cmath>
+#include <random>
+
+namespace {
+
+// Chunk size of the parallel loops; partial dot products are kept per chunk.
+static const int spectral_chunk = 1024;
+
+// Laplacian of an induced subgraph in CSR form over local ids 0..n-1.
+struct LocalLaplacian
+{
+    int n = 0;
+    std::vector<long long> offsets;
+    std::vector<int> to;
+    std::vector<double> w;
+    std::vector<double> degree;
+};
+
+template<typename Graph>
+static LocalLaplacian induced_laplacian(const Graph &g, const std::vector<int> &vertices)
+{
+    LocalLaplacian lap;
+    lap.n = (int) vertices.size();
+    std::vector<int> local(g.n, -1);
+    for (int i = 0; i < lap.n; ++i) {
+        if (vertices[i] < 0 || vertices[i] >= g.n)
+            throw std::out_of_range("vertex");
+        local[vertices[i]] = i;
+    }
+    lap.offsets.assign(lap.n + 1, 0);
+    lap.degree.assign(lap.n, 0.0);
+    for (int i = 0; i < lap.n; ++i) {
+        for (auto &e : g.adj[vertices[i]]) {
+            int j = local[e.to];
+            if (j < 0 || j == i)
+                continue;
+            lap.to.push_back(j);
+            lap.w.push_back((double) e.w);
+            lap.degree[i] += (double) e.w;
+        }
+        lap.offsets[i + 1] = (long long) lap.to.size();
+    }
+    return lap;
+}
+
+// y = L x, parallel over the rows.
+static void apply_laplacian(const LocalLaplacian &lap,
+                            const std::vector<double> &x,
+                            std::vector<double> &y,
+                            int threads)
+{
+    y.resize(lap.n);
+    parallel_for_chunks(lap.n, threads, spectral_chunk, [&](long long b, long long e, int) {
+        for (long long i = b; i < e; ++i) {
+            double s = lap.degree[i] * x[i];
+            for (long long a = lap.offsets[i]; a < lap.offsets[i + 1]; ++a)
+                s -= lap.w[a] * x[lap.to[a]];
+            y[i] = s;
+        }
+    });
+}
+
+// Partial sums are added in chunk order, so rounding does not depend on the thread count.
+static double dot(const std::vector<double> &a, const std::vector<double> &b, int threads)
+{
+    long long n = (long long) a.size();
+    std::vector<double> partial((n + spectral_chunk - 1) / spectral_chunk, 0.0);
+    parallel_for_chunks(n, threads, spectral_chunk, [&](long long lo, long long hi, int) {
+        double s = 0.0;
+        for (long long i = lo; i < hi; ++i)
+            s += a[i] * b[i];
+        partial[lo / spectral_chunk] = s;
+    });
+    double s = 0.0;
+    for (double p : partial)
+        s += p;
+    return s;
+}
+
+// Projects out the constant vector, the null space of every Laplacian. L x is unchanged.
+static void remove_mean(std::vector<double> &x)
+{
+    double sum = 0.0;
+    for (double v : x)
+        sum += v;
+    double mean = sum / (double) x.size();
+    for (double &v : x)
+        v -= mean;
+}
+
+// a += c * b
+static void add_scaled(std::vector<double> &a, double c, const std::vector<double> &b)
+{
+    for (std::size_t i = 0; i < a.size(); ++i)
+        a[i] += c * b[i];
+}
+
+static void scale(std::vector<double> &a, double c)
+{
+    for (double &v : a)
+        v *= c;
+}
+
+// Eigenvector y of the smallest eigenvalue of the symmetric m x m matrix a (m <= 3), by cyclic
+// Jacobi rotations.
+static void smallest_eigenvector(double a[3][3], int m, double y[3])
+{
+    double v[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    for (int sweep = 0; sweep < 50; ++sweep) {
+        double off = 0.0;
+        for (int p = 0; p < m; ++p)
+            for (int q = p + 1; q < m; ++q)
+                off += a[p][q] * a[p][q];
+        if (off < 1e-30)
+            break;
+        for (int p = 0; p < m; ++p)
+            for (int q = p + 1; q < m; ++q) {
+                if (a[p][q] == 0.0)
+                    continue;
+                double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                double t = (theta >= 0 ? 1.0 : -1.0)
+                           / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                double c = 1.0 / std::sqrt(t * t + 1.0), s = t * c;
+                for (int r = 0; r < m; ++r) {
+                    double arp = a[r][p], arq = a[r][q];
+                    a[r][p] = c * arp - s * arq;
+                    a[r][q] = s * arp + c * arq;
+                }
+                for (int r = 0; r < m; ++r) {
+                    double apr = a[p][r], aqr = a[q][r];
+                    a[p][r] = c * apr - s * aqr;
+                    a[q][r] = s * apr + c * aqr;
+                }
+                for (int r = 0; r < m; ++r) {
+                    double vrp = v[r][p], vrq = v[r][q];
+                    v[r][p] = c * vrp - s * vrq;
+                    v[r][q] = s * vrp + c * vrq;
+                }
+            }
+    }
+    int best = 0;
+    for (int i = 1; i < m; ++i)
+        if (a[i][i] < a[best][best])
+            best = i;
+    for (int i = 0; i < m; ++i)
+        y[i] = v[i][best];
+}
+} // namespace
+
+template<typename Graph>
+std::vector<double> fiedler_vector(const Graph &g,
+                                   const std::vector<int> &vertices,
+                                   const SpectralOptions &options)
+{
+    LocalLaplacian lap = induced_laplacian(g, vertices);
+    int n = lap.n, threads = options.threads;
+    if (n < 2)
+        return std::vector<double>(n, 0.0);
+
+    std::mt19937_64 rng(options.seed);
+    std::uniform_real_distribution<double> start(-1.0, 1.0);
+    std::vector<double> x(n);
+    for (double &v : x)
+        v = start(rng);
+    remove_mean(x);
+    scale(x, 1.0 / std::sqrt(dot(x, x, threads)));
+    double max_degree = *std::max_element(lap.degree.begin(), lap.degree.end());
+    if (max_degree == 0.0)
+        return x;
+
+    std::vector<double> lx, w, lw, p, lp;
+    apply_laplacian(lap, x, lx, threads);
+    bool has_p = false;
+    for (int it = 0; it < options.max_iterations; ++it) {
+        double lambda = dot(x, lx, threads);
+        w = lx;
+        add_scaled(w, -lambda, x);
+        if (std::sqrt(dot(w, w, threads)) <= options.tolerance * lambda)
+            break;
+        // Jacobi-preconditioned residual.
+        for (int i = 0; i < n; ++i)
+            if (lap.degree[i] > 0.0)
+                w[i] /= lap.degree[i];
+        remove_mean(w);
+        apply_laplacian(lap, w, lw, threads);
+
+        // Orthonormal basis of span{x, w, p} (x is already unit length), with L applied to
+        // each basis vector kept alongside.
+        std::vector<std::vector<double> *> basis{&x, &w}, lbasis{&lx, &lw};
+        if (has_p) {
+            basis.push_back(&p);
+            lbasis.push_back(&lp);
+        }
+        for (std::size_t j = 1; j < basis.size();) {
+            for (int twice = 0; twice < 2; ++twice)
+                for (std::size_t i = 0; i < j; ++i) {
+                    double c = dot(*basis[i], *basis[j], threads);
+                    add_scaled(*basis[j], -c, *basis[i]);
+                    add_scaled(*lbasis[j], -c, *lbasis[i]);
+                }
+            double norm = std::sqrt(dot(*basis[j], *basis[j], threads));
+            if (norm < 1e-10) {
+                basis.erase(basis.begin() + j);
+                lbasis.erase(lbasis.begin() + j);
+                continue;
+            }
+            scale(*basis[j], 1.0 / norm);
+            scale(*lbasis[j], 1.0 / norm);
+            ++j;
+        }
+        int m = (int) basis.size();
+        if (m == 1)
+            break;
+
+        // Rayleigh-Ritz on the basis.
+        double a[3][3] = {};
+        for (int i = 0; i < m; ++i)
+            for (int j = i; j < m; ++j) {
+                double v = 0.5 * (dot(*basis[i], *lbasis[j], threads)
+                                  + dot(*basis[j], *lbasis[i], threads));
+                a[i][j] = a[j][i] = v;
+            }
+        double y[3];
+        smallest_eigenvector(a, m, y);
+
+        // New search direction: the part of the update outside the old x.
+        std::vector<double> next_p(n, 0.0), next_lp(n, 0.0);
+        for (int i = 1; i < m; ++i) {
+            add_scaled(next_p, y[i], *basis[i]);
+            add_scaled(next_lp, y[i], *lbasis[i]);
+        }
+        scale(x, y[0]);
+        add_scaled(x, 1.0, next_p);
+        scale(lx, y[0]);
+        add_scaled(lx, 1.0, next_lp);
+        remove_mean(x);
+        double norm = std::sqrt(dot(x, x, threads));
+        scale(x, 1.0 / norm);
+        scale(lx, 1.0 / norm);
+        p = std::move(next_p);
+        lp = std::move(next_lp);
+        has_p = true;
+    }
+    return x;
+}
+
+template<typename Graph>
+std::vector<int> spectral_order(const Graph &g,
+                                const std::vector<int> &vertices,
+                                const SpectralOptions &options)
+{
+    std::vector<double> f = fiedler_vector(g, vertices, options);
+    std::vector<int> idx(vertices.size());
+    std::iota(idx.begin(), idx.end(), 0);
+    std::sort(idx.begin(), idx.end(), [&](int a, int b) {
+        if (f[a] != f[b])
+            return f[a] < f[b];
+        return vertices[a] < vertices[b];
+    });
+    std::vector<int> order;
+    order.reserve(vertices.size());
+    for (int i : idx)
+        order.push_back(vertices[i]);
+    return order;
+}
+
+template std::vector<double> fiedler_vector(const WeightedGraph &,
+                                            const std::vector<int> &,
+                                            const SpectralOptions &);
+template std::vector<double> fiedler_vector(const CompactWeightedGraph &,
+                                            const std::vector<int> &,
+                                            const SpectralOptions &);
+template std::vector<double> fiedler_vector(const UnweightedGraph &,
+                                            const std::vector<int> &,
+                                            const SpectralOptions &);
+template std::vector<double> fiedler_vector(const CompressedGraph &,
+                                            const std::vector<int> &,
+                                            const SpectralOptions &);
+template std::vector<int> spectral_order(const WeightedGraph &,
+                                         const std::vector<int> &,
+                                         const SpectralOptions &);
+template std::vector<int> spectral_order(const CompactWeightedGraph &,
+                                         const std::vector<int> &,
+                                         const SpectralOptions &);
+template std::vector<int> spectral_order(const UnweightedGraph &,
+                                         const std::vector<int> &,
+                                         const SpectralOptions &);
+template std::vector<int> spectral_order(const CompressedGraph &,
+                                         const std::vector<int> &,
+                                         const SpectralOptions &);
@@ -0,0 +1,45 @@
+#pragma once
+#include "GraphUtils.h"
+#include <cstdint>
+
+// Spectral ordering for the initial split of a bisection. The Fiedler vector (eigenvector of
+// the second smallest eigenvalue of the Laplacian L = D - W of the induced subgraph) is
+// computed by LOBPCG with a Jacobi preconditioner: every iteration is one sparse matvec with L,
+// parallel over the rows, plus a Rayleigh-Ritz step on span{x, preconditioned residual,
+// previous direction}, all kept orthogonal to the constant vector. Dot products are summed per
+// fixed-size chunk in chunk order, so the vector does not depend on the thread count.
+
+// How bisection_on_subset (MinimumBisectionSolver.h) seeds its split.
+enum class InitialBisection {
+    DegreeOrder, // decreasing internal degree (order_by_internal_degree)
+    Spectral     // increasing Fiedler vector value (spectral_order)
+};
+
+struct SpectralOptions
+{
+    // LOBPCG iterations; each costs one matvec over the induced edges.
+    int max_iterations = 200;
+    // Stop once ||L x - lambda x|| <= tolerance * lambda. Relative to lambda rather than to the
+    // spectrum's scale, since graphs with a small cut have a small Fiedler value.
+    double tolerance = 1e-2;
+    // Matvec and dot product threads; <= 0 means all hardware threads.
+    int threads = 1;
+    // Seeds the random start vector.
+    std::uint64_t seed = 1;
+};
+
+// Fiedler vector of the subgraph induced by `vertices` (entry i belongs to vertices[i]),
+// normalized to unit length. Subsets of fewer than 2 vertices give a zero vector. If the
+// subgraph is disconnected the result lies in the null space of L, i.e. it is constant on
+// every component, which still separates components.
+template<typename Graph>
+std::vector<double> fiedler_vector(const Graph &g,
+                                   const std::vector<int> &vertices,
+                                   const SpectralOptions &options = {});
+
+// `vertices` sorted by Fiedler vector value, ties by id; splitting the order in the middle is
+// the spectral bisection.
+template<typename Graph>
+std::vector<int> spectral_order(const Graph &g,
+                                const std::vector<int> &vertices,
+                                const SpectralOptions &options = {});
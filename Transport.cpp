@@ -0,0 +1,461 @@
+#include "Transport.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+static void check_rank(int rank, int size)
+{
+    if (rank < 0 || rank >= size)
+        throw std::out_of_range("rank");
+}
+
+// Mailboxes of an in-process group: box[to].queues[from] holds messages not yet received.
+struct InProcessState
+{
+    struct Box
+    {
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::vector<std::deque<std::vector<char>>> queues;
+    };
+
+    explicit InProcessState(int size)
+        : boxes(size)
+    {
+        for (auto &box : boxes)
+            box.queues.resize(size);
+    }
+
+    std::vector<Box> boxes;
+    std::atomic<bool> aborted{false};
+};
+
+class InProcessTransport final : public Transport
+{
+public:
+    InProcessTransport(std::shared_ptr<InProcessState> state, int rank)
+        : state_(std::move(state))
+        , rank_(rank)
+    {}
+
+    int rank() const override
+    {
+        return rank_;
+    }
+    int size() const override
+    {
+        return (int) state_->boxes.size();
+    }
+    void send(int to, std::vector<char> message) override
+    {
+        check_rank(to, size());
+        auto &box = state_->boxes[to];
+        {
+            std::lock_guard<std::mutex> lock(box.mutex);
+            box.queues[rank_].push_back(std::move(message));
+        }
+        box.ready.notify_all();
+    }
+    std::vector<char> receive(int from) override
+    {
+        check_rank(from, size());
+        auto &box = state_->boxes[rank_];
+        std::unique_lock<std::mutex> lock(box.mutex);
+        auto &queue = box.queues[from];
+        box.ready.wait(lock, [&] { return !queue.empty() || state_->aborted; });
+        if (state_->aborted)
+            throw std::runtime_error("rank " + std::to_string(rank_) + ": group aborted");
+        std::vector<char> message = std::move(queue.front());
+        queue.pop_front();
+        return message;
+    }
+    void abort() override
+    {
+        state_->aborted = true;
+        // Notifying under each mutex keeps a waiter from missing the flag between its
+        // predicate check and going to sleep.
+        for (auto &box : state_->boxes) {
+            std::lock_guard<std::mutex> lock(box.mutex);
+            box.ready.notify_all();
+        }
+    }
+
+private:
+    std::shared_ptr<InProcessState> state_;
+    int rank_;
+};
+
+// Stream sockets to every peer, framed as [uint64 length][bytes]. Sockets are nonblocking:
+// send() queues what the kernel does not take, and receive() keeps writing queued data while
+// it waits for input, so two ranks sending large messages to each other cannot deadlock.
+class UnixSocketTransport final : public Transport
+{
+public:
+    UnixSocketTransport(int rank, std::vector<int> fds)
+        : rank_(rank)
+        , peers_(fds.size())
+    {
+        for (std::size_t q = 0; q < fds.size(); ++q) {
+            peers_[q].fd = fds[q];
+            if (fds[q] >= 0)
+                fcntl(fds[q], F_SETFL, fcntl(fds[q], F_GETFL) | O_NONBLOCK);
+        }
+    }
+    ~UnixSocketTransport() override
+    {
+        // Deliver what is still queued; peers that exited are skipped.
+        try {
+            while (pending_output())
+                progress();
+        } catch (...) {
+        }
+        for (auto &peer : peers_)
+            if (peer.fd >= 0)
+                close(peer.fd);
+    }
+
+    int rank() const override
+    {
+        return rank_;
+    }
+    int size() const override
+    {
+        return (int) peers_.size();
+    }
+    void send(int to, std::vector<char> message) override
+    {
+        check_rank(to, size());
+        Peer &peer = peers_[to];
+        if (to == rank_) {
+            peer.ready.push_back(std::move(message));
+            return;
+        }
+        std::uint64_t len = message.size();
+        peer.out.insert(peer.out.end(), (const char *) &len, (const char *) &len + sizeof(len));
+        peer.out.insert(peer.out.end(), message.begin(), message.end());
+        write_some(peer);
+    }
+    std::vector<char> receive(int from) override
+    {
+        check_rank(from, size());
+        Peer &peer = peers_[from];
+        if (aborted_)
+            throw std::runtime_error("rank " + std::to_string(rank_) + ": group aborted");
+        while (peer.ready.empty()) {
+            if (peer.fd < 0)
+                throw std::runtime_error("rank " + std::to_string(from) + " disconnected");
+            progress();
+        }
+        std::vector<char> message = std::move(peer.ready.front());
+        peer.ready.pop_front();
+        return message;
+    }
+    void abort() override
+    {
+        // Peers waiting on this rank read end of file and throw "disconnected".
+        aborted_ = true;
+        for (auto &peer : peers_)
+            if (peer.fd >= 0)
+                disconnect(peer);
+    }
+
+private:
+    struct Peer
+    {
+        int fd = -1;
+        std::vector<char> out;
+        std::size_t out_pos = 0;
+        std::vector<char> in;
+        std::deque<std::vector<char>> ready;
+    };
+
+    bool pending_output() const
+    {
+        for (auto &peer : peers_)
+            if (peer.fd >= 0 && peer.out_pos < peer.out.size())
+                return true;
+        return false;
+    }
+
+    void disconnect(Peer &peer)
+    {
+        close(peer.fd);
+        peer.fd = -1;
+        peer.out.clear();
+        peer.out_pos = 0;
+    }
+
+    void write_some(Peer &peer)
+    {
+        while (peer.fd >= 0 && peer.out_pos < peer.out.size()) {
+            ssize_t r = ::send(peer.fd,
+                               peer.out.data() + peer.out_pos,
+                               peer.out.size() - peer.out_pos,
+                               MSG_NOSIGNAL);
+            if (r > 0) {
+                peer.out_pos += (std::size_t) r;
+            } else if (r < 0 && errno == EINTR) {
+                continue;
+            } else if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return;
+            } else {
+                disconnect(peer);
+                return;
+            }
+        }
+        peer.out.clear();
+        peer.out_pos = 0;
+    }
+
+    void read_some(Peer &peer)
+    {
+        char buf[1 << 16];
+        for (;;) {
+            ssize_t r = read(peer.fd, buf, sizeof(buf));
+            if (r > 0) {
+                peer.in.insert(peer.in.end(), buf, buf + r);
+            } else if (r < 0 && errno == EINTR) {
+                continue;
+            } else if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            } else {
+                disconnect(peer);
+                break;
+            }
+        }
+        std::size_t pos = 0;
+        std::uint64_t len = 0;
+        while (peer.in.size() - pos >= sizeof(len)) {
+            std::memcpy(&len, peer.in.data() + pos, sizeof(len));
+            if (peer.in.size() - pos - sizeof(len) < len)
+                break;
+            auto begin = peer.in.begin() + (std::ptrdiff_t) (pos + sizeof(len));
+            peer.ready.emplace_back(begin, begin + (std::ptrdiff_t) len);
+            pos += sizeof(len) + len;
+        }
+        peer.in.erase(peer.in.begin(), peer.in.begin() + (std::ptrdiff_t) pos);
+    }
+
+    // Waits until some socket is readable or writable and services all that are.
+    void progress()
+    {
+        std::vector<pollfd> fds;
+        std::vector<int> owners;
+        for (int q = 0; q < size(); ++q) {
+            Peer &peer = peers_[q];
+            if (peer.fd < 0)
+                continue;
+            short events = POLLIN;
+            if (peer.out_pos < peer.out.size())
+                events |= POLLOUT;
+            fds.push_back({peer.fd, events, 0});
+            owners.push_back(q);
+        }
+        if (fds.empty())
+            return;
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR)
+                return;
+            throw std::runtime_error("poll failed");
+        }
+        for (std::size_t i = 0; i < fds.size(); ++i) {
+            Peer &peer = peers_[owners[i]];
+            if (fds[i].revents & POLLOUT)
+                write_some(peer);
+            if (peer.fd >= 0 && (fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                read_some(peer);
+        }
+    }
+
+    int rank_;
+    std::vector<Peer> peers_;
+    bool aborted_ = false;
+};
+
+static void write_all(int fd, const void *data, std::size_t len)
+{
+    const char *p = (const char *) data;
+    while (len > 0) {
+        ssize_t r = ::send(fd, p, len, MSG_NOSIGNAL);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            throw std::runtime_error("socket handshake failed");
+        p += r;
+        len -= (std::size_t) r;
+    }
+}
+
+static void read_all(int fd, void *data, std::size_t len)
+{
+    char *p = (char *) data;
+    while (len > 0) {
+        ssize_t r = read(fd, p, len);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            throw std::runtime_error("socket handshake failed");
+        p += r;
+        len -= (std::size_t) r;
+    }
+}
+
+static sockaddr_un socket_address(const std::string &dir, int rank)
+{
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::string path = dir + "/rank" + std::to_string(rank) + ".sock";
+    if (path.size() >= sizeof(addr.sun_path))
+        throw std::invalid_argument("socket path too long: " + path);
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return addr;
+}
+} // namespace
+
+std::vector<std::unique_ptr<Transport>> make_in_process_group(int size)
+{
+    if (size < 1)
+        throw std::invalid_argument("group needs at least one rank");
+    auto state = std::make_shared<InProcessState>(size);
+    std::vector<std::unique_ptr<Transport>> group;
+    for (int r = 0; r < size; ++r)
+        group.push_back(std::make_unique<InProcessTransport>(state, r));
+    return group;
+}
+
+std::vector<std::unique_ptr<Transport>> make_unix_socket_group(int size)
+{
+    if (size < 1)
+        throw std::invalid_argument("group needs at least one rank");
+    std::vector<std::vector<int>> fds(size, std::vector<int>(size, -1));
+    for (int a = 0; a < size; ++a)
+        for (int b = a + 1; b < size; ++b) {
+            int pair[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0)
+                throw std::runtime_error("socketpair failed");
+            fds[a][b] = pair[0];
+            fds[b][a] = pair[1];
+        }
+    std::vector<std::unique_ptr<Transport>> group;
+    for (int r = 0; r < size; ++r)
+        group.push_back(std::make_unique<UnixSocketTransport>(r, fds[r]));
+    return group;
+}
+
+std::unique_ptr<Transport> connect_unix_socket_group(const std::string &dir,
+                                                     int rank,
+                                                     int size,
+                                                     int timeout_ms)
+{
+    check_rank(rank, size);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    auto remaining_ms = [&] {
+        auto left = deadline - std::chrono::steady_clock::now();
+        return (int) std::max<long long>(
+            0, std::chrono::duration_cast<std::chrono::milliseconds>(left).count());
+    };
+    std::vector<int> fds(size, -1);
+    auto fail = [&](const std::string &what) {
+        for (int fd : fds)
+            if (fd >= 0)
+                close(fd);
+        throw std::runtime_error(what);
+    };
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un own = socket_address(dir, rank);
+    unlink(own.sun_path);
+    if (listener < 0 || bind(listener, (sockaddr *) &own, sizeof(own)) != 0
+        || listen(listener, size) != 0) {
+        if (listener >= 0)
+            close(listener);
+        fail("cannot listen on " + std::string(own.sun_path));
+    }
+
+    try {
+        for (int q = 0; q < rank; ++q) {
+            sockaddr_un addr = socket_address(dir, q);
+            for (;;) {
+                int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+                if (fd >= 0 && connect(fd, (sockaddr *) &addr, sizeof(addr)) == 0) {
+                    fds[q] = fd;
+                    break;
+                }
+                if (fd >= 0)
+                    close(fd);
+                if (remaining_ms() == 0)
+                    throw std::runtime_error("timed out connecting to rank " + std::to_string(q));
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            write_all(fds[q], &rank, sizeof(rank));
+        }
+        for (int accepted = 0; accepted < size - 1 - rank; ++accepted) {
+            pollfd p{listener, POLLIN, 0};
+            if (poll(&p, 1, remaining_ms()) <= 0)
+                throw std::runtime_error("timed out waiting for higher ranks");
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd < 0)
+                throw std::runtime_error("accept failed");
+            int peer = -1;
+            read_all(fd, &peer, sizeof(peer));
+            if (peer <= rank || peer >= size || fds[peer] >= 0) {
+                close(fd);
+                throw std::runtime_error("unexpected rank in handshake");
+            }
+            fds[peer] = fd;
+        }
+    } catch (const std::exception &e) {
+        close(listener);
+        unlink(own.sun_path);
+        fail(e.what());
+    }
+    close(listener);
+    unlink(own.sun_path);
+    return std::make_unique<UnixSocketTransport>(rank, std::move(fds));
+}
+
+std::vector<std::vector<char>> all_to_all(Transport &t, std::vector<std::vector<char>> outgoing)
+{
+    int p = t.size(), me = t.rank();
+    if ((int) outgoing.size() != p)
+        throw std::invalid_argument("all_to_all needs one message per rank");
+    for (int q = 0; q < p; ++q)
+        if (q != me)
+            t.send(q, std::move(outgoing[q]));
+    std::vector<std::vector<char>> incoming(p);
+    for (int q = 0; q < p; ++q)
+        incoming[q] = q == me ? std::move(outgoing[q]) : t.receive(q);
+    return incoming;
+}
+
+std::vector<std::vector<char>> all_gather(Transport &t, const std::vector<char> &data)
+{
+    return all_to_all(t, std::vector<std::vector<char>>(t.size(), data));
+}
+
+std::vector<long long> all_reduce_sum(Transport &t, const std::vector<long long> &values)
+{
+    std::vector<long long> sum(values.size(), 0);
+    for (auto &bytes : all_gather(t, to_bytes(values))) {
+        auto part = from_bytes<long long>(bytes);
+        if (part.size() != sum.size())
+            throw std::runtime_error("all_reduce_sum: ranks passed different lengths");
+        for (std::size_t i = 0; i < sum.size(); ++i)
+            sum[i] += part[i];
+    }
+    return sum;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Point-to-point messaging between the size() ranks of a distributed solve. Messages from one
+// rank to another arrive in send order. send() never waits for the receiver, so a rank may send
+// all messages of a round before receiving any.
+class Transport
+{
+public:
+    virtual ~Transport() = default;
+    virtual int rank() const = 0;
+    virtual int size() const = 0;
+    virtual void send(int to, std::vector<char> message) = 0;
+    // Blocks until the next message from rank `from` arrives. Throws std::runtime_error once the
+    // group is aborted.
+    virtual std::vector<char> receive(int from) = 0;
+    // Gives up on the group after a failure on this rank: receive() throws here from now on and
+    // on every peer that waits for this rank, so no rank blocks on one that has stopped. Peers
+    // that catch the error should abort in turn.
+    virtual void abort() = 0;
+};
+
+// Group of ranks inside one process: element i is rank i, typically driven by its own thread.
+std::vector<std::unique_ptr<Transport>> make_in_process_group(int size);
+
+// Group of ranks connected by Unix socket pairs. The endpoints hold no threads, so the group
+// may be created before fork() and each child keep only its own element.
+std::vector<std::unique_ptr<Transport>> make_unix_socket_group(int size);
+
+// Joins a group of independent processes on one machine: rank i listens on dir/rank<i>.sock
+// and connects to every lower rank. Blocks until all size ranks are connected; throws
+// std::runtime_error if that takes longer than timeout_ms.
+std::unique_ptr<Transport> connect_unix_socket_group(const std::string &dir,
+                                                     int rank,
+                                                     int size,
+                                                     int timeout_ms = 30000);
+
+// Collectives over all ranks; every rank must call them in the same order.
+
+// Sends outgoing[q] to rank q and returns the message each rank sent to this one (the own
+// slot is passed through).
+std::vector<std::vector<char>> all_to_all(Transport &t, std::vector<std::vector<char>> outgoing);
+// Returns every rank's data, indexed by rank.
+std::vector<std::vector<char>> all_gather(Transport &t, const std::vector<char> &data);
+// Element-wise sum of values over all ranks.
+std::vector<long long> all_reduce_sum(Transport &t, const std::vector<long long> &values);
+
+// Raw byte images of trivially copyable arrays, for message payloads.
+template<typename T>
+std::vector<char> to_bytes(const std::vector<T> &values)
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "message payload must be trivially copyable");
+    std::vector<char> out(values.size() * sizeof(T));
+    if (!out.empty())
+        std::memcpy(out.data(), values.data(), out.size());
+    return out;
+}
+
+template<typename T>
+std::vector<T> from_bytes(const std::vector<char> &bytes)
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "message payload must be trivially copyable");
+    std::vector<T> out(bytes.size() / sizeof(T));
+    if (!out.empty())
+        std::memcpy(out.data(), bytes.data(), out.size() * sizeof(T));
+    return out;
+}
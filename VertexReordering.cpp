@@ -0,0 +1,294 @@
+#include "VertexReordering.h"
+#include "MultilevelKWayPartitionSolver.h"
+
+namespace {
+
+// BFS over the component of root that ignores vertices with placed[v] set. Returns the depth
+// of the BFS tree and stores in `last` a minimum-degree vertex of the deepest level.
+template<typename Graph>
+static int bfs_depth(const Graph &g,
+                     int root,
+                     const std::vector<char> &placed,
+                     std::vector<int> &stamp,
+                     int id,
+                     std::vector<int> &queue,
+                     int &last)
+{
+    queue.clear();
+    queue.push_back(root);
+    stamp[root] = id;
+    int depth = 0;
+    size_t level_begin = 0;
+    while (level_begin < queue.size()) {
+        size_t level_end = queue.size();
+        last = queue[level_begin];
+        for (size_t i = level_begin; i < level_end; ++i) {
+            int u = queue[i];
+            if (g.adj[u].size() < g.adj[last].size())
+                last = u;
+            for (auto &e : g.adj[u]) {
+                int v = e.to;
+                if (!placed[v] && stamp[v] != id) {
+                    stamp[v] = id;
+                    queue.push_back(v);
+                }
+            }
+        }
+        level_begin = level_end;
+        if (level_begin < queue.size())
+            ++depth;
+    }
+    return depth;
+}
+} // namespace
+
+std::string reorder_strategy_name(ReorderStrategy strategy)
+{
+    switch (strategy) {
+    case ReorderStrategy::ReverseCuthillMcKee:
+        return "reverse Cuthill-McKee";
+    case ReorderStrategy::DegreeDescending:
+        return "degree descending";
+    case ReorderStrategy::PartitionBlocks:
+        return "partition blocks";
+    }
+    return "unknown";
+}
+
+template<typename Graph>
+std::vector<int> reverse_cuthill_mckee_order(const Graph &g)
+{
+    int n = g.n;
+    std::vector<int> by_degree(n);
+    std::iota(by_degree.begin(), by_degree.end(), 0);
+    std::stable_sort(by_degree.begin(), by_degree.end(), [&](int a, int b) {
+        return g.adj[a].size() < g.adj[b].size();
+    });
+
+    std::vector<char> placed(n, 0);
+    std::vector<int> stamp(n, -1), queue, order, nbrs;
+    order.reserve(n);
+    int bfs_id = 0;
+    for (int start : by_degree) {
+        if (placed[start])
+            continue;
+
+        // Pseudo-peripheral root: hop to the far end of the BFS tree while its depth grows.
+        int root = start, last = start;
+        int depth = bfs_depth(g, root, placed, stamp, bfs_id++, queue, last);
+        for (int tries = 0; tries < 8 && last != root; ++tries) {
+            int candidate_last = last;
+            int d = bfs_depth(g, last, placed, stamp, bfs_id++, queue, candidate_last);
+            if (d <= depth)
+                break;
+            root = last;
+            depth = d;
+            last = candidate_last;
+        }
+
+        size_t head = order.size();
+        order.push_back(root);
+        placed[root] = 1;
+        while (head < order.size()) {
+            int u = order[head++];
+            nbrs.clear();
+            for (auto &e : g.adj[u])
+                if (!placed[e.to]) {
+                    placed[e.to] = 1;
+                    nbrs.push_back(e.to);
+                }
+            std::sort(nbrs.begin(), nbrs.end(), [&](int a, int b) {
+                if (g.adj[a].size() != g.adj[b].size())
+                    return g.adj[a].size() < g.adj[b].size();
+                return a < b;
+            });
+            order.insert(order.end(), nbrs.begin(), nbrs.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+template<typename Graph>
+std::vector<int> degree_descending_order(const Graph &g)
+{
+    std::vector<int> order(g.n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return g.adj[a].size() > g.adj[b].size();
+    });
+    return order;
+}
+
+std::vector<int> partition_blocks_order(const std::vector<int> &part,
+                                        const std::vector<int> &base_order)
+{
+    std::vector<int> order = base_order;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return part[a] < part[b]; });
+    return order;
+}
+
+std::vector<int> inverse_permutation(const std::vector<int> &order)
+{
+    std::vector<int> rank(order.size(), -1);
+    for (int i = 0; i < (int) order.size(); ++i) {
+        int v = order[i];
+        if (v < 0 || v >= (int) order.size() || rank[v] != -1)
+            throw std::invalid_argument("order is not a permutation");
+        rank[v] = i;
+    }
+    return rank;
+}
+
+template<typename Graph>
+Graph permute_graph(const Graph &g, const std::vector<int> &order)
+{
+    if ((long long) order.size() != (long long) g.n)
+        throw std::invalid_argument("order size does not match graph");
+    auto rank = inverse_permutation(order);
+    Graph out(g.n);
+    for (int i = 0; i < g.n; ++i) {
+        auto &row = out.adj[i];
+        row = g.adj[order[i]];
+        for (auto &e : row)
+            e.to = rank[e.to];
+        std::sort(row.begin(), row.end(), [](const auto &a, const auto &b) { return a.to < b.to; });
+    }
+    return out;
+}
+
+template<typename Graph>
+BasicReorderedSolver<Graph>::BasicReorderedSolver(
+    std::unique_ptr<IBasicGraphPartitionSolver<Graph>> inner,
+    ReorderStrategy strategy,
+    int partition_blocks)
+    : inner_(std::move(inner))
+    , strategy_(strategy)
+    , partition_blocks_(partition_blocks)
+{
+    if (!inner_)
+        throw std::invalid_argument("inner solver is null");
+}
+
+template<typename Graph>
+std::string BasicReorderedSolver<Graph>::name() const
+{
+    return inner_->name() + " [reordered: " + reorder_strategy_name(strategy_) + "]";
+}
+
+template<typename Graph>
+std::string BasicReorderedSolver<Graph>::statement() const
+{
+    return inner_->statement()
+           + "\nPreprocessing: vertices are relabeled for memory locality before solving; the "
+             "result is mapped back to the original ids.";
+}
+
+template<typename Graph>
+std::string BasicReorderedSolver<Graph>::complexity() const
+{
+    return inner_->complexity()
+           + " Reordering: O(m log d) for RCM/degree, plus one multilevel solve for partition "
+             "blocks.";
+}
+
+template<typename Graph>
+void BasicReorderedSolver<Graph>::solve(const Graph &g)
+{
+    res_ = {};
+    order_.clear();
+    if (g.n == 0) {
+        inner_->set_control(this->control_);
+        inner_->solve(g);
+        return;
+    }
+
+    // Whether the partition-blocks stage was cut short; the inner solver may not report it.
+    bool blocks_stopped = false;
+    switch (strategy_) {
+    case ReorderStrategy::ReverseCuthillMcKee:
+        order_ = reverse_cuthill_mckee_order(g);
+        break;
+    case ReorderStrategy::DegreeDescending:
+        order_ = degree_descending_order(g);
+        break;
+    case ReorderStrategy::PartitionBlocks: {
+        BasicMultilevelKWayPartitionSolver<Graph> blocks(partition_blocks_);
+        blocks.set_control(this->control_);
+        blocks.solve(g);
+        blocks_stopped = blocks.result().stopped_early;
+        order_ = partition_blocks_order(blocks.result().part, reverse_cuthill_mckee_order(g));
+        break;
+    }
+    }
+
+    Graph pg = permute_graph(g, order_);
+    inner_->set_control(this->control_);
+    inner_->solve(pg);
+    PartitionResult inner = inner_->result();
+
+    res_.cut_weight = inner.cut_weight;
+    res_.score = inner.score;
+    res_.stopped_early = inner.stopped_early || blocks_stopped;
+    if (!inner.part.empty()) {
+        res_.part.assign(g.n, 0);
+        for (int i = 0; i < g.n; ++i)
+            res_.part[order_[i]] = inner.part[i];
+    }
+    res_.separator.reserve(inner.separator.size());
+    for (int v : inner.separator)
+        res_.separator.push_back(order_[v]);
+    std::sort(res_.separator.begin(), res_.separator.end());
+}
+
+template<typename Graph>
+PartitionResult BasicReorderedSolver<Graph>::result() const
+{
+    return res_;
+}
+
+template<typename Graph>
+const std::vector<int> &BasicReorderedSolver<Graph>::order() const
+{
+    return order_;
+}
+
+template<typename Graph>
+void BasicReorderedSolver<Graph>::print(std::ostream &os) const
+{
+    os << "\n=== " << name() << " ===\n";
+    os << "Problem: " << statement() << "\n";
+    os << "Complexity: " << complexity() << "\n";
+    if (!res_.part.empty()) {
+        std::vector<int> sizes;
+        int maxp = *std::max_element(res_.part.begin(), res_.part.end());
+        sizes.assign(maxp + 1, 0);
+        for (int p : res_.part)
+            sizes[p]++;
+        os << "Result: k=" << sizes.size() << " cut=" << res_.cut_weight << " sizes=[";
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            if (i)
+                os << ",";
+            os << sizes[i];
+        }
+        os << "]";
+        if (!res_.separator.empty())
+            os << " |S|=" << res_.separator.size();
+        os << "\n";
+    }
+    os << "\n";
+}
+
+template std::vector<int> reverse_cuthill_mckee_order(const WeightedGraph &);
+template std::vector<int> reverse_cuthill_mckee_order(const CompactWeightedGraph &);
+template std::vector<int> reverse_cuthill_mckee_order(const UnweightedGraph &);
+template std::vector<int> degree_descending_order(const WeightedGraph &);
+template std::vector<int> degree_descending_order(const CompactWeightedGraph &);
+template std::vector<int> degree_descending_order(const UnweightedGraph &);
+template WeightedGraph permute_graph(const WeightedGraph &, const std::vector<int> &);
+template CompactWeightedGraph permute_graph(const CompactWeightedGraph &, const std::vector<int> &);
+template UnweightedGraph permute_graph(const UnweightedGraph &, const std::vector<int> &);
+
+template class BasicReorderedSolver<WeightedGraph>;
+template class BasicReorderedSolver<CompactWeightedGraph>;
+template class BasicReorderedSolver<UnweightedGraph>;
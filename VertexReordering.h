@@ -0,0 +1,59 @@
+#pragma once
+#include "GraphPartitionSolver.h"
+#include <memory>
+
+// Vertex orders are permutations `order` where order[i] is the original id of the vertex
+// placed at position i of the reordered graph.
+enum class ReorderStrategy {
+    ReverseCuthillMcKee, // BFS by increasing degree from a pseudo-peripheral vertex, reversed
+    DegreeDescending,    // highest degree first, ties by id
+    PartitionBlocks      // grouped by the blocks of a multilevel k-way partition, RCM inside
+};
+
+std::string reorder_strategy_name(ReorderStrategy strategy);
+
+template<typename Graph>
+std::vector<int> reverse_cuthill_mckee_order(const Graph &g);
+
+template<typename Graph>
+std::vector<int> degree_descending_order(const Graph &g);
+
+// Stable regrouping of `base_order` by part[] label.
+std::vector<int> partition_blocks_order(const std::vector<int> &part,
+                                        const std::vector<int> &base_order);
+
+std::vector<int> inverse_permutation(const std::vector<int> &order);
+
+// Relabels g so that original vertex order[i] becomes vertex i; adjacency rows are sorted by
+// the new neighbor ids.
+template<typename Graph>
+Graph permute_graph(const Graph &g, const std::vector<int> &order);
+
+// Runs a solver on a cache-friendlier relabeling of the input and maps its PartitionResult back
+// to the original vertex ids.
+template<typename Graph>
+class BasicReorderedSolver final : public IBasicGraphPartitionSolver<Graph>
+{
+public:
+    BasicReorderedSolver(std::unique_ptr<IBasicGraphPartitionSolver<Graph>> inner,
+                         ReorderStrategy strategy,
+                         int partition_blocks = 16);
+    std::string name() const override;
+    std::string statement() const override;
+    std::string complexity() const override;
+    void solve(const Graph &g) override;
+    PartitionResult result() const override;
+    void print(std::ostream &os) const override;
+
+    // Order used by the last solve().
+    const std::vector<int> &order() const;
+
+private:
+    std::unique_ptr<IBasicGraphPartitionSolver<Graph>> inner_;
+    ReorderStrategy strategy_;
+    int partition_blocks_;
+    std::vector<int> order_;
+    PartitionResult res_;
+};
+
+using ReorderedSolver = BasicReorderedSolver<WeightedGraph>;
@@ -1,16 +1,24 @@
 #include "VertexSeparatorSolver.h"
+#include "FlowRefinement.h"
 #include "MinimumBisectionSolver.h"
 
-VertexSeparatorSolver::VertexSeparatorSolver(int bisection_passes)
+template<typename Graph>
+BasicVertexSeparatorSolver<Graph>::BasicVertexSeparatorSolver(int bisection_passes,
+                                                              int flow_rounds,
+                                                              double epsilon)
     : passes_(bisection_passes)
+    , flow_rounds_(flow_rounds)
+    , epsilon_(epsilon)
 {}
 
-std::string VertexSeparatorSolver::name() const
+template<typename Graph>
+std::string BasicVertexSeparatorSolver<Graph>::name() const
 {
     return "Balanced Vertex Separator (Heuristic from bisection boundary)";
 }
 
-std::string VertexSeparatorSolver::statement() const
+template<typename Graph>
+std::string BasicVertexSeparatorSolver<Graph>::statement() const
 {
     return "Input: undirected graph G=(V,E,w).\n"
            "Goal: find a vertex separator S subset of V and two nonempty sets A,B subset of "
@@ -23,47 +31,43 @@ std::string VertexSeparatorSolver::statement() const
            "Output: separator[] stores S; part[] is the 2-way labeling used to derive S.";
 }
 
-std::string VertexSeparatorSolver::complexity() const
+template<typename Graph>
+std::string BasicVertexSeparatorSolver<Graph>::complexity() const
 {
-    return "Optimization is NP-hard. This heuristic: bisection heuristic + boundary scan, "
-           "~O(p*n^2 + m).";
+    return "Optimization is NP-hard. This heuristic: bisection heuristic + minimum vertex cover "
+           "of the cut edges, ~O(p*n^2 + m*sqrt(n)), then r rounds of min vertex cut (Dinic, "
+           "unit vertex capacities) on a corridor around S.";
 }
 
-void VertexSeparatorSolver::solve(const WeightedGraph &g)
+template<typename Graph>
+void BasicVertexSeparatorSolver<Graph>::solve(const Graph &g)
 {
     res_ = {};
     if (g.n == 0)
         return;
 
-    MinimumBisectionSolver bis(passes_);
+    BasicMinimumBisectionSolver<Graph> bis(passes_);
+    bis.set_control(this->control_);
     bis.solve(g);
     auto p = bis.result().part;
 
-    std::vector<char> isSep(g.n, 0);
-    for (int u = 0; u < g.n; ++u) {
-        for (auto &e : g.adj[u]) {
-            int v = e.to;
-            if (p[u] != p[v]) {
-                isSep[u] = 1;
-                isSep[v] = 1;
-            }
-        }
-    }
-
+    res_.separator = boundary_vertex_cover(g, p);
+    if (flow_rounds_ > 0 && !should_stop(this->control_))
+        flow_refine_separator(g, p, res_.separator, epsilon_, flow_rounds_);
+    res_.cut_weight = cut_weight_undirected(g, p);
     res_.part = std::move(p);
-    for (int i = 0; i < g.n; ++i)
-        if (isSep[i])
-            res_.separator.push_back(i);
-    res_.cut_weight = bis.result().cut_weight;
     res_.score = (double) res_.separator.size();
+    res_.stopped_early = was_stopped(this->control_);
 }
 
-PartitionResult VertexSeparatorSolver::result() const
+template<typename Graph>
+PartitionResult BasicVertexSeparatorSolver<Graph>::result() const
 {
     return res_;
 }
 
-void VertexSeparatorSolver::print(std::ostream &os) const
+template<typename Graph>
+void BasicVertexSeparatorSolver<Graph>::print(std::ostream &os) const
 {
     os << "\n=== " << name() << " ===\n";
     os << "Problem: " << statement() << "\n";
@@ -77,3 +81,123 @@ void VertexSeparatorSolver::print(std::ostream &os) const
     }
     os << "\n";
 }
+
+template<typename Graph>
+std::vector<int> BasicVertexSeparatorSolver<Graph>::boundary_vertex_cover(
+    const Graph &g, const std::vector<int> &part)
+{
+    // Bipartite boundary graph: left = side-0 endpoints of cut edges, right = side-1 endpoints.
+    std::vector<int> local(g.n, -1), left, right;
+    for (int u = 0; u < g.n; ++u) {
+        if (part[u] != 0 && part[u] != 1)
+            continue;
+        for (auto &e : g.adj[u]) {
+            int v = e.to;
+            if (part[v] == 1 - part[u]) {
+                local[u] = part[u] == 0 ? (int) left.size() : (int) right.size();
+                (part[u] == 0 ? left : right).push_back(u);
+                break;
+            }
+        }
+    }
+    int nl = (int) left.size(), nr = (int) right.size();
+    std::vector<std::vector<int>> adj(nl);
+    for (int i = 0; i < nl; ++i)
+        for (auto &e : g.adj[left[i]])
+            if (part[e.to] == 1)
+                adj[i].push_back(local[e.to]);
+
+    // Hopcroft-Karp with an explicit DFS stack.
+    const int inf = std::numeric_limits<int>::max();
+    std::vector<int> match_l(nl, -1), match_r(nr, -1), dist(nl), it(nl), stack;
+    while (true) {
+        std::queue<int> q;
+        for (int i = 0; i < nl; ++i) {
+            dist[i] = match_l[i] == -1 ? 0 : inf;
+            if (dist[i] == 0)
+                q.push(i);
+        }
+        bool found = false;
+        while (!q.empty()) {
+            int x = q.front();
+            q.pop();
+            for (int r : adj[x]) {
+                int y = match_r[r];
+                if (y == -1)
+                    found = true;
+                else if (dist[y] == inf) {
+                    dist[y] = dist[x] + 1;
+                    q.push(y);
+                }
+            }
+        }
+        if (!found)
+            break;
+
+        std::fill(it.begin(), it.end(), 0);
+        for (int root = 0; root < nl; ++root) {
+            if (match_l[root] != -1)
+                continue;
+            stack.assign(1, root);
+            while (!stack.empty()) {
+                int x = stack.back();
+                if (it[x] == (int) adj[x].size()) {
+                    dist[x] = inf;
+                    stack.pop_back();
+                    continue;
+                }
+                int r = adj[x][it[x]++];
+                int y = match_r[r];
+                if (y == -1) {
+                    // Augment: every stacked vertex takes the edge it last advanced along.
+                    for (int z : stack) {
+                        int rz = adj[z][it[z] - 1];
+                        match_l[z] = rz;
+                        match_r[rz] = z;
+                    }
+                    break;
+                }
+                if (dist[y] == dist[x] + 1)
+                    stack.push_back(y);
+            }
+        }
+    }
+
+    // Koenig: Z = vertices reachable from free left vertices by alternating paths;
+    // cover = (left \ Z) U (right intersect Z).
+    std::vector<char> zl(nl, 0), zr(nr, 0);
+    std::queue<int> q;
+    for (int i = 0; i < nl; ++i)
+        if (match_l[i] == -1) {
+            zl[i] = 1;
+            q.push(i);
+        }
+    while (!q.empty()) {
+        int x = q.front();
+        q.pop();
+        for (int r : adj[x]) {
+            if (zr[r])
+                continue;
+            zr[r] = 1;
+            int y = match_r[r];
+            if (y != -1 && !zl[y]) {
+                zl[y] = 1;
+                q.push(y);
+            }
+        }
+    }
+
+    std::vector<int> cover;
+    for (int i = 0; i < nl; ++i)
+        if (!zl[i])
+            cover.push_back(left[i]);
+    for (int r = 0; r < nr; ++r)
+        if (zr[r])
+            cover.push_back(right[r]);
+    std::sort(cover.begin(), cover.end());
+    return cover;
+}
+
+template class BasicVertexSeparatorSolver<WeightedGraph>;
+template class BasicVertexSeparatorSolver<CompactWeightedGraph>;
+template class BasicVertexSeparatorSolver<UnweightedGraph>;
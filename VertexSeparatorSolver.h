@@ -1,17 +1,32 @@
+#pragma once
 #include "GraphPartitionSolver.h"
 
-class VertexSeparatorSolver final : public IGraphPartitionSolver
+template<typename Graph>
+class BasicVertexSeparatorSolver final : public IBasicGraphPartitionSolver<Graph>
 {
 public:
-    explicit VertexSeparatorSolver(int bisection_passes = 15);
+    // flow_rounds rounds of flow_refine_separator (FlowRefinement.h) shrink the vertex cover while
+    // keeping both sides at most ceil((1 + epsilon) * n / 2) vertices.
+    explicit BasicVertexSeparatorSolver(int bisection_passes = 15,
+                                        int flow_rounds = 3,
+                                        double epsilon = 0.1);
     std::string name() const override;
     std::string statement() const override;
     std::string complexity() const override;
-    void solve(const WeightedGraph &g) override;
+    void solve(const Graph &g) override;
     PartitionResult result() const override;
     void print(std::ostream &os) const override;
 
+    // Minimum vertex cover of the edges between label 0 and label 1 of part[] (Koenig's
+    // theorem on the bipartite boundary graph, via Hopcroft-Karp matching). Removing the
+    // returned vertices disconnects the two sides. Result is sorted.
+    static std::vector<int> boundary_vertex_cover(const Graph &g, const std::vector<int> &part);
+
 private:
     int passes_;
+    int flow_rounds_;
+    double epsilon_;
     PartitionResult res_;
 };
+
+using VertexSeparatorSolver = BasicVertexSeparatorSolver<WeightedGraph>;
@@ -0,0 +1,154 @@
+#pragma once
+#include "../GraphUtils.h"
+#include <chrono>
+#include <random>
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Shared helpers for the standalone benchmark programs in this directory.
+namespace bench {
+
+inline double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs fn `reps` times and returns the fastest wall time in seconds.
+template<typename Fn>
+double best_of(int reps, Fn &&fn)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int r = 0; r < reps; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, seconds_since(start));
+    }
+    return best;
+}
+
+// rows x cols 4-neighbor grid with weights drawn from [1, max_w].
+template<typename Graph>
+Graph grid_graph(int rows, int cols, Weight max_w = 1, unsigned seed = 1)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<Weight> wd(1, max_w);
+    Graph g(rows * cols);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c) {
+            int u = r * cols + c;
+            if (c + 1 < cols)
+                g.add_undirected(u, u + 1, wd(rng));
+            if (r + 1 < rows)
+                g.add_undirected(u, u + cols, wd(rng));
+        }
+    return g;
+}
+
+// Erdos-Renyi style multigraph with m random edges and weights drawn from [1, max_w].
+template<typename Graph>
+Graph random_graph(int n, long long m, Weight max_w = 1, unsigned seed = 1)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> vd(0, n - 1);
+    std::uniform_int_distribution<Weight> wd(1, max_w);
+    Graph g(n);
+    for (long long i = 0; i < m; ++i) {
+        int u = vd(rng), v = vd(rng);
+        if (u != v)
+            g.add_undirected(u, v, wd(rng));
+    }
+    return g;
+}
+
+// Relabels g with a random permutation, imitating arbitrary external vertex ids.
+template<typename Graph>
+Graph shuffle_ids(const Graph &g, unsigned seed = 3)
+{
+    std::vector<int> perm(g.n);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::shuffle(perm.begin(), perm.end(), std::mt19937(seed));
+    Graph out(g.n);
+    for (int u = 0; u < g.n; ++u)
+        for (auto e : g.adj[u]) {
+            e.to = perm[e.to];
+            out.adj[perm[u]].push_back(e);
+        }
+    return out;
+}
+
+// Hardware last-level cache miss counter for the calling thread (Linux perf events). available()
+// is false when the kernel or sandbox does not expose the counter.
+class CacheMissCounter
+{
+public:
+    CacheMissCounter()
+    {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+    ~CacheMissCounter()
+    {
+#ifdef __linux__
+        if (fd_ >= 0)
+            close(fd_);
+#endif
+    }
+    CacheMissCounter(const CacheMissCounter &) = delete;
+    CacheMissCounter &operator=(const CacheMissCounter &) = delete;
+
+    bool available() const { return fd_ >= 0; }
+
+    void start()
+    {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Misses since start(), or -1 if unavailable.
+    long long stop()
+    {
+        long long count = -1;
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &count, sizeof(count)) != (ssize_t) sizeof(count))
+                count = -1;
+        }
+#endif
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+inline std::vector<int> random_labels(int n, int k, unsigned seed = 2)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> d(0, k - 1);
+    std::vector<int> part(n);
+    for (auto &p : part)
+        p = d(rng);
+    return part;
+}
+
+} // namespace bench
@@ -0,0 +1,49 @@
+// Cost of CachedSolver: graph fingerprint versus a full multilevel solve, in-memory hit latency
+// and disk-spill reload latency.
+//
+//   CacheBenchmark [grid_side] [k] [spill_dir]
+#include "../MultilevelKWayPartitionSolver.h"
+#include "../PartitionCache.h"
+#include "BenchUtils.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char **argv)
+{
+    int side = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int k = argc > 2 ? std::atoi(argv[2]) : 16;
+    std::string spill_dir = argc > 3 ? argv[3] : "partition_cache_bench";
+
+    WeightedGraph g = bench::grid_graph<WeightedGraph>(side, side, 100);
+    std::printf("grid %dx%d, k=%d\n", side, side, k);
+
+    std::uint64_t h = 0;
+    double hash = bench::best_of(5, [&] { h = graph_fingerprint(g); });
+    std::printf("fingerprint      %10.3f ms  (%016llx)\n", hash * 1e3, (unsigned long long) h);
+
+    // Capacity 1: the second graph's entry pushes the first one to disk.
+    auto cache = std::make_shared<PartitionCache>(1, spill_dir);
+    CachedSolver solver(std::make_unique<MultilevelKWayPartitionSolver>(k),
+                        cache,
+                        "k=" + std::to_string(k));
+    auto start = std::chrono::steady_clock::now();
+    solver.solve(g);
+    double miss = bench::seconds_since(start);
+    std::printf("miss (solve)     %10.3f ms  hash = %.1f%% of solve\n",
+                miss * 1e3,
+                100.0 * hash / miss);
+
+    double hit = bench::best_of(5, [&] { solver.solve(g); });
+    std::printf("memory hit       %10.3f ms  x%.0f faster than solving\n", hit * 1e3, miss / hit);
+
+    WeightedGraph other = bench::grid_graph<WeightedGraph>(side, side, 100, 2);
+    solver.solve(other);
+    start = std::chrono::steady_clock::now();
+    solver.solve(g);
+    double disk = bench::seconds_since(start);
+    std::printf("disk hit         %10.3f ms  (hit=%d, disk hits=%lld)\n",
+                disk * 1e3,
+                (int) solver.last_hit(),
+                cache->disk_hits());
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Memory saved by CompressedGraph versus decode overhead, against the plain WeightedGraph
+// layout: adjacency bytes, a full-graph cut evaluation, one coarsening-style degree pass and a
+// multilevel solve. Ids are the generator's (grid: row-major) and shuffled.
+//
+//   CompressionBenchmark [grid_side] [random_n] [random_m] [k]
+#include "../CompressedGraph.h"
+#include "../MultilevelKWayPartitionSolver.h"
+#include "BenchUtils.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+void run(const char *name, const WeightedGraph &g, int k)
+{
+    CompressedGraph cg(g);
+    WeightedGraph sorted = cg.decompress(); // same row order, so both see identical work
+    auto part = bench::random_labels(g.n, k);
+
+    double plain_mb = adjacency_memory_bytes(sorted) / 1048576.0;
+    double packed_mb = cg.memory_bytes() / 1048576.0;
+    Weight c1 = 0, c2 = 0;
+    double cut_plain = bench::best_of(3, [&] { c1 = cut_weight_undirected(sorted, part); });
+    double cut_packed = bench::best_of(3, [&] { c2 = cut_weight_undirected(cg, part); });
+    double deg_plain = bench::best_of(3, [&] { sorted.degrees(); });
+    double deg_packed = bench::best_of(3, [&] { cg.degrees(); });
+
+    MultilevelKWayPartitionSolver ml_plain(k);
+    BasicMultilevelKWayPartitionSolver<CompressedGraph> ml_packed(k);
+    double solve_plain = bench::best_of(1, [&] { ml_plain.solve(sorted); });
+    double solve_packed = bench::best_of(1, [&] { ml_packed.solve(cg); });
+
+    long long arcs = 0;
+    for (auto &row : g.adj)
+        arcs += (long long) row.size();
+    std::printf("%s: n=%d arcs=%lld\n", name, g.n, arcs);
+    std::printf("  memory    %9.1f MB -> %9.1f MB  (%.2fx smaller, %.2f bytes/arc)\n",
+                plain_mb,
+                packed_mb,
+                plain_mb / packed_mb,
+                cg.memory_bytes() / (double) std::max(1LL, arcs));
+    std::printf("  cut       %9.3f ms -> %9.3f ms  (x%.2f)%s\n",
+                cut_plain * 1e3,
+                cut_packed * 1e3,
+                cut_packed / cut_plain,
+                c1 == c2 ? "" : "  MISMATCH");
+    std::printf("  degrees   %9.3f ms -> %9.3f ms  (x%.2f)\n",
+                deg_plain * 1e3,
+                deg_packed * 1e3,
+                deg_packed / deg_plain);
+    std::printf("  multilevel%9.3f s  -> %9.3f s   (x%.2f) cut %lld / %lld\n",
+                solve_plain,
+                solve_packed,
+                solve_packed / solve_plain,
+                ml_plain.result().cut_weight,
+                ml_packed.result().cut_weight);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int side = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int rn = argc > 2 ? std::atoi(argv[2]) : 1000000;
+    long long rm = argc > 3 ? std::atoll(argv[3]) : 8000000;
+    int k = argc > 4 ? std::atoi(argv[4]) : 16;
+
+    WeightedGraph grid = bench::grid_graph<WeightedGraph>(side, side, 4);
+    run("grid", grid, k);
+    run("grid, shuffled ids", bench::shuffle_ids(grid), k);
+    run("random", bench::random_graph<WeightedGraph>(rn, rm, 1), k);
+    return 0;
+}
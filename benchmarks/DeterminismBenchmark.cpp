@@ -0,0 +1,184 @@
+// Reproducibility harness for the parallel code paths. Every solver with a thread count runs
+// with 1, 2, 4 and 8 threads, three times each, and all runs must produce the same
+// PartitionResult: the multilevel solver in ParallelMode::Deterministic, the multiway cut, nested
+// dissection, the parallel s-t min cut, the partition metrics, and the distributed solver at a
+// fixed rank count over both transports. ParallelMode::Fast is only reported (number of distinct
+// results). Finally Sequential, Deterministic and Fast multilevel solves are timed against each
+// other. Exits with status 1 if any required result differs.
+//
+//   DeterminismBenchmark [grid_side] [k] [max_threads]
+#include "../DistributedMultilevelSolver.h"
+#include "../MultilevelKWayPartitionSolver.h"
+#include "../MultiwayCutSolver.h"
+#include "../NestedDissectionSolver.h"
+#include "../PartitionMetrics.h"
+#include "../STMinCutSolver.h"
+#include "BenchUtils.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <set>
+
+namespace {
+
+std::uint64_t mix(std::uint64_t h, std::uint64_t x)
+{
+    x *= 0x9e3779b97f4a7c15ULL;
+    x ^= x >> 29;
+    h = (h ^ x) * 0xbf58476d1ce4e5b9ULL;
+    return h ^ (h >> 31);
+}
+
+std::uint64_t result_hash(const PartitionResult &r)
+{
+    std::uint64_t h = mix(0, (std::uint64_t) r.cut_weight);
+    std::uint64_t score;
+    std::memcpy(&score, &r.score, sizeof(score));
+    h = mix(h, score);
+    for (int p : r.part)
+        h = mix(h, (std::uint64_t) p);
+    h = mix(h, (std::uint64_t) r.separator.size());
+    for (int v : r.separator)
+        h = mix(h, (std::uint64_t) v);
+    return h;
+}
+
+std::uint64_t metrics_hash(const PartitionMetrics &m)
+{
+    std::uint64_t h = mix(0, (std::uint64_t) m.cut_weight);
+    for (long long x : {m.cut_edges,
+                        m.boundary_vertices,
+                        m.communication_volume,
+                        m.max_communication_volume,
+                        m.quotient_edges})
+        h = mix(h, (std::uint64_t) x);
+    for (long long s : m.block_sizes)
+        h = mix(h, (std::uint64_t) s);
+    for (long long s : m.block_communication_volume)
+        h = mix(h, (std::uint64_t) s);
+    return h;
+}
+
+std::vector<int> thread_counts(int max_threads)
+{
+    std::vector<int> counts;
+    for (int t = 1; t <= max_threads; t *= 2)
+        counts.push_back(t);
+    return counts;
+}
+
+// Runs fn(threads) three times per thread count; returns the number of distinct hashes.
+int distinct_results(int max_threads, const std::function<std::uint64_t(int)> &fn)
+{
+    std::set<std::uint64_t> seen;
+    for (int threads : thread_counts(max_threads))
+        for (int rep = 0; rep < 3; ++rep)
+            seen.insert(fn(threads));
+    return (int) seen.size();
+}
+
+bool check(const char *name, int max_threads, const std::function<std::uint64_t(int)> &fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    int distinct = distinct_results(max_threads, fn);
+    std::printf("  %-32s %s (%d distinct, %.3f s)\n",
+                name,
+                distinct == 1 ? "identical" : "MISMATCH",
+                distinct,
+                bench::seconds_since(start));
+    return distinct == 1;
+}
+
+PartitionResult solve_multilevel(const WeightedGraph &g, int k, ParallelMode mode, int threads)
+{
+    MultilevelKWayPartitionSolver ml(k);
+    ParallelOptions options;
+    options.mode = mode;
+    options.threads = threads;
+    ml.set_parallel(options);
+    ml.solve(g);
+    return ml.result();
+}
+
+int largest_block(const std::vector<int> &part, int k)
+{
+    std::vector<int> sizes(k, 0);
+    for (int p : part)
+        sizes[p]++;
+    return *std::max_element(sizes.begin(), sizes.end());
+}
+
+bool run(const char *name, const WeightedGraph &g, int k, int max_threads)
+{
+    std::printf("%s: n=%d k=%d threads 1..%d\n", name, g.n, k, max_threads);
+    bool ok = true;
+    ok &= check("multilevel deterministic", max_threads, [&](int threads) {
+        return result_hash(solve_multilevel(g, k, ParallelMode::Deterministic, threads));
+    });
+    ok &= check("multiway cut", max_threads, [&](int threads) {
+        MultiwayCutSolver mc({{0}, {g.n / 2}, {g.n - 1}}, threads);
+        mc.solve(g);
+        return result_hash(mc.result());
+    });
+    ok &= check("nested dissection", max_threads, [&](int threads) {
+        NestedDissectionSolver nd(64, threads);
+        nd.solve(g);
+        std::uint64_t h = result_hash(nd.result());
+        for (int v : nd.permutation())
+            h = mix(h, (std::uint64_t) v);
+        return h;
+    });
+    ok &= check("s-t min cut (parallel flow)", max_threads, [&](int threads) {
+        STMinCutSolver st(0, g.n - 1, threads);
+        st.solve(g);
+        return result_hash(st.result());
+    });
+    std::vector<int> part = solve_multilevel(g, k, ParallelMode::Sequential, 1).part;
+    ok &= check("partition metrics", max_threads, [&](int threads) {
+        return metrics_hash(compute_partition_metrics(g, part, k, threads));
+    });
+    // The distributed result depends on the rank count, not on scheduling: repeat at 4 ranks.
+    for (auto backend : {TransportBackend::InProcess, TransportBackend::UnixSocket})
+        ok &= check(backend == TransportBackend::InProcess ? "distributed 4 ranks (threads)"
+                                                           : "distributed 4 ranks (sockets)",
+                    1,
+                    [&](int) {
+                        DistributedMultilevelSolver ds(k, 4, backend);
+                        ds.solve(g);
+                        return result_hash(ds.result());
+                    });
+    int fast = distinct_results(max_threads, [&](int threads) {
+        return result_hash(solve_multilevel(g, k, ParallelMode::Fast, threads));
+    });
+    std::printf("  %-32s %d distinct (not required to match)\n", "multilevel fast", fast);
+
+    for (auto mode : {ParallelMode::Sequential, ParallelMode::Deterministic, ParallelMode::Fast}) {
+        PartitionResult r;
+        double t = bench::best_of(3, [&] { r = solve_multilevel(g, k, mode, max_threads); });
+        std::printf("  %-13s %8.3f s  cut %lld  largest %d\n",
+                    mode == ParallelMode::Sequential      ? "sequential"
+                    : mode == ParallelMode::Deterministic ? "deterministic"
+                                                          : "fast",
+                    t,
+                    r.cut_weight,
+                    largest_block(r.part, k));
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int side = argc > 1 ? std::atoi(argv[1]) : 300;
+    int k = argc > 2 ? std::atoi(argv[2]) : 16;
+    int max_threads = argc > 3 ? std::atoi(argv[3]) : 8;
+
+    bool ok = run("grid", bench::grid_graph<WeightedGraph>(side, side, 4), k, max_threads);
+    ok &= run("random",
+              bench::random_graph<WeightedGraph>(side * side, 4LL * side * side, 3),
+              k,
+              max_threads);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+// Distributed multilevel partitioning against the sequential multilevel solver: time, cut and
+// largest block for 1..8 ranks over the in-process and Unix-socket transports, all ranks as
+// threads of this process, and once more with every rank in its own forked process joined
+// through connect_unix_socket_group.
+//
+//   DistributedBenchmark [grid_side] [k] [socket_dir]
+#include "../DistributedMultilevelSolver.h"
+#include "../MultilevelKWayPartitionSolver.h"
+#include "BenchUtils.h"
+#include <cstdio>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+int largest_block(const std::vector<int> &part, int k)
+{
+    std::vector<int> sizes(k, 0);
+    for (int p : part)
+        sizes[p]++;
+    return *std::max_element(sizes.begin(), sizes.end());
+}
+
+void run(const char *name, const WeightedGraph &g, int k, const std::string &socket_dir)
+{
+    MultilevelKWayPartitionSolver ml(k);
+    double t = bench::best_of(1, [&] { ml.solve(g); });
+    std::printf("%s: n=%d k=%d\n", name, g.n, k);
+    std::printf("  sequential            %8.3f s  cut %lld  largest %d\n",
+                t,
+                ml.result().cut_weight,
+                largest_block(ml.result().part, k));
+
+    for (auto backend : {TransportBackend::InProcess, TransportBackend::UnixSocket})
+        for (int ranks : {1, 2, 4, 8}) {
+            DistributedMultilevelSolver ds(k, ranks, backend);
+            t = bench::best_of(1, [&] { ds.solve(g); });
+            bool valid = cut_weight_undirected(g, ds.result().part) == ds.result().cut_weight;
+            std::printf("  %-8s ranks=%d     %8.3f s  cut %lld  largest %d%s\n",
+                        backend == TransportBackend::InProcess ? "threads" : "sockets",
+                        ranks,
+                        t,
+                        ds.result().cut_weight,
+                        largest_block(ds.result().part, k),
+                        valid ? "" : "  CUT MISMATCH");
+        }
+
+    // One process per rank; rank 0 reports the cut through a pipe.
+    int ranks = 4;
+    int fds[2];
+    if (pipe(fds) != 0)
+        return;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<pid_t> children;
+    for (int r = 0; r < ranks; ++r) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            auto transport = connect_unix_socket_group(socket_dir, r, ranks);
+            DistributedGraph shard = distribute_graph(g, *transport);
+            DistributedMultilevelPartitioner partitioner(k);
+            std::vector<int> part = partitioner.partition(shard, *transport);
+            Weight cut = distributed_cut_weight(shard, *transport, part);
+            if (r == 0 && write(fds[1], &cut, sizeof(cut)) != (ssize_t) sizeof(cut))
+                _exit(1);
+            transport.reset();
+            _exit(0);
+        }
+        children.push_back(pid);
+    }
+    close(fds[1]);
+    Weight cut = -1;
+    if (read(fds[0], &cut, sizeof(cut)) != (ssize_t) sizeof(cut))
+        cut = -1;
+    close(fds[0]);
+    for (pid_t pid : children)
+        waitpid(pid, nullptr, 0);
+    std::printf(
+        "  processes ranks=%d   %8.3f s  cut %lld\n", ranks, bench::seconds_since(start), cut);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int side = argc > 1 ? std::atoi(argv[1]) : 300;
+    int k = argc > 2 ? std::atoi(argv[2]) : 16;
+    std::string dir = argc > 3 ? argv[3] : "/tmp";
+
+    run("grid", bench::grid_graph<WeightedGraph>(side, side, 4), k, dir);
+    run("random", bench::random_graph<WeightedGraph>(side * side, 4LL * side * side, 3), k, dir);
+    return 0;
+}
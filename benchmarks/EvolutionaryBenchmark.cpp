@@ -0,0 +1,75 @@
+// Quality against time: EvolutionarySolver's best cut after every improvement, next to one
+// MultilevelKWayPartitionSolver run and to the best of as many independently seeded runs as the
+// search evaluated (repeated restarts with the same time), on a weighted grid and a random
+// graph. Also reports the imbalance of the final partition.
+//
+//   EvolutionaryBenchmark [grid_side] [k] [budget_ms] [threads] [population]
+#include "../EvolutionarySolver.h"
+#include "../MultilevelKWayPartitionSolver.h"
+#include "../PartitionMetrics.h"
+#include "BenchUtils.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+void run(const char *name, const WeightedGraph &g, int k, EvolutionOptions options)
+{
+    std::printf("%s: n=%d k=%d budget=%lld ms\n",
+                name,
+                g.n,
+                k,
+                (long long) options.time_budget.count());
+
+    MultilevelKWayPartitionSolver ml(k);
+    double t = bench::best_of(1, [&] { ml.solve(g); });
+    std::printf("  multilevel   %8.3f s  cut %lld\n", t, ml.result().cut_weight);
+
+    // Restarts: fresh seeds until the same budget is spent.
+    Weight best = std::numeric_limits<Weight>::max();
+    int restarts = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (bench::seconds_since(start) * 1000 < options.time_budget.count()) {
+        MultilevelKWayPartitionSolver r(k);
+        r.set_parallel({ParallelMode::Deterministic, 1, (std::uint64_t) restarts + 1});
+        r.solve(g);
+        best = std::min(best, r.result().cut_weight);
+        restarts++;
+    }
+    std::printf("  restarts     %8.3f s  cut %lld  (%d runs)\n",
+                bench::seconds_since(start),
+                best,
+                restarts);
+
+    EvolutionarySolver evo(k, options);
+    t = bench::best_of(1, [&] { evo.solve(g); });
+    for (const auto &p : evo.curve())
+        std::printf("    %8.3f s  cut %-8lld after %lld offspring\n",
+                    p.seconds,
+                    p.cut_weight,
+                    p.offspring);
+    std::printf("  evolutionary %8.3f s  cut %lld  (%lld offspring)  imbalance %.3f\n",
+                t,
+                evo.result().cut_weight,
+                evo.offspring(),
+                compute_partition_metrics(g, evo.result().part, k).imbalance);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int side = argc > 1 ? std::atoi(argv[1]) : 100;
+    int k = argc > 2 ? std::atoi(argv[2]) : 8;
+    EvolutionOptions options;
+    options.time_budget = std::chrono::milliseconds(argc > 3 ? std::atoi(argv[3]) : 5000);
+    options.threads = argc > 4 ? std::atoi(argv[4]) : 0;
+    options.population = argc > 5 ? std::atoi(argv[5]) : 16;
+
+    run("grid", bench::grid_graph<WeightedGraph>(side, side, 4), k, options);
+    run("random",
+        bench::random_graph<WeightedGraph>(side * side, 4LL * side * side, 3),
+        k,
+        options);
+    return 0;
+}
@@ -0,0 +1,79 @@
+// External-memory multilevel partitioning versus the in-memory solver: time, cut, largest block
+// and, for the external solver, disk levels, I/O volume and the peak edge data held in memory
+// for several memory budgets. The graph is written to a graph file in work_dir first, as an
+// out-of-core input would be.
+//
+//   ExternalMemoryBenchmark [grid_side] [k] [work_dir]
+#include "../ExternalMultilevelSolver.h"
+#include "../GraphFile.h"
+#include "../MultilevelKWayPartitionSolver.h"
+#include "BenchUtils.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+int largest_block(const std::vector<int> &part)
+{
+    std::vector<int> sizes;
+    for (int p : part) {
+        if (p >= (int) sizes.size())
+            sizes.resize(p + 1, 0);
+        sizes[p]++;
+    }
+    return sizes.empty() ? 0 : *std::max_element(sizes.begin(), sizes.end());
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int side = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int k = argc > 2 ? std::atoi(argv[2]) : 16;
+    std::string dir = argc > 3 ? argv[3] : ".";
+
+    WeightedGraph g = bench::grid_graph<WeightedGraph>(side, side, 4);
+    long long arcs = 0;
+    for (auto &row : g.adj)
+        arcs += (long long) row.size();
+    std::string path = dir + "/external-benchmark.graph";
+    write_graph_file(g, path);
+    std::printf("grid %dx%d: n=%d arcs=%lld (%.1f MB of edges), k=%d, ideal block %d\n",
+                side,
+                side,
+                g.n,
+                arcs,
+                arcs * sizeof(WeightedGraph::Edge) / 1048576.0,
+                k,
+                (g.n + k - 1) / k);
+
+    MultilevelKWayPartitionSolver ml(k);
+    double t = bench::best_of(1, [&] { ml.solve(g); });
+    std::printf("  in-memory            %8.3f s  cut %lld  largest %d\n",
+                t,
+                ml.result().cut_weight,
+                largest_block(ml.result().part));
+    g = WeightedGraph();
+
+    std::size_t full = (std::size_t) arcs * sizeof(WeightedGraph::Edge);
+    for (std::size_t budget : {full * 4, full, full / 4, full / 16}) {
+        ExternalMemoryConfig config;
+        config.work_dir = dir;
+        config.memory_budget = budget;
+        ExternalMultilevelSolver ext(k, config);
+        t = bench::best_of(1, [&] { ext.solve_file(path); });
+        auto st = ext.stats();
+        std::printf("  budget %8.1f MB    %8.3f s  cut %lld  largest %d  disk levels %d  "
+                    "read %.1f MB  written %.1f MB  peak edges %.1f MB\n",
+                    budget / 1048576.0,
+                    t,
+                    ext.result().cut_weight,
+                    largest_block(ext.result().part),
+                    st.disk_levels,
+                    st.bytes_read / 1048576.0,
+                    st.bytes_written / 1048576.0,
+                    st.peak_edge_bytes / 1048576.0);
+    }
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,166 @@
+// Regression benchmark for MaxFlow on deep grid graphs. Long, thin grids give level graphs as
+// deep as the grid is long; the iterative blocking flow must handle them on a small thread
+// stack. Each grid is solved by MaxFlow on a thread with a 64 KiB stack and, where the depth
+// allows it, by the previous recursive single-path Dinic for comparison.
+//
+//   FlowBenchmark [max_cells]
+#include "../MaxFlow.h"
+#include "BenchUtils.h"
+#include <pthread.h>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+namespace {
+
+// The recursive single-path Dinic that MaxFlow replaced, kept as a baseline.
+struct RecursiveDinic
+{
+    struct Arc
+    {
+        int to, rev;
+        Weight cap;
+    };
+    int n;
+    std::vector<std::vector<Arc>> g;
+    std::vector<int> lvl, it;
+
+    explicit RecursiveDinic(int n_)
+        : n(n_)
+        , g(n_)
+    {}
+
+    void add_undirected_edge(int u, int v, Weight c)
+    {
+        g[u].push_back({v, (int) g[v].size(), c});
+        g[v].push_back({u, (int) g[u].size() - 1, c});
+    }
+
+    bool bfs(int s, int t)
+    {
+        lvl.assign(n, -1);
+        std::queue<int> q;
+        lvl[s] = 0;
+        q.push(s);
+        while (!q.empty()) {
+            int u = q.front();
+            q.pop();
+            for (auto &e : g[u])
+                if (e.cap > 0 && lvl[e.to] < 0) {
+                    lvl[e.to] = lvl[u] + 1;
+                    q.push(e.to);
+                }
+        }
+        return lvl[t] >= 0;
+    }
+
+    Weight dfs(int u, int t, Weight f)
+    {
+        if (u == t)
+            return f;
+        for (int &i = it[u]; i < (int) g[u].size(); ++i) {
+            Arc &e = g[u][i];
+            if (e.cap <= 0 || lvl[e.to] != lvl[u] + 1)
+                continue;
+            Weight pushed = dfs(e.to, t, std::min(f, e.cap));
+            if (pushed > 0) {
+                e.cap -= pushed;
+                g[e.to][e.rev].cap += pushed;
+                return pushed;
+            }
+        }
+        return 0;
+    }
+
+    Weight max_flow(int s, int t)
+    {
+        Weight flow = 0;
+        while (bfs(s, t)) {
+            it.assign(n, 0);
+            while (Weight pushed = dfs(s, t, MaxFlow::infinite_capacity))
+                flow += pushed;
+        }
+        return flow;
+    }
+};
+
+template<typename Network>
+Network build_network(const WeightedGraph &g)
+{
+    Network net(g.n);
+    for (int u = 0; u < g.n; ++u)
+        for (auto &e : g.adj[u])
+            if (u < e.to)
+                net.add_undirected_edge(u, e.to, e.w);
+    return net;
+}
+
+// Runs fn on a thread with the given stack size; returns false if the thread could not start.
+bool run_with_stack(std::size_t stack_bytes, std::function<void()> fn)
+{
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, stack_bytes);
+    pthread_t th;
+    auto body = [](void *p) -> void * {
+        (*static_cast<std::function<void()> *>(p))();
+        return nullptr;
+    };
+    bool ok = pthread_create(&th, &attr, body, &fn) == 0;
+    pthread_attr_destroy(&attr);
+    if (ok)
+        pthread_join(th, nullptr);
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    long long max_cells = argc > 1 ? std::atoll(argv[1]) : 1 << 20;
+    // Recursion depth the baseline is trusted with on the default 8 MiB main-thread stack.
+    const int recursive_depth_limit = 20000;
+
+    std::printf("%-14s %10s %12s %10s %12s %8s\n",
+                "grid", "s-t hops", "flow", "iterative", "recursive", "speedup");
+    for (int rows : {1024, 64, 8, 2}) {
+        int cols = (int) std::min<long long>(max_cells / rows, 1 << 22);
+        if (cols < 2)
+            continue;
+        WeightedGraph g = bench::grid_graph<WeightedGraph>(rows, cols, 100);
+        int s = 0, t = g.n - 1;
+
+        Weight flow = 0;
+        double iterative = 0;
+        bool started = run_with_stack(64 * 1024, [&] {
+            MaxFlow net = build_network<MaxFlow>(g);
+            auto start = std::chrono::steady_clock::now();
+            flow = net.max_flow(s, t);
+            iterative = bench::seconds_since(start);
+        });
+        if (!started) {
+            std::fprintf(stderr, "could not start small-stack thread\n");
+            return 1;
+        }
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "%dx%d", rows, cols);
+        int depth = rows + cols - 2;
+        std::printf("%-14s %10d %12lld %9.3fs", name, depth, flow, iterative);
+        if (depth <= recursive_depth_limit) {
+            RecursiveDinic ref = build_network<RecursiveDinic>(g);
+            auto start = std::chrono::steady_clock::now();
+            Weight ref_flow = ref.max_flow(s, t);
+            double recursive = bench::seconds_since(start);
+            std::printf(" %11.3fs %7.2fx", recursive, recursive / iterative);
+            if (ref_flow != flow) {
+                std::printf("\nMISMATCH: recursive flow %lld\n", ref_flow);
+                return 1;
+            }
+        } else {
+            std::printf(" %12s %8s", "too deep", "-");
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+// Communication volume: CommunicationVolumeSolver (multilevel hypergraph partitioning of the
+// column-net model) against the edge-cut MultilevelKWayPartitionSolver, on grids and random
+// graphs up to millions of pins. Reports time, edge cut, communication volume and imbalance
+// from compute_partition_metrics, and checks that the solver's connectivity objective equals
+// the metric's volume.
+//
+//   HypergraphBenchmark [max_grid_side] [k]
+#include "../HypergraphPartitionSolver.h"
+#include "../MultilevelKWayPartitionSolver.h"
+#include "../PartitionMetrics.h"
+#include "BenchUtils.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+void report(const char *solver, double t, const PartitionMetrics &m)
+{
+    std::printf("  %-12s %8.3f s  cut %-9lld volume %-9lld imbalance %.3f\n",
+                solver,
+                t,
+                m.cut_weight,
+                m.communication_volume,
+                m.imbalance);
+}
+
+bool run(const char *name, const WeightedGraph &g, int k)
+{
+    Hypergraph h = communication_hypergraph(g);
+    std::printf("%s: n=%d nets=%d pins=%lld k=%d\n", name, g.n, h.num_nets(), h.num_pins(), k);
+
+    MultilevelKWayPartitionSolver ml(k);
+    double t = bench::best_of(1, [&] { ml.solve(g); });
+    report("edge cut", t, compute_partition_metrics(g, ml.result().part, k));
+
+    CommunicationVolumeSolver cv(k);
+    t = bench::best_of(1, [&] { cv.solve(g); });
+    PartitionMetrics m = compute_partition_metrics(g, cv.result().part, k);
+    report("volume", t, m);
+    if ((long long) cv.result().score != m.communication_volume) {
+        std::printf("  OBJECTIVE MISMATCH: %lld\n", (long long) cv.result().score);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int max_side = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int k = argc > 2 ? std::atoi(argv[2]) : 16;
+
+    bool ok = true;
+    for (int side = 100; side <= max_side; side *= 10) {
+        ok &= run("grid", bench::grid_graph<WeightedGraph>(side, side, 4), k);
+        ok &= run("random",
+                  bench::random_graph<WeightedGraph>(side * side, 4LL * side * side, 3),
+                  k);
+    }
+    return ok ? 0 : 1;
+}
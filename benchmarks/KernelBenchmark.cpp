@@ -0,0 +1,105 @@
+// Micro-benchmark for the row kernels in GraphKernels.h: runs every kernel under each
+// instruction set the CPU supports and reports time per edge and speedup over scalar.
+//
+//   KernelBenchmark [n] [avg_degree] [k]
+#include "../GraphKernels.h"
+#include "BenchUtils.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+struct KernelTimes
+{
+    double degree = 0, cut = 0, label = 0, blocks = 0;
+    Weight checksum = 0;
+};
+
+template<typename Graph>
+KernelTimes run_kernels(const Graph &g, const std::vector<int> &part, int k, int reps)
+{
+    KernelTimes t;
+    Weight deg_sum = 0, cut = 0, label_sum = 0, block_sum = 0;
+    t.degree = bench::best_of(reps, [&] {
+        auto deg = g.degrees();
+        deg_sum = std::accumulate(deg.begin(), deg.end(), (Weight) 0);
+    });
+    t.cut = bench::best_of(reps, [&] { cut = cut_weight_undirected(g, part); });
+    t.label = bench::best_of(reps, [&] {
+        label_sum = 0;
+        for (int u = 0; u < g.n; ++u)
+            label_sum += kernels::row_label_weight(g.adj[u].data(),
+                                                   g.adj[u].size(),
+                                                   part.data(),
+                                                   0);
+    });
+    std::vector<Weight> acc(k);
+    t.blocks = bench::best_of(reps, [&] {
+        block_sum = 0;
+        for (int u = 0; u < g.n; ++u) {
+            std::fill(acc.begin(), acc.end(), 0);
+            kernels::row_block_weights(g.adj[u].data(),
+                                       g.adj[u].size(),
+                                       part.data(),
+                                       k,
+                                       acc.data());
+            block_sum += acc[part[u]];
+        }
+    });
+    t.checksum = deg_sum ^ (cut * 31) ^ (label_sum * 131) ^ (block_sum * 1031);
+    return t;
+}
+
+template<typename Graph>
+void bench_graph(const char *label, int n, int avg_degree, int k)
+{
+    Graph g = bench::random_graph<Graph>(n,
+                                         (long long) n * avg_degree / 2,
+                                         Graph::is_weighted ? 1000 : 1);
+    auto part = bench::random_labels(n, k);
+    double edges = 0;
+    for (auto &row : g.adj)
+        edges += (double) row.size();
+
+    std::printf("\n%s: n=%d directed edges=%.0f edge bytes=%zu\n",
+                label,
+                n,
+                edges,
+                sizeof(typename Graph::Edge));
+    std::printf("%-8s %12s %12s %12s %12s\n", "isa", "degree", "cut", "label-sum", "block-conn");
+
+    kernels::Isa active = kernels::active_isa();
+    KernelTimes base{};
+    for (auto isa : {kernels::Isa::Scalar, kernels::Isa::Avx2, kernels::Isa::Avx512}) {
+        if ((int) isa > (int) kernels::detected_isa())
+            break;
+        kernels::set_isa(isa);
+        KernelTimes t = run_kernels(g, part, k, 5);
+        if (isa == kernels::Isa::Scalar)
+            base = t;
+        auto cell = [&](double s, double s0) {
+            std::printf(" %6.2fns x%4.2f", 1e9 * s / edges, s0 / s);
+        };
+        std::printf("%-8s", kernels::isa_name(isa));
+        cell(t.degree, base.degree);
+        cell(t.cut, base.cut);
+        cell(t.label, base.label);
+        cell(t.blocks, base.blocks);
+        std::printf("%s\n", t.checksum == base.checksum ? "" : "  MISMATCH");
+    }
+    kernels::set_isa(active);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int n = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+    int avg_degree = argc > 2 ? std::atoi(argv[2]) : 16;
+    int k = argc > 3 ? std::atoi(argv[3]) : 8;
+
+    bench_graph<WeightedGraph>("WeightedGraph", n, avg_degree, k);
+    bench_graph<CompactWeightedGraph>("CompactWeightedGraph", n, avg_degree, k);
+    bench_graph<UnweightedGraph>("UnweightedGraph", n, avg_degree, k);
+    return 0;
+}
@@ -0,0 +1,68 @@
+// Thread scaling of MaxFlow::parallel_max_flow (synchronous push-relabel) on a grid with
+// corner terminals and on a random graph, against sequential Dinic. Every run must reproduce
+// the Dinic flow value.
+//
+//   ParallelFlowBenchmark [grid_side] [random_n] [random_m] [max_threads]
+#include "../MaxFlow.h"
+#include "../ParallelUtils.h"
+#include "BenchUtils.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+MaxFlow build_network(const WeightedGraph &g)
+{
+    MaxFlow net(g.n);
+    for (int u = 0; u < g.n; ++u)
+        for (auto &e : g.adj[u])
+            if (u < e.to)
+                net.add_undirected_edge(u, e.to, e.w);
+    return net;
+}
+
+bool run(const char *name, const WeightedGraph &g, int s, int t, int max_threads)
+{
+    MaxFlow ref = build_network(g);
+    auto start = std::chrono::steady_clock::now();
+    Weight expected = ref.max_flow(s, t);
+    double dinic = bench::seconds_since(start);
+    std::printf("%s: n=%d flow=%lld dinic %.3fs\n", name, g.n, expected, dinic);
+
+    double one = 0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        MaxFlow net = build_network(g);
+        start = std::chrono::steady_clock::now();
+        Weight flow = net.parallel_max_flow(s, t, threads);
+        double sec = bench::seconds_since(start);
+        if (threads == 1)
+            one = sec;
+        std::printf("  threads=%-3d %9.3fs  x%5.2f vs 1 thread  x%5.2f vs dinic\n",
+                    threads,
+                    sec,
+                    one / sec,
+                    dinic / sec);
+        if (flow != expected) {
+            std::printf("MISMATCH: flow %lld\n", flow);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int side = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int rn = argc > 2 ? std::atoi(argv[2]) : 1000000;
+    long long rm = argc > 3 ? std::atoll(argv[3]) : 4000000;
+    int max_threads = argc > 4 ? std::atoi(argv[4]) : 64;
+    std::printf("hardware threads: %d\n", resolve_threads(0));
+
+    WeightedGraph grid = bench::grid_graph<WeightedGraph>(side, side, 100);
+    WeightedGraph rnd = bench::random_graph<WeightedGraph>(rn, rm, 100);
+    bool ok = run("grid", grid, 0, grid.n - 1, max_threads);
+    ok = run("random", rnd, 0, rnd.n - 1, max_threads) && ok;
+    return ok ? 0 : 1;
+}
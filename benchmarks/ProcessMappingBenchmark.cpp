@@ -0,0 +1,85 @@
+// Process mapping on a 3-level machine (cores per socket, sockets per node, nodes; distances
+// 1, 10, 100): the multilevel partition with blocks placed on PEs by id, at random, by the
+// greedy construction of map_blocks alone and with swap refinement. Reports the mapping time,
+// the distance-weighted communication cost and the cut weight between nodes, on a grid and a
+// random graph.
+//
+//   ProcessMappingBenchmark [grid_side] [cores] [sockets] [nodes]
+#include "../MultilevelKWayPartitionSolver.h"
+#include "../ProcessMapping.h"
+#include "BenchUtils.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// Weight of the edges whose endpoints sit on different nodes.
+Weight inter_node_cut(const WeightedGraph &g, const std::vector<int> &part, int node_pes)
+{
+    Weight cut = 0;
+    for (int u = 0; u < g.n; ++u)
+        for (auto &e : g.adj[u])
+            if (u < e.to && part[u] / node_pes != part[e.to] / node_pes)
+                cut += e.w;
+    return cut;
+}
+
+void report(const char *mapping,
+            double t,
+            const WeightedGraph &g,
+            const std::vector<int> &blocks,
+            const std::vector<int> &pe,
+            const MachineTopology &topo)
+{
+    std::vector<int> part(g.n);
+    for (int v = 0; v < g.n; ++v)
+        part[v] = pe[blocks[v]];
+    std::printf("  %-10s %8.4f s  cost %-10lld inter-node cut %lld\n",
+                mapping,
+                t,
+                mapping_cost(g, part, topo),
+                inter_node_cut(g, part, topo.levels()[0] * topo.levels()[1]));
+}
+
+void run(const char *name, const WeightedGraph &g, const MachineTopology &topo)
+{
+    int k = topo.num_pes();
+    MultilevelKWayPartitionSolver ml(k);
+    double t = bench::best_of(1, [&] { ml.solve(g); });
+    const auto &blocks = ml.result().part;
+    std::printf("%s: n=%d PEs=%d partition %.3f s cut %lld\n",
+                name,
+                g.n,
+                k,
+                t,
+                ml.result().cut_weight);
+
+    std::vector<int> identity(k);
+    std::iota(identity.begin(), identity.end(), 0);
+    report("identity", 0, g, blocks, identity, topo);
+    std::vector<int> shuffled = identity;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(5));
+    report("random", 0, g, blocks, shuffled, topo);
+
+    WeightedGraph q = quotient_graph(g, blocks, k);
+    std::vector<int> pe;
+    t = bench::best_of(3, [&] { pe = map_blocks(q, topo, 0); });
+    report("greedy", t, g, blocks, pe, topo);
+    t = bench::best_of(3, [&] { pe = map_blocks(q, topo); });
+    report("swaps", t, g, blocks, pe, topo);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int side = argc > 1 ? std::atoi(argv[1]) : 400;
+    int cores = argc > 2 ? std::atoi(argv[2]) : 8;
+    int sockets = argc > 3 ? std::atoi(argv[3]) : 2;
+    int nodes = argc > 4 ? std::atoi(argv[4]) : 16;
+    MachineTopology topo({cores, sockets, nodes}, {1, 10, 100});
+
+    run("grid", bench::grid_graph<WeightedGraph>(side, side, 4), topo);
+    run("random", bench::random_graph<WeightedGraph>(side * side, 4LL * side * side, 3), topo);
+    return 0;
+}
@@ -0,0 +1,104 @@
+// Cache behavior of the solvers on a grid whose vertex ids were shuffled, before and after each
+// reordering strategy in VertexReordering.h. Reports wall time and last-level cache misses
+// (when perf events are available) for the multilevel solver and a cut evaluation.
+//
+//   ReorderBenchmark [side] [k]
+#include "../MultilevelKWayPartitionSolver.h"
+#include "../VertexReordering.h"
+#include "BenchUtils.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+struct Sample
+{
+    double seconds = 0;
+    long long misses = -1;
+    Weight cut = 0;
+};
+
+template<typename Fn>
+Sample measure(bench::CacheMissCounter &counter, Fn &&fn)
+{
+    Sample s;
+    counter.start();
+    auto start = std::chrono::steady_clock::now();
+    s.cut = fn();
+    s.seconds = bench::seconds_since(start);
+    s.misses = counter.stop();
+    return s;
+}
+
+void report(const char *what, const char *order, const Sample &s, const Sample &base)
+{
+    std::printf("%-10s %-22s %9.3fs x%5.2f", what, order, s.seconds, base.seconds / s.seconds);
+    if (s.misses >= 0)
+        std::printf(" %12lld misses x%5.2f", s.misses, (double) base.misses / (double) s.misses);
+    else
+        std::printf(" %12s", "misses n/a");
+    std::printf(" cut=%lld\n", s.cut);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int side = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int k = argc > 2 ? std::atoi(argv[2]) : 16;
+
+    WeightedGraph g = bench::shuffle_ids(bench::grid_graph<WeightedGraph>(side, side, 100));
+    auto part = bench::random_labels(g.n, k);
+    bench::CacheMissCounter counter;
+    std::printf("grid %dx%d with shuffled ids, k=%d%s\n",
+                side,
+                side,
+                k,
+                counter.available() ? "" : " (perf events unavailable: no miss counts)");
+
+    struct Variant
+    {
+        const char *name;
+        std::vector<int> order;
+    };
+    std::vector<Variant> variants;
+    std::vector<int> identity(g.n);
+    std::iota(identity.begin(), identity.end(), 0);
+    variants.push_back({"shuffled (input)", identity});
+
+    auto start = std::chrono::steady_clock::now();
+    variants.push_back({"reverse Cuthill-McKee", reverse_cuthill_mckee_order(g)});
+    std::printf("rcm order computed in %.3fs\n", bench::seconds_since(start));
+    variants.push_back({"degree descending", degree_descending_order(g)});
+    MultilevelKWayPartitionSolver blocks(k);
+    blocks.solve(g);
+    variants.push_back(
+        {"partition blocks", partition_blocks_order(blocks.result().part, variants[1].order)});
+
+    Sample base_cut, base_ml;
+    for (auto &v : variants) {
+        WeightedGraph pg = permute_graph(g, v.order);
+        std::vector<int> ppart(g.n);
+        for (int i = 0; i < g.n; ++i)
+            ppart[i] = part[v.order[i]];
+
+        Sample cut = measure(counter, [&] {
+            Weight c = 0;
+            for (int r = 0; r < 10; ++r)
+                c = cut_weight_undirected(pg, ppart);
+            return c;
+        });
+        Sample ml = measure(counter, [&] {
+            MultilevelKWayPartitionSolver solver(k);
+            solver.solve(pg);
+            return solver.result().cut_weight;
+        });
+        if (&v == &variants.front()) {
+            base_cut = cut;
+            base_ml = ml;
+        }
+        report("cut x10", v.name, cut, base_cut);
+        report("multilevel", v.name, ml, base_ml);
+    }
+    return 0;
+}
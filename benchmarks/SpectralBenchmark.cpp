@@ -0,0 +1,109 @@
+// Spectral against internal-degree seeding of the KL-style bisection: cut of the initial split,
+// swap passes until no swap improves, final cut and time, on a grid with shuffled ids, a random
+// graph and a path of cliques. Then the multilevel solver with both seeds for the coarsest-level
+// partition, reporting the swap passes it ran and the final cut.
+//
+//   SpectralBenchmark [bisection_side] [multilevel_side] [k] [threads]
+#include "../MinimumBisectionSolver.h"
+#include "../MultilevelKWayPartitionSolver.h"
+#include "BenchUtils.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// `count` cliques of `size` vertices in a row, neighbors joined by one light edge; a degree
+// order splits it arbitrarily, a spectral order along the row.
+WeightedGraph clique_path(int count, int size)
+{
+    WeightedGraph g(count * size);
+    for (int c = 0; c < count; ++c) {
+        for (int a = 0; a < size; ++a)
+            for (int b = a + 1; b < size; ++b)
+                g.add_undirected(c * size + a, c * size + b, 2);
+        if (c + 1 < count)
+            g.add_undirected(c * size + size - 1, (c + 1) * size, 1);
+    }
+    return g;
+}
+
+const char *seed_name(InitialBisection initial)
+{
+    return initial == InitialBisection::Spectral ? "spectral" : "degree";
+}
+
+void bisect(const char *name, const WeightedGraph &g, int threads)
+{
+    std::printf("%s: n=%d bisection\n", name, g.n);
+    std::vector<int> all(g.n);
+    std::iota(all.begin(), all.end(), 0);
+    SpectralOptions spectral;
+    spectral.threads = threads;
+    for (auto initial : {InitialBisection::DegreeOrder, InitialBisection::Spectral}) {
+        auto start = std::chrono::steady_clock::now();
+        auto seed = BasicMinimumBisectionSolver<WeightedGraph>::bisection_on_subset(
+            g, all, 0, nullptr, initial, spectral);
+        double seed_time = bench::seconds_since(start);
+
+        int passes = 0;
+        SolveControl control;
+        control.set_progress([&](const SolveProgress &) { passes++; });
+        start = std::chrono::steady_clock::now();
+        auto part = BasicMinimumBisectionSolver<WeightedGraph>::bisection_on_subset(
+            g, all, 100000, &control, initial, spectral);
+        std::printf("  %-9s seed %.3f s cut %-6lld  %5d passes  %7.3f s  final cut %lld\n",
+                    seed_name(initial),
+                    seed_time,
+                    cut_weight_undirected(g, seed),
+                    passes,
+                    bench::seconds_since(start),
+                    cut_weight_undirected(g, part));
+    }
+}
+
+void multilevel(const char *name, const WeightedGraph &g, int k, int threads)
+{
+    std::printf("%s: n=%d multilevel k=%d\n", name, g.n, k);
+    SpectralOptions spectral;
+    spectral.threads = threads;
+    for (auto initial : {InitialBisection::DegreeOrder, InitialBisection::Spectral}) {
+        int passes = 0;
+        SolveControl control;
+        control.set_progress([&](const SolveProgress &p) {
+            if (std::string(p.stage) == "swap pass")
+                passes++;
+        });
+        MultilevelKWayPartitionSolver ml(k);
+        ml.set_initial_bisection(initial, spectral);
+        ml.set_control(&control);
+        double t = bench::best_of(1, [&] { ml.solve(g); });
+        std::printf("  %-9s %5d swap passes  %7.3f s  cut %lld\n",
+                    seed_name(initial),
+                    passes,
+                    t,
+                    ml.result().cut_weight);
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int side = argc > 1 ? std::atoi(argv[1]) : 30;
+    int ml_side = argc > 2 ? std::atoi(argv[2]) : 300;
+    int k = argc > 3 ? std::atoi(argv[3]) : 16;
+    int threads = argc > 4 ? std::atoi(argv[4]) : 0;
+
+    bisect("shuffled grid",
+           bench::shuffle_ids(bench::grid_graph<WeightedGraph>(side, side)),
+           threads);
+    bisect("random", bench::random_graph<WeightedGraph>(side * side, 3LL * side * side), threads);
+    bisect("clique path", clique_path(side, side), threads);
+
+    multilevel("grid", bench::grid_graph<WeightedGraph>(ml_side, ml_side, 4), k, threads);
+    multilevel("random",
+               bench::random_graph<WeightedGraph>(ml_side * ml_side, 4LL * ml_side * ml_side, 3),
+               k,
+               threads);
+    return 0;
+}
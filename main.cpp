@@ -1,8 +1,15 @@
+#include "DistributedMultilevelSolver.h"
 #include "GlobalMinCutSolver.h"
+#include "HypergraphPartitionSolver.h"
 #include "KWayPartitionSolver.h"
 #include "MinimumBisectionSolver.h"
 #include "MultilevelKWayPartitionSolver.h"
+#include "MultiwayCutSolver.h"
+#include "NestedDissectionSolver.h"
+#include "PartitionMetrics.h"
+#include "ProcessMapping.h"
 #include "STMinCutSolver.h"
+#include "VertexReordering.h"
 #include "VertexSeparatorSolver.h"
 
 int main()
@@ -30,11 +37,16 @@ int main()
     MultilevelKWayPartitionSolver kwaymulti(3);
     kwaymulti.solve(g);
     kwaymulti.print(std::cout);
+    compute_partition_metrics(g, kwaymulti.result().part).print(std::cout);
 
     VertexSeparatorSolver sep;
     sep.solve(g);
     sep.print(std::cout);
 
+    NestedDissectionSolver nd(2);
+    nd.solve(g);
+    nd.print(std::cout);
+
     GlobalMinCutSolver gmin;
     gmin.solve(g);
     gmin.print(std::cout);
@@ -43,5 +55,40 @@ int main()
     st.solve(g);
     st.print(std::cout);
 
+    MultiwayCutSolver mw({{0}, {2}, {6}});
+    mw.solve(g);
+    mw.print(std::cout);
+
+    MultilevelKWayPartitionSolver pinned(2, 8, 4, 10, {0, -1, -1, -1, -1, -1, 1, -1});
+    pinned.solve(g);
+    pinned.print(std::cout);
+
+    CommunicationVolumeSolver volume(2);
+    volume.solve(g);
+    volume.print(std::cout);
+
+    ProcessMappingSolver mapped(MachineTopology({2, 2}, {1, 10}));
+    mapped.solve(g);
+    mapped.print(std::cout);
+
+    DistributedMultilevelSolver dist(2, 2, TransportBackend::UnixSocket);
+    dist.solve(g);
+    dist.print(std::cout);
+
+    ReorderedSolver rcm(std::make_unique<MultilevelKWayPartitionSolver>(3),
+                        ReorderStrategy::ReverseCuthillMcKee);
+    rcm.solve(g);
+    rcm.print(std::cout);
+
+    UnweightedGraph ug(8);
+    for (int u = 0; u < g.n; ++u)
+        for (auto &e : g.adj[u])
+            if (u < e.to)
+                ug.add_undirected(u, e.to);
+
+    BasicMultilevelKWayPartitionSolver<UnweightedGraph> ukway(2);
+    ukway.solve(ug);
+    ukway.print(std::cout);
+
     return 0;
 }
@@ -0,0 +1,178 @@
+// Graph and partition file formats (GraphIO.h): METIS and edge-list parsing, round trips
+// through every writer, format detection and the errors reported for malformed input.
+#include "../GraphFile.h"
+#include "../GraphIO.h"
+#include "TestUtils.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// Adjacency rows as sorted (neighbor, weight) lists, so graphs compare independently of the
+// order their edges were added in.
+std::vector<std::vector<std::pair<int, Weight>>> rows(const WeightedGraph &g)
+{
+    std::vector<std::vector<std::pair<int, Weight>>> out(g.n);
+    for (int u = 0; u < g.n; ++u) {
+        for (auto &e : g.adj[u])
+            out[u].push_back({e.to, e.w});
+        std::sort(out[u].begin(), out[u].end());
+    }
+    return out;
+}
+
+GraphInput metis(const std::string &text)
+{
+    std::istringstream in(text);
+    return read_metis_graph(in);
+}
+
+void test_metis()
+{
+    auto in = metis("% comment\n"
+                    "4 2 1\n"
+                    "2 5\n"
+                    "1 5 3 2\n"
+                    "2 2\n"
+                    "\n");
+    CHECK(in.graph.n == 4);
+    CHECK(in.vertex_weights.empty());
+    auto r = rows(in.graph);
+    CHECK((r[0] == std::vector<std::pair<int, Weight>>{{1, 5}}));
+    CHECK((r[1] == std::vector<std::pair<int, Weight>>{{0, 5}, {2, 2}}));
+    CHECK(r[3].empty());
+
+    // Vertex weights, a vertex size column and unit edge weights.
+    auto weighted = metis("3 2 110\n"
+                          "1 7 2\n"
+                          "1 3 1 3\n"
+                          "1 4 2\n");
+    CHECK((weighted.vertex_weights == std::vector<Weight>{7, 3, 4}));
+    CHECK(rows(weighted.graph)[1].size() == 2);
+    CHECK(rows(weighted.graph)[1][0].second == 1);
+
+    // Several balance constraints: the first one is kept.
+    auto multi = metis("2 1 10 2\n"
+                       "5 6 2\n"
+                       "8 9 1\n");
+    CHECK((multi.vertex_weights == std::vector<Weight>{5, 8}));
+
+    CHECK_THROWS(metis(""), std::runtime_error);
+    CHECK_THROWS(metis("2 1\n2\n"), std::runtime_error);        // missing vertex line
+    CHECK_THROWS(metis("2 1\n3\n1\n"), std::runtime_error);     // neighbor out of range
+    CHECK_THROWS(metis("2 2\n2\n1\n"), std::runtime_error);     // edge count mismatch
+    CHECK_THROWS(metis("2 1 1\n2\n1 1\n"), std::runtime_error); // missing edge weight
+    CHECK_THROWS(metis("2 1 1\n2 -1\n1 -1\n"), std::runtime_error);
+    CHECK_THROWS(metis("2 1 2\n2\n1\n"), std::runtime_error); // unsupported fmt
+    CHECK_THROWS(metis("2 x\n"), std::runtime_error);
+
+    // Asymmetric rows: a missing reverse entry, a reverse entry with another weight, and a
+    // neighbor listed twice on one side only. The error names the offending row's line.
+    CHECK_THROWS(metis("3 1\n2\n\n2\n"), std::runtime_error);
+    CHECK_THROWS(metis("2 1 1\n2 3\n1 4\n"), std::runtime_error);
+    CHECK_THROWS(metis("2 1\n2 2\n1\n"), std::runtime_error);
+    std::string message;
+    try {
+        std::istringstream in("% comment\n"
+                              "3 2 1\n"
+                              "2 1\n"
+                              "1 1 3 5\n"
+                              "2 6\n");
+        read_metis_graph(in, "asym.graph");
+    } catch (const std::runtime_error &e) {
+        message = e.what();
+    }
+    CHECK(message.rfind("asym.graph:4: vertex 2 lists neighbor 3 with weight 5", 0) == 0);
+}
+
+void test_edge_list()
+{
+    std::istringstream in("# comment\n"
+                          "0 1\n"
+                          "1 2 4\n"
+                          "3 3 9\n"
+                          "\n"
+                          "% another comment\n"
+                          "2 0 2\n");
+    WeightedGraph g = read_edge_list(in);
+    CHECK(g.n == 4);
+    auto r = rows(g);
+    CHECK((r[0] == std::vector<std::pair<int, Weight>>{{1, 1}, {2, 2}}));
+    CHECK((r[2] == std::vector<std::pair<int, Weight>>{{0, 2}, {1, 4}}));
+    CHECK(r[3].empty()); // the self loop is dropped
+
+    std::istringstream bad("0 1 2 3\n");
+    CHECK_THROWS(read_edge_list(bad), std::runtime_error);
+    std::istringstream negative("0 -1\n");
+    CHECK_THROWS(read_edge_list(negative), std::runtime_error);
+}
+
+void test_round_trips()
+{
+    WeightedGraph g(5);
+    g.add_undirected(0, 1, 3);
+    g.add_undirected(1, 2, 1);
+    g.add_undirected(2, 3, 7);
+    g.add_undirected(3, 0, 2);
+    std::vector<Weight> vw{1, 2, 3, 4, 5};
+
+    std::stringstream text;
+    write_metis_graph(text, g, vw);
+    auto back = read_metis_graph(text);
+    CHECK(rows(back.graph) == rows(g));
+    CHECK(back.vertex_weights == vw);
+
+    const std::string metis_path = "graph_io_test.graph";
+    const std::string binary_path = "graph_io_test.bin";
+    const std::string edges_path = "graph_io_test.txt";
+    const std::string part_path = "graph_io_test.part";
+    {
+        std::ofstream out(metis_path);
+        write_metis_graph(out, g);
+    }
+    write_graph_file(g, binary_path);
+    {
+        std::ofstream out(edges_path);
+        out << "0 1 3\n1 2 1\n2 3 7\n3 0 2\n4 4\n";
+    }
+    CHECK(detect_graph_format(metis_path) == GraphFormat::Metis);
+    CHECK(detect_graph_format(binary_path) == GraphFormat::Binary);
+    CHECK(detect_graph_format(edges_path) == GraphFormat::EdgeList);
+    for (const auto &path : {metis_path, binary_path, edges_path}) {
+        auto in = read_graph(path);
+        CHECK(in.graph.n == g.n);
+        CHECK(rows(in.graph) == rows(g));
+    }
+    // An explicit format overrides the extension.
+    CHECK(read_graph(edges_path, GraphFormat::EdgeList).format == GraphFormat::EdgeList);
+    CHECK_THROWS(read_graph(edges_path, GraphFormat::Metis), std::runtime_error);
+    CHECK_THROWS(read_graph("graph_io_test.missing"), std::runtime_error);
+
+    std::vector<int> part{0, 1, 1, 0, 2};
+    write_partition(part_path, part);
+    CHECK(read_partition(part_path) == part);
+
+    for (const auto &path : {metis_path, binary_path, edges_path, part_path})
+        std::remove(path.c_str());
+}
+
+void test_format_names()
+{
+    for (auto f : {GraphFormat::Auto, GraphFormat::Metis, GraphFormat::EdgeList,
+                   GraphFormat::Binary})
+        CHECK(parse_graph_format(graph_format_name(f)) == f);
+    CHECK_THROWS(parse_graph_format("csv"), std::invalid_argument);
+}
+
+} // namespace
+
+int main()
+{
+    test_metis();
+    test_edge_list();
+    test_round_trips();
+    test_format_names();
+    return test::finish("GraphIOTests");
+}
@@ -0,0 +1,1372 @@
+// Solver contracts on small graphs with known structure: every solver returns a labeling of
+// the right size whose reported cut matches the graph, and each feature is checked against an
+// independent recomputation or a known optimum.
+#include "../CompressedGraph.h"
+#include "../DistributedMultilevelSolver.h"
+#include "../EvolutionarySolver.h"
+#include "../ExternalMultilevelSolver.h"
+#include "../FlowRefinement.h"
+#include "../GlobalMinCutSolver.h"
+#include "../GraphFile.h"
+#include "../HypergraphPartitionSolver.h"
+#include "../KWayPartitionSolver.h"
+#include "../MaxFlow.h"
+#include "../MinimumBisectionSolver.h"
+#include "../MultilevelKWayPartitionSolver.h"
+#include "../MultiwayCutSolver.h"
+#include "../NestedDissectionSolver.h"
+#include "../PartitionCache.h"
+#include "../PartitionMetrics.h"
+#include "../ProcessMapping.h"
+#include "../STMinCutSolver.h"
+#include "../SpectralBisection.h"
+#include "../Transport.h"
+#include "../VertexReordering.h"
+#include "../VertexSeparatorSolver.h"
+#include "TestUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+// `count` cliques of `size` vertices (edge weight 5), clique c joined to clique c + 1 by one
+// edge of weight 1 (and the last to the first when `ring`).
+WeightedGraph clique_chain(int count, int size, bool ring = false)
+{
+    WeightedGraph g(count * size);
+    for (int c = 0; c < count; ++c) {
+        for (int a = 0; a < size; ++a)
+            for (int b = a + 1; b < size; ++b)
+                g.add_undirected(c * size + a, c * size + b, 5);
+        if (c + 1 < count || (ring && count > 2))
+            g.add_undirected(c * size, ((c + 1) % count) * size + 1, 1);
+    }
+    return g;
+}
+
+WeightedGraph grid(int rows, int cols)
+{
+    WeightedGraph g(rows * cols);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c) {
+            if (c + 1 < cols)
+                g.add_undirected(r * cols + c, r * cols + c + 1, 1);
+            if (r + 1 < rows)
+                g.add_undirected(r * cols + c, (r + 1) * cols + c, 1);
+        }
+    return g;
+}
+
+bool labels_in_range(const std::vector<int> &part, int n, int k)
+{
+    if ((int) part.size() != n)
+        return false;
+    for (int p : part)
+        if (p < 0 || p >= k)
+            return false;
+    return true;
+}
+
+std::vector<int> block_sizes(const std::vector<int> &part, int k)
+{
+    std::vector<int> sizes(k, 0);
+    for (int p : part)
+        sizes[p]++;
+    return sizes;
+}
+
+bool balanced(const std::vector<int> &part, int k)
+{
+    auto sizes = block_sizes(part, k);
+    int n = (int) part.size();
+    for (int s : sizes)
+        if (s < n / k || s > (n + k - 1) / k)
+            return false;
+    return true;
+}
+
+// g with the same rows stored in another graph type.
+template<typename Graph>
+Graph convert(const WeightedGraph &g)
+{
+    Graph out(g.n);
+    for (int u = 0; u < g.n; ++u)
+        for (auto &e : g.adj[u])
+            if (u < e.to)
+                out.add_undirected(u, e.to, e.w);
+    return out;
+}
+
+void test_partitioners()
+{
+    WeightedGraph g = clique_chain(4, 6);
+    std::vector<std::unique_ptr<IGraphPartitionSolver>> solvers;
+    solvers.push_back(std::make_unique<KWayPartitionSolver>(4));
+    solvers.push_back(std::make_unique<MultilevelKWayPartitionSolver>(4));
+    solvers.push_back(std::make_unique<DistributedMultilevelSolver>(4, 2));
+    solvers.push_back(std::make_unique<CommunicationVolumeSolver>(4));
+    EvolutionOptions evo;
+    evo.population = 4;
+    evo.threads = 2;
+    evo.time_budget = std::chrono::milliseconds(100);
+    solvers.push_back(std::make_unique<EvolutionarySolver>(4, evo));
+    for (auto &s : solvers) {
+        s->solve(g);
+        auto r = s->result();
+        CHECK(labels_in_range(r.part, g.n, 4));
+        CHECK(r.cut_weight == cut_weight_undirected(g, r.part));
+        CHECK(balanced(r.part, 4));
+        // One block per clique is the only balanced partition without a heavy cut edge.
+        CHECK(r.cut_weight == 3);
+    }
+
+    MinimumBisectionSolver bisection;
+    bisection.solve(g);
+    CHECK(labels_in_range(bisection.result().part, g.n, 2));
+    CHECK(bisection.result().cut_weight == 1);
+}
+
+// Solves g as graph type Graph and returns the result.
+template<typename Graph, template<typename> class Solver, typename... Args>
+PartitionResult solve_as(const WeightedGraph &g, Args... args)
+{
+    Solver<Graph> solver(args...);
+    solver.solve(convert<Graph>(g));
+    return solver.result();
+}
+
+template<template<typename> class Solver, typename... Args>
+void check_same_on_all_types(const WeightedGraph &g, Args... args)
+{
+    auto wide = solve_as<WeightedGraph, Solver>(g, args...);
+    auto compact = solve_as<CompactWeightedGraph, Solver>(g, args...);
+    auto unweighted = solve_as<UnweightedGraph, Solver>(g, args...);
+    CHECK(wide.cut_weight == cut_weight_undirected(g, wide.part));
+    CHECK(compact.part == wide.part && compact.cut_weight == wide.cut_weight);
+    CHECK(unweighted.part == wide.part && unweighted.cut_weight == wide.cut_weight);
+}
+
+void test_graph_types()
+{
+    // A unit-weight graph is solved identically whatever its edges store.
+    std::mt19937 rng(2);
+    WeightedGraph g = grid(16, 16);
+    for (int i = 0; i < 40; ++i) {
+        int u = (int) (rng() % g.n), v = (int) (rng() % g.n);
+        if (u != v)
+            g.add_undirected(u, v, 1);
+    }
+    check_same_on_all_types<BasicKWayPartitionSolver>(g, 4);
+    check_same_on_all_types<BasicMultilevelKWayPartitionSolver>(g, 4);
+    check_same_on_all_types<BasicMinimumBisectionSolver>(g);
+    check_same_on_all_types<BasicGlobalMinCutSolver>(g);
+
+    CHECK(sizeof(CompactWeightedGraph::Edge) == 8);
+    CHECK(sizeof(UnweightedGraph::Edge) == 4);
+    CompactWeightedGraph compact(2);
+    compact.add_undirected(0, 1, std::numeric_limits<int>::max());
+    CHECK_THROWS(compact.add_undirected(0, 1, Weight(std::numeric_limits<int>::max()) + 1),
+                 std::invalid_argument);
+    UnweightedGraph unweighted(2);
+    unweighted.add_undirected(0, 1);
+    CHECK_THROWS(unweighted.add_undirected(0, 1, 2), std::invalid_argument);
+    CHECK(cut_weight_undirected(unweighted, {0, 1}) == 1);
+}
+
+// Rows of every length from 0 to 70 with random neighbors among n vertices, so that each
+// remainder of the 4-, 8- and 16-lane loops is covered.
+template<typename Graph>
+Graph random_rows(int n, Weight max_weight, std::mt19937 &rng)
+{
+    Graph g(n);
+    for (int u = 0; u <= 70 && u < n; ++u)
+        for (int i = 0; i < u; ++i) {
+            int v = (int) (rng() % n);
+            if constexpr (Graph::is_weighted)
+                g.adj[u].push_back({v, (typename Graph::weight_type) (1 + rng() % max_weight)});
+            else
+                g.adj[u].push_back({v});
+        }
+    return g;
+}
+
+// Every instruction set the CPU supports gives the results of plain loops.
+template<typename Graph>
+void check_kernels(Weight max_weight)
+{
+    std::mt19937 rng(9);
+    int n = 160, k = 4;
+    Graph g = random_rows<Graph>(n, max_weight, rng);
+    // Labels include -1, which row_block_weights skips.
+    std::vector<int> part(n), subset, in(n, 0);
+    for (int v = 0; v < n; ++v) {
+        part[v] = (int) (rng() % (k + 1)) - 1;
+        if (rng() % 3 != 0) {
+            subset.push_back(v);
+            in[v] = 1;
+        }
+    }
+
+    Weight cut = 0;
+    std::vector<Weight> degrees(n, 0), internal(n, 0);
+    std::vector<std::vector<Weight>> blocks(n, std::vector<Weight>(k, 0));
+    for (int u = 0; u < n; ++u)
+        for (auto &e : g.adj[u]) {
+            Weight w = e.w;
+            degrees[u] += w;
+            if (e.to > u && part[e.to] != part[u])
+                cut += w;
+            if (in[e.to])
+                internal[u] += w;
+            if (part[e.to] >= 0)
+                blocks[u][part[e.to]] += w;
+        }
+    std::vector<int> order(subset);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return internal[a] > internal[b];
+    });
+
+    kernels::Isa previous = kernels::active_isa();
+    for (auto isa : {kernels::Isa::Scalar, kernels::Isa::Avx2, kernels::Isa::Avx512}) {
+        if ((int) isa > (int) kernels::detected_isa())
+            continue;
+        kernels::set_isa(isa);
+        CHECK(cut_weight_undirected(g, part) == cut);
+        CHECK(g.degrees() == degrees);
+        CHECK(order_by_internal_degree(g, subset) == order);
+        bool rows_match = true;
+        for (int u = 0; u < n; ++u) {
+            const auto *row = g.adj[u].data();
+            std::size_t cnt = g.adj[u].size();
+            std::vector<Weight> acc(k, 0);
+            kernels::row_block_weights(row, cnt, part.data(), k, acc.data());
+            rows_match &= acc == blocks[u];
+            rows_match &= kernels::row_label_weight(row, cnt, in.data(), 1) == internal[u];
+            block_connectivity(g, part, k, u, acc);
+            rows_match &= acc == blocks[u];
+        }
+        CHECK(rows_match);
+    }
+    kernels::set_isa(previous);
+}
+
+void test_kernels()
+{
+    // Weights beyond 32 bits, and 32-bit weights whose row sums overflow int.
+    check_kernels<WeightedGraph>(Weight(1) << 40);
+    check_kernels<CompactWeightedGraph>(std::numeric_limits<int>::max());
+    check_kernels<UnweightedGraph>(1);
+}
+
+void test_metrics()
+{
+    std::mt19937 rng(3);
+    int n = 300, k = 5;
+    WeightedGraph g(n);
+    for (int i = 0; i < 900; ++i) {
+        int u = (int) (rng() % n), v = (int) (rng() % n);
+        if (u != v)
+            g.add_undirected(u, v, 1 + (Weight) (rng() % 5));
+    }
+    std::vector<int> part(n);
+    for (int v = 0; v < n; ++v)
+        part[v] = (int) (rng() % k);
+
+    // Every field recomputed directly from its definition.
+    Weight cut = 0;
+    long long cut_edges = 0, boundary = 0, volume = 0;
+    std::vector<long long> sizes(k, 0), block_volume(k, 0);
+    std::vector<std::vector<bool>> adjacent(k, std::vector<bool>(k, false));
+    for (int u = 0; u < n; ++u) {
+        sizes[part[u]]++;
+        std::vector<bool> seen(k, false);
+        for (auto &e : g.adj[u]) {
+            int q = part[e.to];
+            if (q == part[u])
+                continue;
+            if (u < e.to) {
+                cut += e.w;
+                cut_edges++;
+            }
+            adjacent[part[u]][q] = true;
+            if (!seen[q]) {
+                seen[q] = true;
+                volume++;
+                block_volume[part[u]]++;
+            }
+        }
+        boundary += std::count(seen.begin(), seen.end(), true) > 0;
+    }
+    long long quotient_edges = 0;
+    int max_degree = 0;
+    for (int a = 0; a < k; ++a) {
+        int degree = (int) std::count(adjacent[a].begin(), adjacent[a].end(), true);
+        max_degree = std::max(max_degree, degree);
+        quotient_edges += degree;
+    }
+    long long largest = *std::max_element(sizes.begin(), sizes.end());
+
+    for (int threads : {1, 4}) {
+        auto m = compute_partition_metrics(g, part, 0, threads);
+        CHECK(m.k == k);
+        CHECK(m.cut_weight == cut && m.cut_edges == cut_edges);
+        CHECK(m.block_sizes == sizes);
+        CHECK(m.imbalance == (double) largest / ((n + k - 1) / k) - 1);
+        CHECK(m.boundary_vertices == boundary);
+        CHECK(m.communication_volume == volume);
+        CHECK(m.block_communication_volume == block_volume);
+        CHECK(m.max_communication_volume
+              == *std::max_element(block_volume.begin(), block_volume.end()));
+        CHECK(m.quotient_edges == quotient_edges / 2);
+        CHECK(m.max_quotient_degree == max_degree);
+    }
+    CHECK_THROWS(compute_partition_metrics(g, std::vector<int>(n - 1, 0)), std::invalid_argument);
+    CHECK_THROWS(compute_partition_metrics(g, part, k - 1), std::invalid_argument);
+
+    // Vertex weights weigh the block sizes and the imbalance; the other fields stay.
+    std::vector<Weight> weights(n);
+    std::vector<long long> weighted(k, 0);
+    Weight total = 0;
+    for (int v = 0; v < n; ++v) {
+        weights[v] = 1 + (Weight) (rng() % 9);
+        weighted[part[v]] += weights[v];
+        total += weights[v];
+    }
+    auto m = compute_partition_metrics(g, part, k, 2, weights);
+    CHECK(m.block_sizes == weighted);
+    CHECK(m.imbalance
+          == (double) *std::max_element(weighted.begin(), weighted.end()) / ((total + k - 1) / k)
+                 - 1);
+    CHECK(m.cut_weight == cut && m.communication_volume == volume);
+    CHECK_THROWS(compute_partition_metrics(g, part, k, 1, std::vector<Weight>(n - 1, 1)),
+                 std::invalid_argument);
+
+    // The solvers' print() helpers.
+    CHECK(partition_block_sizes(part) == sizes);
+    CHECK(partition_block_sizes(part, k, weights) == weighted);
+    CHECK_THROWS(partition_block_sizes(part, k - 1), std::invalid_argument);
+    std::ostringstream out;
+    print_block_sizes(out, {3, 0, 12});
+    CHECK(out.str() == "sizes=[3,0,12]");
+}
+
+// Largest |rank[u] - rank[v]| over the edges after relabeling by order.
+int bandwidth(const WeightedGraph &g, const std::vector<int> &order)
+{
+    auto rank = inverse_permutation(order);
+    int width = 0;
+    for (int u = 0; u < g.n; ++u)
+        for (auto &e : g.adj[u])
+            width = std::max(width, std::abs(rank[u] - rank[e.to]));
+    return width;
+}
+
+void test_reordering()
+{
+    // A path with shuffled ids: RCM recovers bandwidth 1.
+    int n = 200;
+    std::vector<int> ids(n);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(5));
+    WeightedGraph path(n);
+    for (int i = 0; i + 1 < n; ++i)
+        path.add_undirected(ids[i], ids[i + 1], 1);
+    CHECK(bandwidth(path, reverse_cuthill_mckee_order(path)) == 1);
+
+    WeightedGraph g = grid(20, 20);
+    auto rcm = reverse_cuthill_mckee_order(g);
+    CHECK(bandwidth(g, rcm) <= 21);
+    auto degree = degree_descending_order(g);
+    CHECK(g.adj[degree.front()].size() == 4 && g.adj[degree.back()].size() == 2);
+    CHECK_THROWS(inverse_permutation({0, 0, 1}), std::invalid_argument);
+
+    // Results are mapped back to the original ids.
+    for (auto strategy : {ReorderStrategy::ReverseCuthillMcKee,
+                          ReorderStrategy::DegreeDescending,
+                          ReorderStrategy::PartitionBlocks}) {
+        ReorderedSolver reordered(std::make_unique<MultilevelKWayPartitionSolver>(4), strategy, 8);
+        reordered.solve(g);
+        auto r = reordered.result();
+        CHECK(labels_in_range(r.part, g.n, 4));
+        CHECK(r.cut_weight == cut_weight_undirected(g, r.part));
+        auto sorted = reordered.order();
+        std::sort(sorted.begin(), sorted.end());
+        std::vector<int> identity(g.n);
+        std::iota(identity.begin(), identity.end(), 0);
+        CHECK(sorted == identity);
+    }
+
+    // The partition-blocks stage runs under the same control as the inner solver.
+    std::vector<std::string> stages;
+    SolveControl control;
+    control.set_progress([&](const SolveProgress &p) { stages.push_back(p.stage); });
+    ReorderedSolver blocks(
+        std::make_unique<GlobalMinCutSolver>(), ReorderStrategy::PartitionBlocks, 8);
+    blocks.set_control(&control);
+    blocks.solve(g);
+    CHECK(std::count(stages.begin(), stages.end(), "coarsen level") > 0);
+    CancellationToken token;
+    token.cancel();
+    SolveControl cancelled;
+    cancelled.set_cancellation(token);
+    blocks.set_control(&cancelled);
+    blocks.solve(g);
+    CHECK(blocks.result().stopped_early);
+    // An inner solver that ignores the control does not hide a stopped block stage.
+    ReorderedSolver exact(
+        std::make_unique<STMinCutSolver>(0, g.n - 1), ReorderStrategy::PartitionBlocks, 8);
+    exact.set_control(&cancelled);
+    exact.solve(g);
+    CHECK(exact.result().stopped_early);
+    CHECK(exact.result().cut_weight == cut_weight_undirected(g, exact.result().part));
+}
+
+void test_separators()
+{
+    WeightedGraph g = grid(12, 12);
+    VertexSeparatorSolver sep;
+    sep.solve(g);
+    auto r = sep.result();
+    CHECK(!r.separator.empty());
+    // Removing the separator leaves no edge between the two sides.
+    std::vector<bool> removed(g.n, false);
+    for (int v : r.separator)
+        removed[v] = true;
+    bool separated = true;
+    for (int u = 0; u < g.n; ++u)
+        for (auto &e : g.adj[u])
+            if (!removed[u] && !removed[e.to] && r.part[u] != r.part[e.to])
+                separated = false;
+    CHECK(separated);
+
+    NestedDissectionSolver nd(16);
+    nd.solve(g);
+    auto perm = nd.permutation();
+    std::sort(perm.begin(), perm.end());
+    std::vector<int> identity(g.n);
+    std::iota(identity.begin(), identity.end(), 0);
+    CHECK(perm == identity);
+
+    // Below every tree node, no edge joins the ranges of two different children.
+    const auto &tree = nd.separator_tree();
+    bool nested = true;
+    for (auto &node : tree) {
+        std::vector<int> child_of(g.n, -1);
+        for (int c : node.children)
+            for (int i = tree[c].begin; i < tree[c].end; ++i)
+                child_of[nd.permutation()[i]] = c;
+        for (int u = 0; u < g.n; ++u)
+            for (auto &e : g.adj[u])
+                if (child_of[u] != -1 && child_of[e.to] != -1 && child_of[u] != child_of[e.to])
+                    nested = false;
+    }
+    CHECK(nested);
+    CHECK(tree.front().begin == 0 && tree.front().end == g.n);
+}
+
+struct FlowArc
+{
+    int u, v;
+    Weight cap;
+    bool undirected;
+};
+
+std::vector<FlowArc> random_arcs(int n, int count, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<FlowArc> arcs;
+    for (int i = 0; i < count; ++i) {
+        int u = (int) (rng() % n), v = (int) (rng() % n);
+        Weight cap = 1 + (Weight) (rng() % 20);
+        if (u != v)
+            arcs.push_back({u, v, cap, i % 3 == 0});
+    }
+    return arcs;
+}
+
+MaxFlow network(int n, const std::vector<FlowArc> &arcs)
+{
+    MaxFlow f(n);
+    for (auto &a : arcs) {
+        if (a.undirected)
+            f.add_undirected_edge(a.u, a.v, a.cap);
+        else
+            f.add_edge(a.u, a.v, a.cap);
+    }
+    return f;
+}
+
+// Capacity of the arcs leaving the vertex set `side`.
+Weight cut_capacity(const std::vector<FlowArc> &arcs, const std::vector<char> &side)
+{
+    Weight cut = 0;
+    for (auto &a : arcs)
+        if ((side[a.u] && !side[a.v]) || (a.undirected && side[a.v] && !side[a.u]))
+            cut += a.cap;
+    return cut;
+}
+
+void test_max_flow()
+{
+    // Textbook network with maximum flow 23.
+    MaxFlow f(6);
+    f.add_edge(0, 1, 16);
+    f.add_edge(0, 2, 13);
+    f.add_edge(1, 2, 10);
+    f.add_edge(2, 1, 4);
+    f.add_edge(1, 3, 12);
+    f.add_edge(3, 2, 9);
+    f.add_edge(2, 4, 14);
+    f.add_edge(4, 3, 7);
+    f.add_edge(3, 5, 20);
+    f.add_edge(4, 5, 4);
+    CHECK(f.max_flow(0, 5) == 23);
+    auto side = f.source_side(0);
+    CHECK(side[0] && !side[5]);
+    CHECK_THROWS(f.max_flow(2, 2), std::invalid_argument);
+
+    // The source side of the residual network is a cut of the flow's capacity.
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        int n = 200;
+        auto arcs = random_arcs(n, 5 * n, seed);
+        MaxFlow random = network(n, arcs);
+        Weight flow = random.max_flow(0, n - 1);
+        auto source = random.source_side(0);
+        CHECK(!source[n - 1] && cut_capacity(arcs, source) == flow);
+    }
+
+    // Capacities beyond infinite_capacity are clamped, so an uncuttable path saturates once
+    // instead of being pushed again and again.
+    MaxFlow huge(3);
+    huge.add_edge(0, 1, std::numeric_limits<Weight>::max());
+    huge.add_undirected_edge(1, 2, std::numeric_limits<Weight>::max());
+    CHECK(huge.max_flow(0, 2) == MaxFlow::infinite_capacity);
+
+    // A path of 10^6 arcs: the descent is iterative, so depth does not grow the stack.
+    int n = 1000000;
+    MaxFlow chain(n);
+    for (int v = 0; v + 1 < n; ++v)
+        chain.add_edge(v, v + 1, 2 + v % 5);
+    CHECK(chain.max_flow(0, n - 1) == 2);
+}
+
+void test_parallel_max_flow()
+{
+    for (unsigned seed = 1; seed <= 6; ++seed) {
+        int n = 300 + 100 * (int) seed;
+        auto arcs = random_arcs(n, 6 * n, seed);
+        Weight dinic = network(n, arcs).max_flow(0, n - 1);
+        CHECK(dinic > 0);
+        for (int threads : {1, 2, 4}) {
+            MaxFlow f = network(n, arcs);
+            CHECK(f.parallel_max_flow(0, n - 1, threads) == dinic);
+            // The residual network still yields minimum cuts on both sides.
+            auto source = f.source_side(0);
+            CHECK(!source[n - 1] && cut_capacity(arcs, source) == dinic);
+            auto sink = f.sink_side(n - 1);
+            for (auto &in : sink)
+                in = !in;
+            CHECK(sink[0] && cut_capacity(arcs, sink) == dinic);
+        }
+    }
+}
+
+void test_flow_refinement()
+{
+    // A balanced bisection of a 20x20 grid whose boundary zigzags between columns 8 and 12.
+    // Refinement must lower the cut and keep both sides within ceil(1.03 * n / 2).
+    WeightedGraph g = grid(20, 20);
+    std::vector<int> part(g.n);
+    for (int r = 0; r < 20; ++r)
+        for (int c = 0; c < 20; ++c)
+            part[r * 20 + c] = c < 10 + (r % 3 == 0 ? 2 : r % 3 == 1 ? -2 : 0) ? 0 : 1;
+    Weight before = cut_weight_undirected(g, part);
+    CHECK(flow_refine_bisection(g, part, 0.03));
+    Weight after = cut_weight_undirected(g, part);
+    CHECK(after < before);
+    auto sizes = block_sizes(part, 2);
+    CHECK(std::max(sizes[0], sizes[1]) <= 206);
+
+    VertexSeparatorSolver sep;
+    sep.solve(g);
+    auto side = sep.result().part;
+    auto separator = sep.result().separator;
+    std::size_t size = separator.size();
+    flow_refine_separator(g, side, separator, 0.03);
+    CHECK(separator.size() <= size);
+    std::vector<bool> removed(g.n, false);
+    for (int v : separator)
+        removed[v] = true;
+    bool separated = true;
+    for (int u = 0; u < g.n; ++u)
+        for (auto &e : g.adj[u])
+            if (!removed[u] && !removed[e.to] && side[u] != side[e.to])
+                separated = false;
+    CHECK(separated);
+}
+
+void test_exact_cuts()
+{
+    WeightedGraph g = clique_chain(3, 5, true);
+    GlobalMinCutSolver global;
+    global.solve(g);
+    CHECK(global.result().cut_weight == 2);
+    CHECK(cut_weight_undirected(g, global.result().part) == 2);
+
+    STMinCutSolver st(0, 7);
+    st.solve(g);
+    CHECK(st.result().cut_weight == 2);
+    CHECK(st.result().part[0] != st.result().part[7]);
+
+    MultiwayCutSolver multiway({{0}, {5}, {10}});
+    multiway.solve(g);
+    auto part = multiway.result().part;
+    CHECK(part[0] != part[5] && part[5] != part[10] && part[0] != part[10]);
+    CHECK(multiway.result().cut_weight == cut_weight_undirected(g, part));
+    CHECK(multiway.result().cut_weight == 3);
+    CHECK_THROWS(MultiwayCutSolver({{0}, {0, 5}}).solve(g), std::invalid_argument);
+}
+
+void test_fixed_vertices()
+{
+    // Pinned corners of a grid stay in their blocks.
+    WeightedGraph g = grid(30, 30);
+    std::vector<int> fixed(g.n, -1);
+    fixed[0] = 3;
+    fixed[29] = 2;
+    fixed[g.n - 30] = 1;
+    fixed[g.n - 1] = 0;
+    MultilevelKWayPartitionSolver pinned(4, 8, 4, 10, fixed);
+    pinned.solve(g);
+    auto r = pinned.result();
+    CHECK(r.part[0] == 3 && r.part[29] == 2 && r.part[g.n - 30] == 1 && r.part[g.n - 1] == 0);
+    CHECK(r.cut_weight == cut_weight_undirected(g, r.part));
+    CHECK(balanced(r.part, 4));
+
+    MultilevelKWayPartitionSolver short_fixed(4, 8, 4, 10, std::vector<int>(g.n - 1, -1));
+    CHECK_THROWS(short_fixed.solve(g), std::invalid_argument);
+    MultilevelKWayPartitionSolver bad_block(4, 8, 4, 10, std::vector<int>(g.n, 4));
+    CHECK_THROWS(bad_block.solve(g), std::invalid_argument);
+}
+
+void test_solve_control()
+{
+    // An expired deadline: every solver still returns a full, balanced labeling with a
+    // correct cut, and reports that it stopped early.
+    WeightedGraph g = grid(24, 24);
+    SolveControl expired;
+    expired.set_time_limit(std::chrono::nanoseconds(0));
+    std::vector<std::pair<std::unique_ptr<IGraphPartitionSolver>, int>> solvers;
+    solvers.emplace_back(std::make_unique<MinimumBisectionSolver>(), 2);
+    solvers.emplace_back(std::make_unique<KWayPartitionSolver>(4), 4);
+    solvers.emplace_back(std::make_unique<MultilevelKWayPartitionSolver>(4), 4);
+    for (auto &entry : solvers) {
+        auto &s = entry.first;
+        s->set_control(&expired);
+        s->solve(g);
+        auto r = s->result();
+        CHECK(labels_in_range(r.part, g.n, entry.second));
+        CHECK(balanced(r.part, entry.second));
+        CHECK(r.cut_weight == cut_weight_undirected(g, r.part));
+        CHECK(r.stopped_early);
+    }
+
+    // Cancellation from the progress callback stops the multilevel solver at the next level
+    // boundary; without a control it runs to completion.
+    CancellationToken token;
+    SolveControl control;
+    control.set_cancellation(token);
+    int reports = 0;
+    control.set_progress([&](const SolveProgress &) {
+        reports++;
+        token.cancel();
+    });
+    MultilevelKWayPartitionSolver ml(4);
+    ml.set_control(&control);
+    ml.solve(g);
+    CHECK(reports >= 1);
+    CHECK(ml.result().stopped_early);
+    CHECK(labels_in_range(ml.result().part, g.n, 4));
+    ml.set_control(nullptr);
+    ml.solve(g);
+    CHECK(!ml.result().stopped_early);
+}
+
+void test_partition_cache()
+{
+    WeightedGraph a = grid(10, 10), b = grid(10, 10);
+    a.add_undirected(0, 99, 3);
+    b.add_undirected(0, 99, 5);
+    CHECK(graph_fingerprint(a) != graph_fingerprint(b));
+
+    auto cache = std::make_shared<PartitionCache>(8);
+    auto cached = [&] {
+        return CachedSolver(std::make_unique<MultilevelKWayPartitionSolver>(2), cache, "k=2");
+    };
+    CachedSolver first = cached();
+    first.solve(a);
+    CHECK(!first.last_hit());
+    CachedSolver second = cached();
+    second.solve(b);
+    CHECK(!second.last_hit());
+    CHECK(second.result().cut_weight == cut_weight_undirected(b, second.result().part));
+    CachedSolver again = cached();
+    again.solve(a);
+    CHECK(again.last_hit());
+    CHECK(again.result().part == first.result().part);
+    CHECK(again.result().cut_weight == first.result().cut_weight);
+    CHECK(cache->hits() == 1 && cache->misses() == 2);
+    CHECK(cache->size() == 2);
+
+    // Weights that differ by 2^32 must not alias.
+    const Weight big = Weight(1) << 32;
+    WeightedGraph c = grid(10, 10);
+    c.add_undirected(0, 99, 3 + big);
+    CHECK(graph_fingerprint(a) != graph_fingerprint(c));
+    CachedSolver heavy = cached();
+    heavy.solve(c);
+    CHECK(!heavy.last_hit());
+    // The heavy edge never crosses the cut.
+    CHECK(heavy.result().part[0] == heavy.result().part[99]);
+
+    // The same grid stored with 64-bit and 32-bit weights fingerprints alike but gets its
+    // own entry.
+    WeightedGraph small = grid(6, 6);
+    CompactWeightedGraph compact = convert<CompactWeightedGraph>(small);
+    CHECK(graph_fingerprint(small) == graph_fingerprint(compact));
+    auto shared = std::make_shared<PartitionCache>(8);
+    CachedSolver wide(std::make_unique<MultilevelKWayPartitionSolver>(2), shared, "k=2");
+    wide.solve(small);
+    BasicCachedSolver<CompactWeightedGraph> narrow(
+        std::make_unique<BasicMultilevelKWayPartitionSolver<CompactWeightedGraph>>(2),
+        shared,
+        "k=2");
+    narrow.solve(compact);
+    CHECK(!narrow.last_hit());
+    CHECK(shared->size() == 2);
+
+    // Evicted entries are spilled and reloaded; stopped solves are not stored.
+    const std::string dir = "partition_cache_test";
+    {
+        auto spill = std::make_shared<PartitionCache>(1, dir);
+        CachedSolver s1(std::make_unique<MultilevelKWayPartitionSolver>(2), spill, "k=2");
+        s1.solve(a);
+        s1.solve(b);
+        s1.solve(a);
+        CHECK(s1.last_hit());
+        CHECK(spill->disk_hits() == 1);
+        CHECK(s1.result().part == first.result().part);
+
+        CancellationToken token;
+        token.cancel();
+        SolveControl control;
+        control.set_cancellation(token);
+        CachedSolver s2(std::make_unique<MultilevelKWayPartitionSolver>(4), spill, "k=4");
+        s2.set_control(&control);
+        s2.solve(a);
+        CHECK(s2.result().stopped_early);
+        s2.set_control(nullptr);
+        s2.solve(a);
+        CHECK(!s2.last_hit());
+        CHECK(!s2.result().stopped_early);
+    }
+    std::filesystem::remove_all(dir);
+}
+
+// Adjacency rows sorted by neighbor, as (neighbor, weight) pairs.
+template<typename Graph>
+std::vector<std::vector<std::pair<int, Weight>>> sorted_rows(const Graph &g)
+{
+    std::vector<std::vector<std::pair<int, Weight>>> rows(g.n);
+    for (int u = 0; u < g.n; ++u) {
+        for (auto &e : g.adj[u])
+            rows[u].push_back({e.to, (Weight) e.w});
+        std::sort(rows[u].begin(), rows[u].end());
+    }
+    return rows;
+}
+
+void test_compressed_graph()
+{
+    // Local and far neighbors (negative and multi-byte gaps), runs of equal weights and weights
+    // beyond 32 bits.
+    std::mt19937 rng(11);
+    int n = 2000;
+    WeightedGraph g(n);
+    for (int u = 0; u < n; ++u) {
+        if (u + 1 < n)
+            g.add_undirected(u, u + 1, 3);
+        int v = (int) (rng() % n);
+        if (v != u)
+            g.add_undirected(u, v, u % 7 == 0 ? (Weight(1) << 40) + u : 1 + (Weight) (rng() % 4));
+    }
+    g.adj[5].clear(); // rows may be empty (and the graph asymmetric) for the decoder
+    for (auto &row : g.adj)
+        std::reverse(row.begin(), row.end());
+
+    CompressedGraph c(g);
+    CHECK(c.n == n);
+    CHECK(sorted_rows(c) == sorted_rows(g));
+    CHECK(sorted_rows(c.decompress()) == sorted_rows(g));
+    CHECK(c.degrees() == g.degrees());
+    for (int u = 0; u < n; ++u)
+        CHECK(c.adj[u].size() == g.adj[u].size());
+    bool ascending = true;
+    for (int u = 0; u < n; ++u) {
+        int prev = -1;
+        for (auto &e : c.adj[u]) {
+            ascending &= e.to >= prev;
+            prev = e.to;
+        }
+    }
+    CHECK(ascending);
+
+    // Row-by-row construction gives the same graph.
+    CompressedGraph appended;
+    for (int u = 0; u < n; ++u) {
+        std::vector<CompressedGraph::Edge> row;
+        for (auto &e : g.adj[u])
+            row.push_back({e.to, e.w});
+        appended.append_row(std::move(row));
+    }
+    CHECK(sorted_rows(appended) == sorted_rows(g));
+
+    // Solvers read it like the plain graph with sorted rows.
+    std::vector<int> part(n);
+    for (int u = 0; u < n; ++u)
+        part[u] = (int) (rng() % 4);
+    CHECK(cut_weight_undirected(c, part) == cut_weight_undirected(g, part));
+    WeightedGraph plain = grid(40, 40);
+    CompressedGraph compressed(plain);
+    CHECK(compressed.memory_bytes() < adjacency_memory_bytes(plain));
+    MultilevelKWayPartitionSolver on_plain(4);
+    on_plain.solve(compressed.decompress());
+    BasicMultilevelKWayPartitionSolver<CompressedGraph> on_compressed(4);
+    on_compressed.solve(compressed);
+    CHECK(on_compressed.result().part == on_plain.result().part);
+}
+
+
+void test_vertex_weights()
+{
+    // Unit weights: every block holds floor(n/k) or ceil(n/k) vertices, although coarse
+    // vertices stand for many fine ones.
+    WeightedGraph g = grid(60, 60);
+    MultilevelKWayPartitionSolver unit(16);
+    unit.solve(g);
+    CHECK(balanced(unit.result().part, 16));
+
+    // Weighted vertices: no block exceeds ceil(W/k) plus the heaviest vertex weight minus one.
+    g = grid(30, 30);
+    std::vector<Weight> weights(g.n);
+    for (int v = 0; v < g.n; ++v)
+        weights[v] = 1 + v % 3;
+    MultilevelKWayPartitionSolver weighted(4, 8, 4, 10, {}, weights);
+    weighted.solve(g);
+    auto r = weighted.result();
+    CHECK(labels_in_range(r.part, g.n, 4));
+    CHECK(r.cut_weight == cut_weight_undirected(g, r.part));
+    std::vector<Weight> block(4, 0);
+    Weight total = 0;
+    for (int v = 0; v < g.n; ++v) {
+        block[r.part[v]] += weights[v];
+        total += weights[v];
+    }
+    for (Weight b : block)
+        CHECK(b <= (total + 3) / 4 + 2);
+    // print() reports the block weights.
+    std::ostringstream out, expected;
+    weighted.print(out);
+    print_block_sizes(expected, std::vector<long long>(block.begin(), block.end()));
+    CHECK(out.str().find(expected.str()) != std::string::npos);
+
+    MultilevelKWayPartitionSolver short_weights(4, 8, 4, 10, {}, std::vector<Weight>(g.n - 1, 1));
+    CHECK_THROWS(short_weights.solve(g), std::invalid_argument);
+}
+
+void test_external_memory()
+{
+    const std::string dir = "external_memory_test";
+    std::filesystem::create_directories(dir);
+    WeightedGraph g = grid(60, 60);
+    for (int u = 0; u < g.n; ++u)
+        for (auto &e : g.adj[u])
+            e.w = 1 + (std::min(u, e.to) % 3);
+    const std::string path = dir + "/grid.graph";
+    write_graph_file(g, path);
+    std::size_t edge_bytes = 0;
+    for (auto &row : g.adj)
+        edge_bytes += row.size() * sizeof(WeightedGraph::Edge);
+
+    for (std::size_t budget : {edge_bytes * 4, edge_bytes / 8}) {
+        ExternalMemoryConfig config;
+        config.work_dir = dir;
+        config.memory_budget = budget;
+        ExternalMultilevelSolver ext(8, config);
+        ext.solve_file(path);
+        auto r = ext.result();
+        CHECK(labels_in_range(r.part, g.n, 8));
+        CHECK(r.cut_weight == cut_weight_undirected(g, r.part));
+        CHECK(balanced(r.part, 8));
+        auto st = ext.stats();
+        CHECK((st.disk_levels > 0) == (budget < edge_bytes));
+        CHECK(st.bytes_read >= (long long) edge_bytes);
+        CHECK(st.peak_edge_bytes <= budget);
+        CHECK(st.coarsest_loaded);
+    }
+
+    // Coarsening that ends before a level fits (no disk levels allowed; stars with 40 leaves,
+    // on which matching stalls) must still keep the edges within the budget.
+    WeightedGraph stars(100 * 41);
+    for (int c = 0; c < stars.n; c += 41)
+        for (int leaf = c + 1; leaf < c + 41; ++leaf)
+            stars.add_undirected(c, leaf, 1);
+    const std::string stars_path = dir + "/stars.graph";
+    write_graph_file(stars, stars_path);
+    std::vector<std::pair<std::string, int>> runs{{path, 1}, {stars_path, 10}};
+    for (auto &run : runs) {
+        const WeightedGraph &input = run.first == path ? g : stars;
+        ExternalMemoryConfig config;
+        config.work_dir = dir;
+        config.memory_budget = edge_bytes / 8;
+        ExternalMultilevelSolver ext(8, config, 8, 4, run.second);
+        ext.solve_file(run.first);
+        auto r = ext.result();
+        CHECK(labels_in_range(r.part, input.n, 8));
+        CHECK(r.cut_weight == cut_weight_undirected(input, r.part));
+        CHECK(balanced(r.part, 8));
+        CHECK(!ext.stats().coarsest_loaded);
+        CHECK(ext.stats().peak_edge_bytes <= config.memory_budget);
+    }
+    std::filesystem::remove(stars_path);
+    // Only the input is left behind.
+    int files = 0;
+    for (auto &entry : std::filesystem::directory_iterator(dir)) {
+        (void) entry;
+        files++;
+    }
+    CHECK(files == 1);
+    CHECK(GraphFile(path).load().n == g.n);
+    std::filesystem::remove_all(dir);
+}
+
+
+void test_distributed()
+{
+    // Collectives over both in-process backends: rank r sends r * size + q to rank q.
+    for (auto make : {make_in_process_group, make_unix_socket_group}) {
+        const int size = 4;
+        auto group = make(size);
+        std::vector<int> ok(size, 0);
+        std::vector<std::thread> threads;
+        for (int r = 0; r < size; ++r)
+            threads.emplace_back([&, r] {
+                Transport &t = *group[r];
+                std::vector<std::vector<char>> out(size);
+                for (int q = 0; q < size; ++q)
+                    out[q] = to_bytes(std::vector<int>{r * size + q});
+                auto in = all_to_all(t, std::move(out));
+                bool good = true;
+                for (int q = 0; q < size; ++q)
+                    good &= from_bytes<int>(in[q]) == std::vector<int>{q * size + r};
+                auto sum = all_reduce_sum(t, {r, 1});
+                good &= sum == std::vector<long long>{size * (size - 1) / 2, size};
+                ok[r] = good;
+            });
+        for (auto &th : threads)
+            th.join();
+        CHECK(std::count(ok.begin(), ok.end(), 1) == size);
+    }
+
+    // Every rank count and backend returns a full labeling with a correct cut; the backends
+    // exchange the same messages, so they agree. Ranks refine in parallel, each with a share of
+    // the free space; blocks must still end within ceil(n/k).
+    WeightedGraph g = grid(60, 60);
+    for (int ranks : {2, 4, 8}) {
+        DistributedMultilevelSolver threads(16, ranks);
+        threads.solve(g);
+        auto r = threads.result();
+        CHECK(labels_in_range(r.part, g.n, 16));
+        CHECK(r.cut_weight == cut_weight_undirected(g, r.part));
+        DistributedMultilevelSolver sockets(16, ranks, TransportBackend::UnixSocket);
+        sockets.solve(g);
+        CHECK(sockets.result().part == r.part);
+        auto sizes = block_sizes(r.part, 16);
+        CHECK(*std::max_element(sizes.begin(), sizes.end()) <= (g.n + 15) / 16);
+    }
+
+    // A rank that throws mid-solve must release its peers, and solve() must rethrow its error
+    // rather than the peers' aborted receives.
+    for (auto backend : {TransportBackend::InProcess, TransportBackend::UnixSocket}) {
+        SolveControl control;
+        control.set_progress([](const SolveProgress &) { throw std::logic_error("rank 0 failed"); });
+        DistributedMultilevelSolver solver(4, 4, backend);
+        solver.set_control(&control);
+        CHECK_THROWS(solver.solve(g), std::logic_error);
+    }
+}
+
+
+void test_deterministic()
+{
+    // Deterministic mode gives the same partition for every thread count. Both parallel modes
+    // return a labeling with a correct cut and no block above ceil(n/k).
+    WeightedGraph g = grid(30, 30);
+    std::vector<int> first;
+    for (int threads : {1, 2, 4}) {
+        MultilevelKWayPartitionSolver ml(8);
+        ml.set_parallel({ParallelMode::Deterministic, threads, 7});
+        ml.solve(g);
+        auto r = ml.result();
+        if (first.empty())
+            first = r.part;
+        CHECK(r.part == first);
+        CHECK(labels_in_range(r.part, g.n, 8));
+        CHECK(r.cut_weight == cut_weight_undirected(g, r.part));
+        auto sizes = block_sizes(r.part, 8);
+        CHECK(*std::max_element(sizes.begin(), sizes.end()) <= (g.n + 7) / 8);
+    }
+    MultilevelKWayPartitionSolver fast(8);
+    fast.set_parallel({ParallelMode::Fast, 4, 7});
+    fast.solve(g);
+    auto r = fast.result();
+    CHECK(labels_in_range(r.part, g.n, 8));
+    CHECK(r.cut_weight == cut_weight_undirected(g, r.part));
+    auto sizes = block_sizes(r.part, 8);
+    CHECK(*std::max_element(sizes.begin(), sizes.end()) <= (g.n + 7) / 8);
+}
+
+void test_spectral()
+{
+    // The Fiedler vector of a path is monotone along it, so the spectral order is the path in
+    // one direction or the other.
+    WeightedGraph path = grid(1, 20);
+    std::vector<int> all(path.n);
+    std::iota(all.begin(), all.end(), 0);
+    SpectralOptions exact;
+    exact.tolerance = 1e-8;
+    exact.max_iterations = 2000;
+    auto order = spectral_order(path, all, exact);
+    std::vector<int> reversed(all.rbegin(), all.rend());
+    CHECK(order == all || order == reversed);
+
+    // Unit length, orthogonal to the constant vector, and the same for every thread count.
+    WeightedGraph g = grid(30, 30);
+    all.resize(g.n);
+    std::iota(all.begin(), all.end(), 0);
+    SpectralOptions options;
+    auto f = fiedler_vector(g, all, options);
+    double norm = 0, sum = 0;
+    for (double x : f) {
+        norm += x * x;
+        sum += x;
+    }
+    CHECK(std::abs(norm - 1) < 1e-9);
+    CHECK(std::abs(sum) < 1e-6);
+    options.threads = 4;
+    CHECK(fiedler_vector(g, all, options) == f);
+    CHECK((fiedler_vector(g, std::vector<int>{5}) == std::vector<double>{0}));
+
+    // Two components: the vector is constant on each, so the halves of the order are them.
+    WeightedGraph two(16);
+    for (int c = 0; c < 16; c += 8)
+        for (int a = c; a < c + 8; ++a)
+            for (int b = a + 1; b < c + 8; ++b)
+                two.add_undirected(a, b, 1);
+    all.resize(two.n);
+    std::iota(all.begin(), all.end(), 0);
+    order = spectral_order(two, all);
+    std::vector<int> half(order.begin(), order.begin() + 8);
+    std::sort(half.begin(), half.end());
+    CHECK(half.front() == 0 || half.front() == 8);
+    CHECK(half.back() - half.front() == 7);
+
+    // As the initial bisection of the recursive splits, on the clique chain of
+    // test_partitioners.
+    WeightedGraph chain = clique_chain(4, 6);
+    MultilevelKWayPartitionSolver ml(4);
+    ml.set_initial_bisection(InitialBisection::Spectral);
+    KWayPartitionSolver kway(4);
+    kway.set_initial_bisection(InitialBisection::Spectral);
+    std::vector<IGraphPartitionSolver *> solvers{&ml, &kway};
+    for (auto *s : solvers) {
+        s->solve(chain);
+        CHECK(balanced(s->result().part, 4));
+        CHECK(s->result().cut_weight == 3);
+    }
+}
+
+
+// n vertices of weight 1..3 and nets of 2..6 random pins with weights 1..5.
+Hypergraph random_hypergraph(int n, int nets, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::vector<int>> pins(nets);
+    std::vector<Weight> net_weights(nets), vertex_weights(n);
+    for (int e = 0; e < nets; ++e) {
+        int size = 2 + (int) (rng() % 5);
+        for (int i = 0; i < size; ++i)
+            pins[e].push_back((int) (rng() % n));
+        net_weights[e] = 1 + (Weight) (rng() % 5);
+    }
+    for (int v = 0; v < n; ++v)
+        vertex_weights[v] = 1 + (Weight) (rng() % 3);
+    return Hypergraph(n, pins, net_weights, vertex_weights);
+}
+
+// Block weights within [W/k, ceil(W/k)] widened by the heaviest vertex weight minus one.
+bool weight_balanced(const Hypergraph &h, const std::vector<int> &part, int k)
+{
+    std::vector<Weight> sizes(k, 0);
+    Weight heaviest = 0;
+    for (int v = 0; v < h.n; ++v) {
+        sizes[part[v]] += h.vertex_weight(v);
+        heaviest = std::max(heaviest, h.vertex_weight(v));
+    }
+    Weight total = h.total_vertex_weight();
+    for (Weight s : sizes)
+        if (s < total / k - (heaviest - 1) || s > (total + k - 1) / k + (heaviest - 1))
+            return false;
+    return true;
+}
+
+void test_hypergraph()
+{
+    // Duplicate pins are removed and single-pin nets dropped; net 0 spans blocks {0, 1} and
+    // net 2 spans {0, 1, 2}.
+    Hypergraph small(5, {{0, 1, 1}, {2, 2}, {1, 3, 4}, {2, 3}}, {4, 9, 3, 2});
+    CHECK(small.num_nets() == 3 && small.num_pins() == 7);
+    CHECK(connectivity_objective(small, {0, 1, 1, 2, 0}, 3) == 4 + 2 * 3 + 2);
+    CHECK(connectivity_objective(small, {0, 0, 0, 0, 0}, 3) == 0);
+    std::vector<std::vector<int>> one_net{{0, 1}};
+    CHECK_THROWS(Hypergraph(3, {{0, 3}}), std::out_of_range);
+    CHECK_THROWS(Hypergraph(3, one_net, {1, 1}), std::invalid_argument);
+    CHECK_THROWS(Hypergraph(3, one_net, {1}, {1, -1, 1}), std::invalid_argument);
+    CHECK_THROWS(connectivity_objective(small, {0, 1, 1, 3, 0}, 3), std::invalid_argument);
+    CHECK_THROWS(HypergraphGainCache(small, {0, 1, 1, 3, 0}, 3), std::invalid_argument);
+
+    // After every move the cached gains equal the change of the recomputed objective.
+    const int k = 4;
+    Hypergraph h = random_hypergraph(200, 300, 5);
+    std::mt19937 rng(6);
+    {
+        Hypergraph w = random_hypergraph(40, 60, 7);
+        std::vector<int> labels(w.n);
+        for (int v = 0; v < w.n; ++v)
+            labels[v] = (int) (rng() % k);
+        HypergraphGainCache cache(w, labels, k);
+        bool gains_exact = true;
+        for (int step = 0; step < 30; ++step) {
+            labels = cache.part();
+            Weight objective = connectivity_objective(w, labels, k);
+            for (int v = 0; v < w.n; ++v) {
+                int p = labels[v];
+                for (int b = 0; b < k; ++b) {
+                    if (b == p)
+                        continue;
+                    labels[v] = b;
+                    gains_exact &=
+                        cache.gain(v, b) == objective - connectivity_objective(w, labels, k);
+                    labels[v] = p;
+                }
+            }
+            int v = (int) (rng() % w.n);
+            cache.move(v, (cache.part()[v] + 1 + (int) (rng() % (k - 1))) % k);
+        }
+        CHECK(gains_exact);
+    }
+
+    // Refinement from a random labeling reaches the weight bounds, never raises the objective
+    // and stops where no single move within the bounds lowers it.
+    std::vector<int> part(h.n);
+    for (int v = 0; v < h.n; ++v)
+        part[v] = v % k;
+    std::shuffle(part.begin(), part.end(), rng);
+    Weight before = connectivity_objective(h, part, k);
+    refine_hypergraph_partition(h, part, k, 1000);
+    Weight after = connectivity_objective(h, part, k);
+    CHECK(weight_balanced(h, part, k));
+    CHECK(after <= before);
+    std::vector<Weight> sizes(k, 0);
+    Weight heaviest = 0;
+    for (int v = 0; v < h.n; ++v) {
+        sizes[part[v]] += h.vertex_weight(v);
+        heaviest = std::max(heaviest, h.vertex_weight(v));
+    }
+    Weight total = h.total_vertex_weight();
+    bool local_optimum = true;
+    for (int v = 0; v < h.n; ++v) {
+        int p = part[v];
+        Weight w = h.vertex_weight(v);
+        if (sizes[p] - w < total / k - (heaviest - 1))
+            continue;
+        for (int b = 0; b < k; ++b) {
+            if (b == p || sizes[b] + w > (total + k - 1) / k + (heaviest - 1))
+                continue;
+            part[v] = b;
+            local_optimum &= connectivity_objective(h, part, k) >= after;
+            part[v] = p;
+        }
+    }
+    CHECK(local_optimum);
+
+    // The multilevel solver reports the objective of its labeling.
+    MultilevelHypergraphSolver ml(k);
+    ml.solve(h);
+    auto r = ml.result();
+    CHECK(labels_in_range(r.part, h.n, k));
+    CHECK(weight_balanced(h, r.part, k));
+    CHECK(r.cut_weight == connectivity_objective(h, r.part, k));
+    std::ostringstream out, expected;
+    ml.print(out);
+    print_block_sizes(expected, partition_block_sizes(r.part, k, h.vertex_weights()));
+    CHECK(out.str().find(expected.str()) != std::string::npos);
+
+    // On a graph's column-net hypergraph the objective is the communication volume.
+    WeightedGraph g(300);
+    for (int i = 0; i < 900; ++i) {
+        int u = (int) (rng() % 300), v = (int) (rng() % 300);
+        if (u != v)
+            g.add_undirected(u, v);
+    }
+    CommunicationVolumeSolver volume(k);
+    volume.solve(g);
+    auto vr = volume.result();
+    auto m = compute_partition_metrics(g, vr.part, k);
+    CHECK(labels_in_range(vr.part, g.n, k));
+    CHECK(balanced(vr.part, k));
+    CHECK((long long) vr.score == m.communication_volume);
+    CHECK(vr.cut_weight == m.cut_weight);
+    CHECK(connectivity_objective(communication_hypergraph(g), vr.part, k)
+          == m.communication_volume);
+}
+
+
+void test_combine()
+{
+    // Groups p1[v] * k + p2[v] with initial p1: the child keeps p1's blocks where no edge of
+    // either parent's cut is contracted, so it is balanced and no worse than p1.
+    WeightedGraph g = grid(30, 30);
+    MultilevelKWayPartitionSolver first(4), second(4);
+    second.set_parallel({ParallelMode::Deterministic, 1, 3});
+    first.solve(g);
+    second.solve(g);
+    auto p1 = first.result().part, p2 = second.result().part;
+    CHECK(p1 != p2);
+    std::vector<int> groups(g.n);
+    for (int v = 0; v < g.n; ++v)
+        groups[v] = p1[v] * 4 + p2[v];
+    MultilevelKWayPartitionSolver child(4);
+    child.set_combine(groups, p1);
+    child.solve(g);
+    auto r = child.result();
+    CHECK(labels_in_range(r.part, g.n, 4));
+    CHECK(balanced(r.part, 4));
+    CHECK(r.cut_weight == cut_weight_undirected(g, r.part));
+    CHECK(r.cut_weight <= first.result().cut_weight);
+
+    MultilevelKWayPartitionSolver bad(4);
+    bad.set_combine({}, std::vector<int>(g.n, 4));
+    CHECK_THROWS(bad.solve(g), std::invalid_argument);
+    // p2 splits groups of p1 alone, so it does not project onto them.
+    bad.set_combine(p1, p2);
+    CHECK_THROWS(bad.solve(g), std::invalid_argument);
+}
+
+void test_evolutionary()
+{
+    WeightedGraph g = grid(24, 24);
+    EvolutionOptions options;
+    options.population = 6;
+    options.threads = 2;
+    options.time_budget = std::chrono::milliseconds(300);
+    EvolutionarySolver evo(6, options);
+    evo.solve(g);
+    auto r = evo.result();
+    CHECK(labels_in_range(r.part, g.n, 6));
+    CHECK(balanced(r.part, 6));
+    CHECK(!evo.curve().empty());
+    CHECK(evo.curve().back().cut_weight == r.cut_weight);
+    for (size_t i = 1; i < evo.curve().size(); ++i)
+        CHECK(evo.curve()[i].cut_weight < evo.curve()[i - 1].cut_weight);
+    CHECK((int) evo.population().size() == options.population);
+    CHECK(evo.population().front().cut_weight == r.cut_weight);
+    CHECK_THROWS(EvolutionarySolver(2, EvolutionOptions{0}), std::invalid_argument);
+}
+
+void test_process_mapping()
+{
+    MachineTopology topo({2, 2, 2}, {1, 10, 100});
+    CHECK(topo.num_pes() == 8);
+    CHECK(topo.distance(3, 3) == 0);
+    CHECK(topo.distance(0, 1) == 1);
+    CHECK(topo.distance(0, 2) == 10);
+    CHECK(topo.distance(1, 6) == 100);
+    CHECK_THROWS(MachineTopology({2, 2}, {10, 1}), std::invalid_argument);
+    CHECK_THROWS(MachineTopology({2}, {1, 2}), std::invalid_argument);
+
+    WeightedGraph g = grid(32, 32);
+    ProcessMappingSolver mapped(topo);
+    mapped.solve(g);
+    auto r = mapped.result();
+    CHECK(labels_in_range(r.part, g.n, 8));
+    CHECK(balanced(r.part, 8));
+    CHECK(r.cut_weight == cut_weight_undirected(g, r.part));
+    CHECK((Weight) r.score == mapping_cost(g, r.part, topo));
+    auto pes = mapped.block_to_pe();
+    std::sort(pes.begin(), pes.end());
+    CHECK(pes == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7}));
+
+    // Swap passes never make the greedy mapping worse; both beat a scattered placement.
+    MultilevelKWayPartitionSolver ml(8);
+    ml.solve(g);
+    WeightedGraph q = quotient_graph(g, ml.result().part, 8);
+    auto cost = [&](const std::vector<int> &pe) {
+        std::vector<int> part = ml.result().part;
+        for (int &p : part)
+            p = pe[p];
+        return mapping_cost(g, part, topo);
+    };
+    Weight greedy = cost(map_blocks(q, topo, 0));
+    Weight swapped = cost(map_blocks(q, topo));
+    CHECK(swapped <= greedy);
+    std::vector<int> scattered{0, 7, 2, 5, 4, 3, 6, 1};
+    CHECK(swapped <= cost(scattered));
+}
+
+} // namespace
+
+int main()
+{
+    test_partitioners();
+    test_graph_types();
+    test_distributed();
+    test_kernels();
+    test_metrics();
+    test_reordering();
+    test_separators();
+    test_max_flow();
+    test_parallel_max_flow();
+    test_flow_refinement();
+    test_exact_cuts();
+    test_fixed_vertices();
+    test_vertex_weights();
+    test_deterministic();
+    test_spectral();
+    test_hypergraph();
+    test_combine();
+    test_evolutionary();
+    test_process_mapping();
+    test_solve_control();
+    test_partition_cache();
+    test_compressed_graph();
+    test_external_memory();
+    return test::finish("SolverTests");
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdio>
+
+// Minimal checks for the test programs in this directory: CHECK records a failure and keeps
+// going, CHECK_THROWS expects an exception of the given type, and test::finish() prints the
+// summary and returns the exit status for main().
+namespace test {
+
+inline int failures = 0;
+inline int checks = 0;
+
+inline void check(bool ok, const char *expr, const char *file, int line)
+{
+    checks++;
+    if (!ok) {
+        failures++;
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+    }
+}
+
+inline int finish(const char *suite)
+{
+    std::printf("%s: %d checks, %d failed\n", suite, checks, failures);
+    return failures == 0 ? 0 : 1;
+}
+
+} // namespace test
+
+#define CHECK(expr) test::check((expr), #expr, __FILE__, __LINE__)
+
+#define CHECK_THROWS(expr, type)                                                                   \
+    do {                                                                                           \
+        bool thrown_ = false;                                                                      \
+        try {                                                                                      \
+            (void) (expr);                                                                         \
+        } catch (const type &) {                                                                   \
+            thrown_ = true;                                                                        \
+        }                                                                                          \
+        test::check(thrown_, #expr " throws " #type, __FILE__, __LINE__);                          \
+    } while (0)
@@ -0,0 +1,529 @@
+// Command-line driver: loads a graph file, runs one solver and prints a JSON report (load and
+// solve time, peak memory, partition metrics) to stdout. Optionally writes the partition, one
+// block per line. Diagnostics go to stderr; the exit status is 0 on success, 1 if reading or
+// solving fails and 2 for invalid arguments.
+//
+//   gpart <graph> [options]        (gpart --help lists the options)
+#include "../DistributedMultilevelSolver.h"
+#include "../EvolutionarySolver.h"
+#include "../ExternalMultilevelSolver.h"
+#include "../GlobalMinCutSolver.h"
+#include "../GraphFile.h"
+#include "../GraphIO.h"
+#include "../HypergraphPartitionSolver.h"
+#include "../KWayPartitionSolver.h"
+#include "../MinimumBisectionSolver.h"
+#include "../MultilevelKWayPartitionSolver.h"
+#include "../MultiwayCutSolver.h"
+#include "../NestedDissectionSolver.h"
+#include "../PartitionMetrics.h"
+#include "../ProcessMapping.h"
+#include "../STMinCutSolver.h"
+#include "../VertexSeparatorSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+const char *usage_text =
+    "usage: gpart <graph> [options]\n"
+    "\n"
+    "input and output:\n"
+    "  --format F           auto (default), metis, edges or binary\n"
+    "  --output FILE        write the partition, one block per line\n"
+    "\n"
+    "solver selection:\n"
+    "  --solver S           multilevel (default), kway, bisection, evolutionary, volume,\n"
+    "                       mapping, external, distributed, separator, nested-dissection,\n"
+    "                       global-mincut, st-mincut, multiway\n"
+    "  -k, --k K            number of blocks (default 2)\n"
+    "  --passes N           bisection passes (solver default if omitted)\n"
+    "  --refine-passes N    refinement passes per level\n"
+    "  --levels N           maximum coarsening levels\n"
+    "  --seed S             seed of the randomized choices (default 1): evolutionary, and\n"
+    "                       multilevel or kway with --spectral or --parallel deterministic\n"
+    "  --threads T          worker threads, <= 0 for all cores (default 1)\n"
+    "  --time-limit SEC     stop early and keep the best partition so far; the search budget\n"
+    "                       of the evolutionary solver (default 1 s there)\n"
+    "\n"
+    "solver-specific:\n"
+    "  --parallel M         multilevel: sequential (default), deterministic or fast\n"
+    "  --spectral           multilevel, kway: spectral initial bisection\n"
+    "  --population N       evolutionary: population size (default 16)\n"
+    "  --topology L:L:..    mapping: PEs per group, innermost level first (e.g. 8:2:16)\n"
+    "  --distances D:D:..   mapping: cost per level (e.g. 1:10:100)\n"
+    "  --memory-mb M        external: memory budget (default 256)\n"
+    "  --work-dir DIR       external: directory for temporary files (default .)\n"
+    "  --source S --sink T  st-mincut: terminal vertices\n"
+    "  --terminals SETS     multiway: terminal sets, e.g. \"0,1;5;9\"\n";
+
+struct Options
+{
+    std::string graph;
+    std::string format = "auto";
+    std::string output;
+    std::string solver = "multilevel";
+    int k = 2;
+    int passes = -1;
+    int refine_passes = -1;
+    int levels = -1;
+    std::uint64_t seed = 1;
+    bool seed_given = false;
+    int threads = 1;
+    double time_limit = 0;
+    std::string parallel = "sequential";
+    bool spectral = false;
+    int population = 16;
+    std::string topology;
+    std::string distances;
+    long long memory_mb = 256;
+    std::string work_dir = ".";
+    int source = -1;
+    int sink = -1;
+    std::string terminals;
+};
+
+// Invalid command line; reported with exit status 2.
+struct UsageError : std::invalid_argument
+{
+    using std::invalid_argument::invalid_argument;
+};
+
+long long parse_integer(const std::string &option, const std::string &value)
+{
+    std::size_t used = 0;
+    long long result = 0;
+    try {
+        result = std::stoll(value, &used);
+    } catch (const std::exception &) {
+        used = 0;
+    }
+    if (used == 0 || used != value.size())
+        throw UsageError("bad value for " + option + ": " + value);
+    return result;
+}
+
+double parse_double(const std::string &option, const std::string &value)
+{
+    std::size_t used = 0;
+    double result = 0;
+    try {
+        result = std::stod(value, &used);
+    } catch (const std::exception &) {
+        used = 0;
+    }
+    if (used == 0 || used != value.size())
+        throw UsageError("bad value for " + option + ": " + value);
+    return result;
+}
+
+// "a<sep>b<sep>c" as integers.
+std::vector<long long> parse_list(const std::string &option, const std::string &value, char sep)
+{
+    std::vector<long long> out;
+    std::stringstream in(value);
+    std::string item;
+    while (std::getline(in, item, sep))
+        out.push_back(parse_integer(option, item));
+    if (out.empty())
+        throw UsageError("empty list for " + option);
+    return out;
+}
+
+Options parse_options(int argc, char **argv)
+{
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc)
+                throw UsageError("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--format")
+            o.format = value();
+        else if (arg == "--output" || arg == "-o")
+            o.output = value();
+        else if (arg == "--solver")
+            o.solver = value();
+        else if (arg == "--k" || arg == "-k")
+            o.k = (int) parse_integer(arg, value());
+        else if (arg == "--passes")
+            o.passes = (int) parse_integer(arg, value());
+        else if (arg == "--refine-passes")
+            o.refine_passes = (int) parse_integer(arg, value());
+        else if (arg == "--levels")
+            o.levels = (int) parse_integer(arg, value());
+        else if (arg == "--seed") {
+            o.seed = (std::uint64_t) parse_integer(arg, value());
+            o.seed_given = true;
+        }
+        else if (arg == "--threads")
+            o.threads = (int) parse_integer(arg, value());
+        else if (arg == "--time-limit")
+            o.time_limit = parse_double(arg, value());
+        else if (arg == "--parallel")
+            o.parallel = value();
+        else if (arg == "--spectral")
+            o.spectral = true;
+        else if (arg == "--population")
+            o.population = (int) parse_integer(arg, value());
+        else if (arg == "--topology")
+            o.topology = value();
+        else if (arg == "--distances")
+            o.distances = value();
+        else if (arg == "--memory-mb")
+            o.memory_mb = parse_integer(arg, value());
+        else if (arg == "--work-dir")
+            o.work_dir = value();
+        else if (arg == "--source")
+            o.source = (int) parse_integer(arg, value());
+        else if (arg == "--sink")
+            o.sink = (int) parse_integer(arg, value());
+        else if (arg == "--terminals")
+            o.terminals = value();
+        else if (!arg.empty() && arg[0] == '-')
+            throw UsageError("unknown option " + arg);
+        else if (o.graph.empty())
+            o.graph = arg;
+        else
+            throw UsageError("more than one graph given");
+    }
+    if (o.graph.empty())
+        throw UsageError("no graph given");
+    if (o.k < 1)
+        throw UsageError("k must be at least 1");
+    if (o.time_limit < 0)
+        throw UsageError("time limit must be nonnegative");
+    return o;
+}
+
+int or_default(int value, int fallback)
+{
+    return value >= 0 ? value : fallback;
+}
+
+ParallelMode parse_parallel_mode(const std::string &name)
+{
+    if (name == "sequential")
+        return ParallelMode::Sequential;
+    if (name == "deterministic")
+        return ParallelMode::Deterministic;
+    if (name == "fast")
+        return ParallelMode::Fast;
+    throw UsageError("unknown parallel mode " + name);
+}
+
+MachineTopology parse_topology(const Options &o)
+{
+    if (o.topology.empty() || o.distances.empty())
+        throw UsageError("the mapping solver needs --topology and --distances");
+    std::vector<int> levels;
+    for (long long l : parse_list("--topology", o.topology, ':'))
+        levels.push_back((int) l);
+    std::vector<Weight> distances;
+    for (long long d : parse_list("--distances", o.distances, ':'))
+        distances.push_back(d);
+    try {
+        return MachineTopology(levels, distances);
+    } catch (const std::invalid_argument &e) {
+        throw UsageError(e.what());
+    }
+}
+
+std::vector<std::vector<int>> parse_terminals(const Options &o)
+{
+    if (o.terminals.empty())
+        throw UsageError("the multiway solver needs --terminals");
+    std::vector<std::vector<int>> sets;
+    std::stringstream in(o.terminals);
+    std::string set;
+    while (std::getline(in, set, ';')) {
+        sets.emplace_back();
+        for (long long v : parse_list("--terminals", set, ','))
+            sets.back().push_back((int) v);
+    }
+    return sets;
+}
+
+// Whether the chosen solver and mode draw on the seed; the others are deterministic.
+bool uses_seed(const Options &o)
+{
+    if (o.solver == "evolutionary")
+        return true;
+    if (o.solver == "multilevel")
+        return o.spectral || o.parallel == "deterministic";
+    return o.solver == "kway" && o.spectral;
+}
+
+// Whether the chosen solver takes vertex weights into account. The cut solvers have no balance
+// constraint, so vertex weights do not affect their result.
+bool uses_vertex_weights(const Options &o)
+{
+    return o.solver == "multilevel" || o.solver == "global-mincut" || o.solver == "st-mincut"
+           || o.solver == "multiway";
+}
+
+std::unique_ptr<IGraphPartitionSolver> make_solver(const Options &o, const GraphInput &input)
+{
+    const std::string &s = o.solver;
+    SpectralOptions spectral;
+    spectral.threads = o.threads;
+    spectral.seed = o.seed;
+    InitialBisection initial = o.spectral ? InitialBisection::Spectral
+                                          : InitialBisection::DegreeOrder;
+    int passes = or_default(o.passes, 8), refine = or_default(o.refine_passes, 4);
+    if (s == "multilevel") {
+        auto ml = std::make_unique<MultilevelKWayPartitionSolver>(o.k,
+                                                                  passes,
+                                                                  refine,
+                                                                  or_default(o.levels, 10),
+                                                                  std::vector<int>{},
+                                                                  input.vertex_weights);
+        ml->set_parallel({parse_parallel_mode(o.parallel), o.threads, o.seed});
+        ml->set_initial_bisection(initial, spectral);
+        return ml;
+    }
+    if (s == "kway") {
+        auto kway = std::make_unique<KWayPartitionSolver>(o.k, or_default(o.passes, 15));
+        kway->set_initial_bisection(initial, spectral);
+        return kway;
+    }
+    if (s == "bisection")
+        return std::make_unique<MinimumBisectionSolver>(or_default(o.passes, 20));
+    if (s == "evolutionary") {
+        EvolutionOptions options;
+        options.population = o.population;
+        options.threads = o.threads;
+        options.seed = o.seed;
+        options.time_budget = std::chrono::milliseconds(
+            o.time_limit > 0 ? (long long) (o.time_limit * 1000) : 1000);
+        options.bisection_passes = passes;
+        options.refine_passes = refine;
+        options.max_levels = or_default(o.levels, 10);
+        return std::make_unique<EvolutionarySolver>(o.k, options);
+    }
+    if (s == "volume")
+        return std::make_unique<CommunicationVolumeSolver>(
+            o.k, passes, refine, or_default(o.levels, 20));
+    if (s == "mapping")
+        return std::make_unique<ProcessMappingSolver>(
+            parse_topology(o), passes, refine, or_default(o.levels, 10));
+    if (s == "external") {
+        ExternalMemoryConfig config;
+        config.work_dir = o.work_dir;
+        config.memory_budget = (std::size_t) std::max(1LL, o.memory_mb) << 20;
+        return std::make_unique<ExternalMultilevelSolver>(
+            o.k, config, passes, refine, or_default(o.levels, 10));
+    }
+    if (s == "distributed")
+        return std::make_unique<DistributedMultilevelSolver>(o.k,
+                                                             resolve_threads(o.threads),
+                                                             TransportBackend::InProcess,
+                                                             passes,
+                                                             refine,
+                                                             or_default(o.levels, 10));
+    if (s == "separator")
+        return std::make_unique<VertexSeparatorSolver>(or_default(o.passes, 15));
+    if (s == "nested-dissection")
+        return std::make_unique<NestedDissectionSolver>(64, o.threads, refine);
+    if (s == "global-mincut")
+        return std::make_unique<GlobalMinCutSolver>();
+    if (s == "st-mincut") {
+        if (o.source < 0 || o.sink < 0)
+            throw UsageError("the st-mincut solver needs --source and --sink");
+        return std::make_unique<STMinCutSolver>(o.source, o.sink, o.threads);
+    }
+    if (s == "multiway")
+        return std::make_unique<MultiwayCutSolver>(parse_terminals(o), o.threads);
+    throw UsageError("unknown solver " + s);
+}
+
+// Peak resident set size of this process, or -1 where the platform does not report it.
+long long peak_memory_bytes()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#if defined(__APPLE__)
+    return (long long) usage.ru_maxrss;
+#else
+    return (long long) usage.ru_maxrss * 1024;
+#endif
+#else
+    return -1;
+#endif
+}
+
+std::string json_string(const std::string &s)
+{
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if ((unsigned char) c < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", (unsigned) c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+// Integral values are printed as integers, so that large scores keep every digit; values JSON
+// cannot represent become null.
+std::string json_number(double value)
+{
+    if (!std::isfinite(value))
+        return "null";
+    if (value == std::floor(value) && std::fabs(value) < 9007199254740992.0)
+        return std::to_string((long long) value);
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", value);
+    return buf;
+}
+
+template<typename T>
+std::string json_array(const std::vector<T> &values)
+{
+    std::string out = "[";
+    for (size_t i = 0; i < values.size(); ++i)
+        out += (i ? "," : "") + std::to_string(values[i]);
+    return out + "]";
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int run(const Options &o)
+{
+    GraphFormat format = GraphFormat::Auto;
+    try {
+        format = parse_graph_format(o.format);
+    } catch (const std::invalid_argument &e) {
+        throw UsageError(e.what());
+    }
+    if (format == GraphFormat::Auto)
+        format = detect_graph_format(o.graph);
+    // The external solver streams binary graph files instead of loading them; metrics then
+    // stay null since they need the graph in memory.
+    bool streamed = o.solver == "external" && format == GraphFormat::Binary;
+
+    auto start = std::chrono::steady_clock::now();
+    GraphInput input;
+    long long n = 0, edges = 0;
+    if (streamed) {
+        GraphFile file(o.graph);
+        n = file.n;
+        edges = file.arc_count() / 2;
+    } else {
+        input = read_graph(o.graph, format);
+        n = input.graph.n;
+        for (const auto &row : input.graph.adj)
+            edges += (long long) row.size();
+        edges /= 2;
+    }
+    double load_seconds = seconds_since(start);
+
+    auto solver = make_solver(o, input);
+    if (o.seed_given && !uses_seed(o))
+        throw UsageError("the " + o.solver + " solver does not use --seed in this mode");
+    if (!input.vertex_weights.empty() && !uses_vertex_weights(o))
+        throw UsageError("the " + o.solver + " solver cannot balance the vertex weights of "
+                         + o.graph);
+    SolveControl control;
+    // The evolutionary solver spends its time limit as the search budget instead.
+    if (o.time_limit > 0 && o.solver != "evolutionary")
+        control.set_time_limit(std::chrono::nanoseconds((long long) (o.time_limit * 1e9)));
+    solver->set_control(&control);
+    start = std::chrono::steady_clock::now();
+    if (streamed)
+        static_cast<ExternalMultilevelSolver &>(*solver).solve_file(o.graph);
+    else
+        solver->solve(input.graph);
+    double solve_seconds = seconds_since(start);
+    PartitionResult result = solver->result();
+
+    if (!o.output.empty())
+        write_partition(o.output, result.part);
+
+    std::ostringstream json;
+    json.precision(6);
+    json << "{\n";
+    json << "  \"graph\": {\"path\": " << json_string(o.graph)
+         << ", \"format\": " << json_string(graph_format_name(format)) << ", \"vertices\": " << n
+         << ", \"edges\": " << edges << "},\n";
+    json << "  \"solver\": " << json_string(o.solver) << ",\n";
+    json << "  \"solver_name\": " << json_string(solver->name()) << ",\n";
+    // Blocks in the result, which differ from --k for the mapping solver (one per PE) and
+    // when there are fewer vertices than blocks.
+    int blocks = result.part.empty()
+                     ? 0
+                     : *std::max_element(result.part.begin(), result.part.end()) + 1;
+    json << "  \"k\": " << blocks << ",\n";
+    json << "  \"threads\": " << o.threads << ",\n";
+    json << "  \"seed\": " << (uses_seed(o) ? std::to_string(o.seed) : "null") << ",\n";
+    json << "  \"time_limit\": " << o.time_limit << ",\n";
+    json << "  \"load_seconds\": " << load_seconds << ",\n";
+    json << "  \"solve_seconds\": " << solve_seconds << ",\n";
+    json << "  \"peak_memory_bytes\": " << peak_memory_bytes() << ",\n";
+    json << "  \"stopped_early\": " << (result.stopped_early ? "true" : "false") << ",\n";
+    json << "  \"cut_weight\": " << result.cut_weight << ",\n";
+    json << "  \"score\": " << json_number(result.score) << ",\n";
+    json << "  \"separator_size\": " << result.separator.size() << ",\n";
+    if (streamed || result.part.empty() || (int) result.part.size() != n) {
+        json << "  \"metrics\": null\n";
+    } else {
+        PartitionMetrics m =
+            compute_partition_metrics(input.graph, result.part, 0, o.threads, input.vertex_weights);
+        json << "  \"metrics\": {\n";
+        json << "    \"blocks\": " << m.k << ",\n";
+        json << "    \"cut_weight\": " << m.cut_weight << ",\n";
+        json << "    \"cut_edges\": " << m.cut_edges << ",\n";
+        json << "    \"imbalance\": " << m.imbalance << ",\n";
+        json << "    \"block_sizes\": " << json_array(m.block_sizes) << ",\n";
+        json << "    \"boundary_vertices\": " << m.boundary_vertices << ",\n";
+        json << "    \"communication_volume\": " << m.communication_volume << ",\n";
+        json << "    \"max_communication_volume\": " << m.max_communication_volume << ",\n";
+        json << "    \"quotient_edges\": " << m.quotient_edges << ",\n";
+        json << "    \"max_quotient_degree\": " << m.max_quotient_degree << "\n";
+        json << "  }\n";
+    }
+    json << "}\n";
+    std::fputs(json.str().c_str(), stdout);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; ++i)
+        if (std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h") {
+            std::fputs(usage_text, stdout);
+            return 0;
+        }
+    try {
+        return run(parse_options(argc, argv));
+    } catch (const UsageError &e) {
+        std::fprintf(stderr, "gpart: %s\n\n%s", e.what(), usage_text);
+        return 2;
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "gpart: %s\n", e.what());
+        return 1;
+    }
+}